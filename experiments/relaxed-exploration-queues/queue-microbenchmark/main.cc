@@ -0,0 +1,106 @@
+#include "priority_queue.h"
+
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+void benchmark(const string &desc, int num_calls,
+               const function<void()> &func) {
+    cout << "Running " << desc << " " << num_calls << " times:" << flush;
+    clock_t start = clock();
+    for (int i = 0; i < num_calls; ++i)
+        func();
+    clock_t end = clock();
+    double duration = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+    cout << " " << duration << " seconds" << endl;
+}
+
+
+/*
+  Mimic a relaxed exploration: pop an entry and push successors whose
+  keys are the popped key plus an increment. For h^max-style
+  explorations, the increment is an operator cost in [0, max_cost].
+  For h^add-style explorations, we add the cost of another
+  precondition, so increments can be much larger than max_cost.
+*/
+template<typename Queue>
+int explore(Queue &queue, int num_nodes, int branching, int max_cost,
+            bool additive) {
+    queue.clear();
+    vector<int> distances(num_nodes, -1);
+    queue.push(0, 0);
+    distances[0] = 0;
+    unsigned int seed = 2016;
+    int checksum = 0;
+    while (!queue.empty()) {
+        pair<int, int> top = queue.pop();
+        int key = top.first;
+        int node = top.second;
+        if (distances[node] < key)
+            continue;
+        checksum += key;
+        for (int i = 0; i < branching; ++i) {
+            seed = seed * 1103515245 + 12345;
+            int succ = (seed >> 8) % num_nodes;
+            int cost = (seed >> 4) % (max_cost + 1);
+            if (additive)
+                cost += distances[(seed >> 12) % num_nodes] > 0 ? key / 2 : 0;
+            int succ_key = key + cost;
+            if (distances[succ] == -1 || distances[succ] > succ_key) {
+                distances[succ] = succ_key;
+                queue.push(succ_key, succ);
+            }
+        }
+    }
+    return checksum;
+}
+
+
+template<typename Queue>
+void run_explorations(const string &desc, Queue &queue, int max_cost,
+                      bool additive) {
+    const int NUM_ITERATIONS = 200;
+    const int NUM_NODES = 20000;
+    const int BRANCHING = 4;
+    int checksum = 0;
+    benchmark(desc, NUM_ITERATIONS, [&]() {
+                  checksum += explore(queue, NUM_NODES, BRANCHING,
+                                      max_cost, additive);
+              });
+    cout << "  checksum: " << checksum << endl;
+}
+
+
+int main(int, char **) {
+    for (int max_cost : {1, 10, 100}) {
+        cout << "h^max-style explorations with maximal cost " << max_cost
+             << ":" << endl;
+        AdaptiveQueue<int> adaptive_queue;
+        run_explorations("AdaptiveQueue", adaptive_queue, max_cost, false);
+        HeapQueue<int> heap_queue;
+        run_explorations("HeapQueue", heap_queue, max_cost, false);
+        DialQueue<int> dial_queue(max_cost);
+        run_explorations("DialQueue", dial_queue, max_cost, false);
+        RadixQueue<int> radix_queue;
+        run_explorations("RadixQueue", radix_queue, max_cost, false);
+        cout << endl;
+    }
+
+    for (int max_cost : {1, 10, 100}) {
+        cout << "h^add-style explorations with maximal cost " << max_cost
+             << ":" << endl;
+        AdaptiveQueue<int> adaptive_queue;
+        run_explorations("AdaptiveQueue", adaptive_queue, max_cost, true);
+        HeapQueue<int> heap_queue;
+        run_explorations("HeapQueue", heap_queue, max_cost, true);
+        RadixQueue<int> radix_queue;
+        run_explorations("RadixQueue", radix_queue, max_cost, true);
+        cout << endl;
+    }
+    return 0;
+}
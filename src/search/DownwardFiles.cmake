@@ -67,8 +67,10 @@ fast_downward_plugin(
         operator_cost.cc
         option_parser.h
         option_parser_util.h
+        per_state_bitset.cc
         per_state_information.cc
         plugin.h
+        preferred_operator_cache.cc
         pruning_method.cc
         priority_queue.cc
         sampling.cc
@@ -137,8 +139,10 @@ fast_downward_plugin(
         utils/language.h
         utils/logging.cc
         utils/markup.cc
+        utils/mapped_file.cc
         utils/math.cc
         utils/memory.cc
+        utils/parallel.cc
         utils/rng.cc
         utils/rng_options.cc
         utils/system.cc
@@ -533,6 +537,7 @@ fast_downward_plugin(
         landmarks/landmark_factory_rpg_sasp.cc
         landmarks/landmark_factory_zhu_givan.cc
         landmarks/landmark_graph.cc
+        landmarks/landmark_graph_cache.cc
         landmarks/landmark_status_manager.cc
         landmarks/util.cc
     DEPENDS LP_SOLVER
@@ -561,6 +566,7 @@ fast_downward_plugin(
         pdbs/match_tree.cc
         pdbs/max_additive_pdb_sets.cc
         pdbs/max_cliques.cc
+        pdbs/packed_distances.cc
         pdbs/pattern_collection_information.cc
         pdbs/pattern_database.cc
         pdbs/pattern_collection_generator_combo.cc
@@ -571,6 +577,8 @@ fast_downward_plugin(
         pdbs/pattern_generator_greedy.cc
         pdbs/pattern_generator_manual.cc
         pdbs/pattern_generator.cc
+        pdbs/pdb_cache.cc
+        pdbs/pdb_construction.cc
         pdbs/pdb_heuristic.cc
         pdbs/types.h
         pdbs/validation.cc
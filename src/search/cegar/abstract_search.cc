@@ -1,122 +1,211 @@
 #include "abstract_search.h"
 
-#include "abstract_state.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
 
 namespace cegar {
-AbstractSearch::AbstractSearch(
-    vector<int> &&operator_costs,
-    AbstractStates &states)
-    : operator_costs(move(operator_costs)),
-      states(states) {
+static const Transition UNDEFINED_TRANSITION(UNDEFINED_VALUE, UNDEFINED_VALUE);
+
+static int add_costs(int cost1, int cost2) {
+    assert(cost1 >= 0 && cost2 >= 0);
+    if (cost1 == INF || cost2 == INF)
+        return INF;
+    return cost1 + cost2;
 }
 
-void AbstractSearch::reset() {
-    open_queue.clear();
-    for (AbstractState *state : states) {
-        state->get_search_info().reset();
-    }
-    solution.clear();
+AbstractSearch::AbstractSearch(vector<int> &&operator_costs)
+    : operator_costs(move(operator_costs)) {
+}
+
+int AbstractSearch::get_cost(int op_id) const {
+    assert(utils::in_bounds(op_id, operator_costs));
+    const int op_cost = operator_costs[op_id];
+    assert(op_cost >= 0);
+    return op_cost;
 }
 
-bool AbstractSearch::find_solution(AbstractState *init, AbstractStates &goals) {
-    reset();
-    init->get_search_info().decrease_g_value_to(0);
-    open_queue.push(init->get_h_value(), init);
-    AbstractState *goal = astar_search(true, true, &goals);
-    bool has_found_solution = static_cast<bool>(goal);
-    if (has_found_solution) {
-        extract_solution(init, goal);
+void AbstractSearch::compute_goal_distances(
+    const vector<Transitions> &incoming_transitions, const Goals &goal_ids) {
+    int num_states = incoming_transitions.size();
+    goal_distances.assign(num_states, INF);
+    shortest_path.assign(num_states, UNDEFINED_TRANSITION);
+    dirty.assign(num_states, true);
+    open_queue.clear();
+    for (int goal_id : goal_ids) {
+        goal_distances[goal_id] = 0;
+        open_queue.push(0, goal_id);
     }
-    return has_found_solution;
+    propagate_goal_distances(incoming_transitions);
+    dirty.assign(num_states, false);
 }
 
-void AbstractSearch::forward_dijkstra(AbstractState *init) {
-    reset();
-    init->get_search_info().decrease_g_value_to(0);
-    open_queue.push(0, init);
-    astar_search(true, false);
+void AbstractSearch::propagate_goal_distances(
+    const vector<Transitions> &incoming_transitions) {
+    while (!open_queue.empty()) {
+        pair<int, int> top_pair = open_queue.pop();
+        int distance = top_pair.first;
+        int state_id = top_pair.second;
+        assert(distance < INF);
+        if (distance > goal_distances[state_id])
+            continue;
+        for (const Transition &transition : incoming_transitions[state_id]) {
+            int op_id = transition.op_id;
+            int pred_id = transition.target_id;
+            if (!dirty[pred_id])
+                continue;
+            int pred_distance = add_costs(get_cost(op_id), distance);
+            if (pred_distance < goal_distances[pred_id]) {
+                goal_distances[pred_id] = pred_distance;
+                shortest_path[pred_id] = Transition(op_id, state_id);
+                open_queue.push(pred_distance, pred_id);
+            }
+        }
+    }
 }
 
-void AbstractSearch::backwards_dijkstra(const AbstractStates goals) {
-    reset();
-    for (AbstractState *goal : goals) {
-        goal->get_search_info().decrease_g_value_to(0);
-        open_queue.push(0, goal);
+void AbstractSearch::add_orphans(
+    const vector<Transitions> &incoming_transitions,
+    int state_id, int old_state_id) {
+    /* Add all states whose shortest path starts with a transition to
+       state_id. For the children of a split state, the shortest paths
+       still lead to the ID of the split state. */
+    for (const Transition &transition : incoming_transitions[state_id]) {
+        int pred_id = transition.target_id;
+        if (!dirty[pred_id] &&
+            shortest_path[pred_id] == Transition(transition.op_id, old_state_id)) {
+            dirty[pred_id] = true;
+            orphans.push_back(pred_id);
+        }
     }
-    astar_search(false, false);
 }
 
-AbstractState *AbstractSearch::astar_search(
-    bool forward, bool use_h, AbstractStates *goals) {
-    assert((forward && use_h && goals) ||
-           (!forward && !use_h && !goals) ||
-           (forward && !use_h && !goals));
-    while (!open_queue.empty()) {
-        pair<int, AbstractState *> top_pair = open_queue.pop();
-        int old_f = top_pair.first;
-        AbstractState *state = top_pair.second;
+void AbstractSearch::update_goal_distances(
+    const vector<Transitions> &incoming_transitions,
+    const vector<Transitions> &outgoing_transitions,
+    const Goals &goal_ids, int v_id, int v2_id) {
+    int v1_id = v_id;
+    assert(v2_id == static_cast<int>(goal_distances.size()));
+    assert(incoming_transitions.size() == goal_distances.size() + 1);
+    assert(goal_ids.count(v1_id) == 0);
+    goal_distances.push_back(goal_distances[v_id]);
+    shortest_path.push_back(UNDEFINED_TRANSITION);
+    dirty.push_back(false);
 
-        const int g = state->get_search_info().get_g_value();
-        assert(0 <= g && g < INF);
-        int new_f = g;
-        if (use_h)
-            new_f += state->get_h_value();
-        assert(new_f <= old_f);
-        if (new_f < old_f)
+    // Collect v1, v2 and all states whose shortest path leads through v.
+    assert(orphans.empty());
+    dirty[v1_id] = true;
+    if (goal_ids.count(v2_id) == 0) {
+        dirty[v2_id] = true;
+    } else {
+        assert(goal_distances[v2_id] == 0);
+    }
+    add_orphans(incoming_transitions, v1_id, v_id);
+    add_orphans(incoming_transitions, v2_id, v_id);
+    for (size_t i = 0; i < orphans.size(); ++i) {
+        add_orphans(incoming_transitions, orphans[i], orphans[i]);
+    }
+    orphans.push_back(v1_id);
+    if (dirty[v2_id])
+        orphans.push_back(v2_id);
+
+    /*
+      Goal distances only increase, so an orphan can keep its distance if
+      it has a transition to a non-orphan state on a path of the same
+      length. Reconnected states are valid targets for the remaining
+      orphans, which is why we handle states closer to the goal first.
+    */
+    sort(orphans.begin(), orphans.end(), [&](int state1, int state2) {
+             return goal_distances[state1] < goal_distances[state2];
+         });
+    for (int state_id : orphans) {
+        int old_distance = goal_distances[state_id];
+        if (old_distance == INF)
             continue;
-        if (goals && goals->count(state) == 1) {
-            return state;
+        for (const Transition &transition : outgoing_transitions[state_id]) {
+            int succ_id = transition.target_id;
+            if (!dirty[succ_id] &&
+                add_costs(get_cost(transition.op_id),
+                          goal_distances[succ_id]) == old_distance) {
+                shortest_path[state_id] = transition;
+                dirty[state_id] = false;
+                break;
+            }
         }
-        const Transitions &transitions = forward ?
-                                         state->get_outgoing_transitions() :
-                                         state->get_incoming_transitions();
-        for (const Transition &transition : transitions) {
-            int op_id = transition.op_id;
-            AbstractState *successor = transition.target;
-
-            assert(utils::in_bounds(op_id, operator_costs));
-            const int op_cost = operator_costs[op_id];
-            assert(op_cost >= 0);
-            int succ_g = (op_cost == INF) ? INF : g + op_cost;
-            assert(succ_g >= 0);
-
-            if (succ_g < successor->get_search_info().get_g_value()) {
-                successor->get_search_info().decrease_g_value_to(succ_g);
-                int f = succ_g;
-                if (use_h) {
-                    int h = successor->get_h_value();
-                    if (h == INF)
-                        continue;
-                    f += h;
-                }
-                assert(f >= 0);
-                open_queue.push(f, successor);
-                successor->get_search_info().set_incoming_transition(
-                    Transition(op_id, state));
+    }
+
+    // Compute the goal distances of the remaining orphans from scratch.
+    open_queue.clear();
+    for (int state_id : orphans) {
+        if (!dirty[state_id])
+            continue;
+        int best_distance = INF;
+        Transition best_transition = UNDEFINED_TRANSITION;
+        for (const Transition &transition : outgoing_transitions[state_id]) {
+            int succ_id = transition.target_id;
+            if (dirty[succ_id])
+                continue;
+            int distance = add_costs(get_cost(transition.op_id),
+                                     goal_distances[succ_id]);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_transition = transition;
             }
         }
+        goal_distances[state_id] = best_distance;
+        shortest_path[state_id] = best_transition;
+        if (best_distance != INF)
+            open_queue.push(best_distance, state_id);
+    }
+    propagate_goal_distances(incoming_transitions);
+
+    for (int state_id : orphans) {
+        dirty[state_id] = false;
+    }
+    orphans.clear();
+}
+
+bool AbstractSearch::find_solution(int init_id, const Goals &goal_ids) {
+    solution.clear();
+    if (goal_distances[init_id] == INF)
+        return false;
+    int current_id = init_id;
+    while (goal_ids.count(current_id) == 0) {
+        const Transition &transition = shortest_path[current_id];
+        assert(transition.op_id != UNDEFINED_VALUE);
+        assert(goal_distances[current_id] ==
+               add_costs(get_cost(transition.op_id),
+                         goal_distances[transition.target_id]));
+        solution.push_back(transition);
+        current_id = transition.target_id;
     }
-    return nullptr;
+    return true;
 }
 
-void AbstractSearch::extract_solution(
-    AbstractState *init, AbstractState *goal) {
-    AbstractState *current = goal;
-    while (current != init) {
-        const Transition &prev =
-            current->get_search_info().get_incoming_transition();
-        solution.emplace_front(prev.op_id, current);
-        assert(utils::in_bounds(prev.op_id, operator_costs));
-        const int prev_op_cost = operator_costs[prev.op_id];
-        assert(prev_op_cost != INF);
-        prev.target->set_h_value(current->get_h_value() + prev_op_cost);
-        assert(prev.target != current);
-        current = prev.target;
+void AbstractSearch::forward_dijkstra(
+    const vector<Transitions> &outgoing_transitions, int init_id) {
+    g_values.assign(outgoing_transitions.size(), INF);
+    open_queue.clear();
+    g_values[init_id] = 0;
+    open_queue.push(0, init_id);
+    while (!open_queue.empty()) {
+        pair<int, int> top_pair = open_queue.pop();
+        int g = top_pair.first;
+        int state_id = top_pair.second;
+        assert(0 <= g && g < INF);
+        if (g > g_values[state_id])
+            continue;
+        for (const Transition &transition : outgoing_transitions[state_id]) {
+            int succ_id = transition.target_id;
+            int succ_g = add_costs(get_cost(transition.op_id), g);
+            if (succ_g < g_values[succ_id]) {
+                g_values[succ_id] = succ_g;
+                open_queue.push(succ_g, succ_id);
+            }
+        }
     }
 }
 }
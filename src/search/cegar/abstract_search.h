@@ -5,49 +5,100 @@
 
 #include "transition.h"
 
-#include <deque>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace cegar {
-class AbstractState;
-
-using AbstractStates = std::unordered_set<AbstractState *>;
-using Solution = std::deque<Transition>;
+using Goals = std::unordered_set<int>;
+using Solution = std::vector<Transition>;
 
 /*
-  Find abstract solutions using A*. Compute g and h values for abstract
-  states.
+  Maintain goal distances and find abstract solutions. Compute g values
+  for abstract states.
+
+  States are identified by their IDs and all values are stored in
+  vectors indexed by state ID. The transitions are passed in as vectors
+  indexed by the ID of the state they belong to.
+
+  Instead of searching for a new abstract solution after each split, we
+  maintain the goal distances of all states together with a shortest
+  path tree: for each non-goal state with finite goal distance we store
+  the first transition of a shortest path to a goal. Abstract solutions
+  are then found by following the tree from the initial state.
+
+  Splitting a state never decreases goal distances. Therefore, after
+  splitting v, only the states whose shortest path leads through v may
+  change their goal distance. We first try to reconnect each of them to
+  an unaffected state without increasing its goal distance and compute
+  new goal distances for the remaining states with Dijkstra's algorithm,
+  seeded with the transitions that lead to unaffected states.
 */
 class AbstractSearch {
-    const std::vector<int> operator_costs;
-    AbstractStates &states;
+    std::vector<int> operator_costs;
 
-    AdaptiveQueue<AbstractState *> open_queue;
+    std::vector<int> goal_distances;
+    std::vector<Transition> shortest_path;
+    std::vector<int> g_values;
+    // States whose goal distances may be wrong.
+    std::vector<bool> dirty;
+    std::vector<int> orphans;
+    AdaptiveQueue<int> open_queue;
     Solution solution;
 
-    void reset();
+    int get_cost(int op_id) const;
 
-    void extract_solution(AbstractState *init, AbstractState *goal);
+    void add_orphans(
+        const std::vector<Transitions> &incoming_transitions,
+        int state_id, int old_state_id);
 
-    AbstractState *astar_search(
-        bool forward,
-        bool use_h,
-        AbstractStates *goals = nullptr);
+    // Run Dijkstra's algorithm backwards from the queued states.
+    void propagate_goal_distances(
+        const std::vector<Transitions> &incoming_transitions);
 
 public:
-    AbstractSearch(
-        std::vector<int> &&operator_costs,
-        AbstractStates &states);
+    explicit AbstractSearch(std::vector<int> &&operator_costs);
+
+    // Distances have to be recomputed after changing the costs.
+    void set_operator_costs(std::vector<int> &&costs) {
+        operator_costs = std::move(costs);
+    }
 
-    bool find_solution(AbstractState *init, AbstractStates &goals);
+    // Compute goal distances and the shortest path tree from scratch.
+    void compute_goal_distances(
+        const std::vector<Transitions> &incoming_transitions,
+        const Goals &goal_ids);
 
-    void forward_dijkstra(AbstractState *init);
-    void backwards_dijkstra(const AbstractStates goals);
+    /*
+      Repair goal distances and the shortest path tree after state v has
+      been split into v1 and v2 and the goal states have been updated.
+      v1 takes over the ID of v and v2 receives the next free ID.
+    */
+    void update_goal_distances(
+        const std::vector<Transitions> &incoming_transitions,
+        const std::vector<Transitions> &outgoing_transitions,
+        const Goals &goal_ids, int v_id, int v2_id);
+
+    /*
+      Extract an optimal abstract solution from the shortest path tree.
+      Return false if the abstract initial state is a dead end.
+    */
+    bool find_solution(int init_id, const Goals &goal_ids);
+
+    void forward_dijkstra(
+        const std::vector<Transitions> &outgoing_transitions, int init_id);
 
     const Solution &get_solution() {
         return solution;
     }
+
+    int get_g_value(int state_id) const {
+        return g_values[state_id];
+    }
+
+    int get_h_value(int state_id) const {
+        return goal_distances[state_id];
+    }
 };
 }
 
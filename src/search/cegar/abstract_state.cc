@@ -12,8 +12,6 @@
 using namespace std;
 
 namespace cegar {
-const int AbstractSearchInfo::UNDEFINED_OPERATOR = -1;
-
 AbstractState::AbstractState(const Domains &domains, Node *node)
     : domains(domains),
       node(node) {
@@ -21,11 +19,13 @@ AbstractState::AbstractState(const Domains &domains, Node *node)
 
 AbstractState::AbstractState(AbstractState &&other)
     : domains(move(other.domains)),
-      node(move(other.node)),
-      incoming_transitions(move(other.incoming_transitions)),
-      outgoing_transitions(move(other.outgoing_transitions)),
-      loops(move(other.loops)),
-      search_info(move(other.search_info)) {
+      node(other.node) {
+}
+
+AbstractState &AbstractState::operator=(AbstractState &&other) {
+    domains = move(other.domains);
+    node = other.node;
+    return *this;
 }
 
 int AbstractState::count(int var) const {
@@ -36,39 +36,8 @@ bool AbstractState::contains(int var, int value) const {
     return domains.test(var, value);
 }
 
-void AbstractState::add_outgoing_transition(int op_id, AbstractState *target) {
-    assert(target != this);
-    outgoing_transitions.emplace_back(op_id, target);
-}
-
-void AbstractState::add_incoming_transition(int op_id, AbstractState *src) {
-    assert(src != this);
-    incoming_transitions.emplace_back(op_id, src);
-}
-
-void AbstractState::add_loop(int op_id) {
-    loops.push_back(op_id);
-}
-
-void AbstractState::remove_non_looping_transition(
-    Transitions &transitions, int op_id, AbstractState *other) {
-    auto pos = find(
-        transitions.begin(), transitions.end(), Transition(op_id, other));
-    assert(pos != transitions.end());
-    swap(*pos, transitions.back());
-    transitions.pop_back();
-}
-
-void AbstractState::remove_incoming_transition(int op_id, AbstractState *other) {
-    remove_non_looping_transition(incoming_transitions, op_id, other);
-}
-
-void AbstractState::remove_outgoing_transition(int op_id, AbstractState *other) {
-    remove_non_looping_transition(outgoing_transitions, op_id, other);
-}
-
-pair<AbstractState *, AbstractState *> AbstractState::split(
-    int var, const vector<int> &wanted) {
+pair<AbstractState, AbstractState> AbstractState::split(
+    int var, const vector<int> &wanted) const {
     int num_wanted = wanted.size();
     utils::unused_variable(num_wanted);
     // We can only split states in the refinement hierarchy (not artificial states).
@@ -97,18 +66,13 @@ pair<AbstractState *, AbstractState *> AbstractState::split(
     // Update refinement hierarchy.
     pair<Node *, Node *> new_nodes = node->split(var, wanted);
 
-    AbstractState *v1 = new AbstractState(v1_domains, new_nodes.first);
-    AbstractState *v2 = new AbstractState(v2_domains, new_nodes.second);
+    AbstractState v1(v1_domains, new_nodes.first);
+    AbstractState v2(v2_domains, new_nodes.second);
 
-    assert(this->is_more_general_than(*v1));
-    assert(this->is_more_general_than(*v2));
+    assert(this->is_more_general_than(v1));
+    assert(this->is_more_general_than(v2));
 
-    // Since h-values only increase we can assign the h-value to the children.
-    int h = node->get_h_value();
-    v1->set_h_value(h);
-    v2->set_h_value(h);
-
-    return make_pair(v1, v2);
+    return make_pair(move(v1), move(v2));
 }
 
 AbstractState AbstractState::regress(OperatorProxy op) const {
@@ -124,8 +88,8 @@ AbstractState AbstractState::regress(OperatorProxy op) const {
     return AbstractState(regressed_domains, nullptr);
 }
 
-bool AbstractState::domains_intersect(const AbstractState *other, int var) const {
-    return domains.intersects(other->domains, var);
+bool AbstractState::domains_intersect(const AbstractState &other, int var) const {
+    return domains.intersects(other.domains, var);
 }
 
 bool AbstractState::includes(const State &concrete_state) const {
@@ -145,16 +109,9 @@ void AbstractState::set_h_value(int new_h) {
     node->increase_h_value_to(new_h);
 }
 
-int AbstractState::get_h_value() const {
-    assert(node);
-    return node->get_h_value();
-}
-
-AbstractState *AbstractState::get_trivial_abstract_state(
+AbstractState AbstractState::get_trivial_abstract_state(
     const TaskProxy &task_proxy, Node *root_node) {
-    AbstractState *abstract_state = new AbstractState(
-        Domains(get_domain_sizes(task_proxy)), root_node);
-    return abstract_state;
+    return AbstractState(Domains(get_domain_sizes(task_proxy)), root_node);
 }
 
 AbstractState AbstractState::get_abstract_state(
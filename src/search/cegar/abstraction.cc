@@ -13,6 +13,7 @@
 #include <cassert>
 #include <iostream>
 #include <unordered_map>
+#include <utility>
 
 using namespace std;
 
@@ -20,16 +21,18 @@ namespace cegar {
 struct Flaw {
     // Last concrete and abstract state reached while tracing solution.
     const State concrete_state;
-    // TODO: After conversion to smart pointers, store as unique_ptr?
-    AbstractState *current_abstract_state;
+    const int current_abstract_state_id;
+    const AbstractState &current_abstract_state;
     // Hypothetical Cartesian set we would have liked to reach.
     const AbstractState desired_abstract_state;
 
     Flaw(
         State &&concrete_state,
-        AbstractState *current_abstract_state,
+        int current_abstract_state_id,
+        const AbstractState &current_abstract_state,
         AbstractState &&desired_abstract_state)
         : concrete_state(move(concrete_state)),
+          current_abstract_state_id(current_abstract_state_id),
           current_abstract_state(current_abstract_state),
           desired_abstract_state(move(desired_abstract_state)) {
     }
@@ -46,13 +49,13 @@ struct Flaw {
         */
         for (FactProxy wanted_fact_proxy : concrete_state) {
             FactPair fact = wanted_fact_proxy.get_pair();
-            if (!current_abstract_state->contains(fact.var, fact.value) ||
+            if (!current_abstract_state.contains(fact.var, fact.value) ||
                 !desired_abstract_state.contains(fact.var, fact.value)) {
                 VariableProxy var = wanted_fact_proxy.get_variable();
                 int var_id = var.get_id();
                 vector<int> wanted;
                 for (int value = 0; value < var.get_domain_size(); ++value) {
-                    if (current_abstract_state->contains(var_id, value) &&
+                    if (current_abstract_state.contains(var_id, value) &&
                         desired_abstract_state.contains(var_id, value)) {
                         wanted.push_back(value);
                     }
@@ -72,44 +75,45 @@ Abstraction::Abstraction(
     int max_non_looping_transitions,
     double max_time,
     bool use_general_costs,
-    PickSplit pick,
+    unique_ptr<SplitSelector> split_selector,
+    bool verbose,
     bool debug)
     : task_proxy(*task),
       max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
       use_general_costs(use_general_costs),
-      abstract_search(get_operator_costs(task_proxy), states),
-      split_selector(task, pick),
+      abstract_search(get_operator_costs(task_proxy)),
+      split_selector(move(split_selector)),
       transition_updater(task_proxy.get_operators()),
-      timer(max_time),
-      init(nullptr),
+      timer(max_time, utils::TimerType::WALL_CLOCK_TIME),
+      init_id(0),
       deviations(0),
       unmet_preconditions(0),
       unmet_goals(0),
+      verbose(verbose),
       debug(debug) {
     assert(max_states >= 1);
-    g_log << "Start building abstraction." << endl;
-    cout << "Maximum number of states: " << max_states << endl;
-    cout << "Maximum number of transitions: "
-         << max_non_looping_transitions << endl;
+    if (verbose) {
+        g_log << "Start building abstraction." << endl;
+        cout << "Maximum number of states: " << max_states << endl;
+        cout << "Maximum number of transitions: "
+             << max_non_looping_transitions << endl;
+    }
     build();
-    g_log << "Done building abstraction." << endl;
-    cout << "Time for building abstraction: " << timer << endl;
+    if (verbose) {
+        g_log << "Done building abstraction." << endl;
+        cout << "Time for building abstraction: " << timer << endl;
+    }
 
-    /* Even if we found a concrete solution, we might have refined in the
-       last iteration, so we should update the distances. */
-    update_h_and_g_values();
+    // The goal distances are always up to date, but the g values are not.
+    update_g_values();
 
-    print_statistics();
+    if (verbose)
+        print_statistics();
 }
 
-Abstraction::~Abstraction() {
-    for (AbstractState *state : states)
-        delete state;
-}
-
-bool Abstraction::is_goal(AbstractState *state) const {
-    return goals.count(state) == 1;
+bool Abstraction::is_goal(int state_id) const {
+    return goals.count(state_id) == 1;
 }
 
 void Abstraction::separate_facts_unreachable_before_goal() {
@@ -130,18 +134,21 @@ void Abstraction::separate_facts_unreachable_before_goal() {
                 unreachable_values.push_back(value);
         }
         if (!unreachable_values.empty())
-            refine(init, var_id, unreachable_values);
+            refine(init_id, var_id, unreachable_values);
     }
     goals.clear();
-    goals.insert(states.begin(), states.end());
+    for (int state_id = 0; state_id < get_num_states(); ++state_id)
+        goals.insert(state_id);
 }
 
 void Abstraction::create_trivial_abstraction() {
-    init = AbstractState::get_trivial_abstract_state(
-        task_proxy, refinement_hierarchy.get_root());
-    transition_updater.add_loops_to_trivial_abstract_state(init);
-    goals.insert(init);
-    states.insert(init);
+    states.push_back(AbstractState::get_trivial_abstract_state(
+        task_proxy, refinement_hierarchy.get_root()));
+    init_id = 0;
+    transition_updater.add_loops_to_trivial_abstract_state();
+    goals.insert(init_id);
+    abstract_search.compute_goal_distances(
+        transition_updater.get_incoming_transitions(), goals);
 }
 
 bool Abstraction::may_keep_refining() const {
@@ -164,12 +171,17 @@ void Abstraction::build() {
     */
     if (task_proxy.get_goals().size() == 1) {
         separate_facts_unreachable_before_goal();
+        // All states are goal states now.
+        abstract_search.compute_goal_distances(
+            transition_updater.get_incoming_transitions(), goals);
     }
     bool found_concrete_solution = false;
     while (may_keep_refining()) {
-        bool found_abstract_solution = abstract_search.find_solution(init, goals);
+        bool found_abstract_solution = abstract_search.find_solution(
+            init_id, goals);
         if (!found_abstract_solution) {
-            cout << "Abstract problem is unsolvable!" << endl;
+            if (verbose)
+                cout << "Abstract problem is unsolvable!" << endl;
             break;
         }
         unique_ptr<Flaw> flaw = find_flaw(abstract_search.get_solution());
@@ -177,84 +189,92 @@ void Abstraction::build() {
             found_concrete_solution = true;
             break;
         }
-        AbstractState *abstract_state = flaw->current_abstract_state;
+        int state_id = flaw->current_abstract_state_id;
         vector<Split> splits = flaw->get_possible_splits();
-        const Split &split = split_selector.pick_split(*abstract_state, splits);
-        refine(abstract_state, split.var_id, split.values);
+        const Split &split = split_selector->pick_split(states[state_id], splits);
+        refine(state_id, split.var_id, split.values);
     }
-    cout << "Concrete solution found: " << found_concrete_solution << endl;
+    if (verbose)
+        cout << "Concrete solution found: " << found_concrete_solution << endl;
 }
 
-void Abstraction::refine(AbstractState *state, int var, const vector<int> &wanted) {
+void Abstraction::refine(int state_id, int var, const vector<int> &wanted) {
     if (debug)
-        cout << "Refine " << *state << " for " << var << "=" << wanted << endl;
-    pair<AbstractState *, AbstractState *> new_states = state->split(var, wanted);
-    AbstractState *v1 = new_states.first;
-    AbstractState *v2 = new_states.second;
+        cout << "Refine " << states[state_id] << " for " << var << "=" << wanted << endl;
+    pair<AbstractState, AbstractState> new_states =
+        states[state_id].split(var, wanted);
+    int v1_id = state_id;
+    int v2_id = get_num_states();
 
-    transition_updater.rewire(state, v1, v2, var);
+    transition_updater.rewire(
+        states, state_id, new_states.first, new_states.second, var);
 
-    states.erase(state);
-    states.insert(v1);
-    states.insert(v2);
+    states[v1_id] = move(new_states.first);
+    states.push_back(move(new_states.second));
 
     /* Since the search is always started from the abstract initial state, v2
-       is never the new initial state and v1 is never a goal state. */
-    if (state == init) {
-        assert(v1->includes(task_proxy.get_initial_state()));
-        assert(!v2->includes(task_proxy.get_initial_state()));
-        init = v1;
+       is never the new initial state and v1 is never a goal state. The
+       initial state keeps its ID, because v1 takes over the ID of the split
+       state. */
+    if (state_id == init_id) {
+        assert(states[v1_id].includes(task_proxy.get_initial_state()));
+        assert(!states[v2_id].includes(task_proxy.get_initial_state()));
         if (debug)
-            cout << "New init state: " << *init << endl;
+            cout << "New init state: " << states[init_id] << endl;
     }
-    if (is_goal(state)) {
-        goals.erase(state);
-        goals.insert(v2);
+    if (is_goal(state_id)) {
+        goals.erase(state_id);
+        goals.insert(v2_id);
         if (debug)
-            cout << "New/additional goal state: " << *v2 << endl;
+            cout << "New/additional goal state: " << states[v2_id] << endl;
     }
 
+    abstract_search.update_goal_distances(
+        transition_updater.get_incoming_transitions(),
+        transition_updater.get_outgoing_transitions(),
+        goals, v1_id, v2_id);
+
     int num_states = get_num_states();
-    if (num_states % 1000 == 0) {
+    if (verbose && num_states % 1000 == 0) {
         g_log << num_states << "/" << max_states << " states, "
               << transition_updater.get_num_non_loops() << "/"
               << max_non_looping_transitions << " transitions" << endl;
     }
-
-    delete state;
 }
 
 unique_ptr<Flaw> Abstraction::find_flaw(const Solution &solution) {
     if (debug)
         cout << "Check solution:" << endl;
 
-    AbstractState *abstract_state = init;
+    int abstract_state_id = init_id;
     State concrete_state = task_proxy.get_initial_state();
-    assert(abstract_state->includes(concrete_state));
+    assert(states[abstract_state_id].includes(concrete_state));
 
     if (debug)
-        cout << "  Initial abstract state: " << *abstract_state << endl;
+        cout << "  Initial abstract state: " << states[abstract_state_id] << endl;
 
     for (const Transition &step : solution) {
         if (!utils::extra_memory_padding_is_reserved())
             break;
         OperatorProxy op = task_proxy.get_operators()[step.op_id];
-        AbstractState *next_abstract_state = step.target;
+        int next_abstract_state_id = step.target_id;
+        const AbstractState &next_abstract_state = states[next_abstract_state_id];
         if (is_applicable(op, concrete_state)) {
             if (debug)
-                cout << "  Move to " << *next_abstract_state << " with "
+                cout << "  Move to " << next_abstract_state << " with "
                      << op.get_name() << endl;
             State next_concrete_state = concrete_state.get_successor(op);
-            if (!next_abstract_state->includes(next_concrete_state)) {
+            if (!next_abstract_state.includes(next_concrete_state)) {
                 if (debug)
                     cout << "  Paths deviate." << endl;
                 ++deviations;
                 return utils::make_unique_ptr<Flaw>(
                     move(concrete_state),
-                    abstract_state,
-                    next_abstract_state->regress(op));
+                    abstract_state_id,
+                    states[abstract_state_id],
+                    next_abstract_state.regress(op));
             }
-            abstract_state = next_abstract_state;
+            abstract_state_id = next_abstract_state_id;
             concrete_state = move(next_concrete_state);
         } else {
             if (debug)
@@ -262,12 +282,13 @@ unique_ptr<Flaw> Abstraction::find_flaw(const Solution &solution) {
             ++unmet_preconditions;
             return utils::make_unique_ptr<Flaw>(
                 move(concrete_state),
-                abstract_state,
+                abstract_state_id,
+                states[abstract_state_id],
                 AbstractState::get_abstract_state(
                     task_proxy, op.get_preconditions()));
         }
     }
-    assert(is_goal(abstract_state));
+    assert(is_goal(abstract_state_id));
     if (is_goal_state(task_proxy, concrete_state)) {
         // We found a concrete solution.
         return nullptr;
@@ -277,24 +298,35 @@ unique_ptr<Flaw> Abstraction::find_flaw(const Solution &solution) {
         ++unmet_goals;
         return utils::make_unique_ptr<Flaw>(
             move(concrete_state),
-            abstract_state,
+            abstract_state_id,
+            states[abstract_state_id],
             AbstractState::get_abstract_state(
                 task_proxy, task_proxy.get_goals()));
     }
 }
 
-void Abstraction::update_h_and_g_values() {
-    abstract_search.backwards_dijkstra(goals);
-    for (AbstractState *state : states) {
-        state->set_h_value(state->get_search_info().get_g_value());
+void Abstraction::update_g_values() {
+    abstract_search.forward_dijkstra(
+        transition_updater.get_outgoing_transitions(), init_id);
+}
+
+RefinementHierarchy Abstraction::extract_refinement_hierarchy() {
+    assert(refinement_hierarchy.get_root());
+    for (int state_id = 0; state_id < get_num_states(); ++state_id) {
+        states[state_id].set_h_value(abstract_search.get_h_value(state_id));
     }
-    // Update g values.
-    // TODO: updating h values overwrites g values. Find better solution.
-    abstract_search.forward_dijkstra(init);
+    return move(refinement_hierarchy);
+}
+
+void Abstraction::set_operator_costs(vector<int> &&operator_costs) {
+    abstract_search.set_operator_costs(move(operator_costs));
+    abstract_search.compute_goal_distances(
+        transition_updater.get_incoming_transitions(), goals);
+    update_g_values();
 }
 
 int Abstraction::get_h_value_of_initial_state() const {
-    return init->get_h_value();
+    return abstract_search.get_h_value(init_id);
 }
 
 vector<int> Abstraction::get_saturated_costs() {
@@ -302,9 +334,12 @@ vector<int> Abstraction::get_saturated_costs() {
     // Use value greater than -INF to avoid arithmetic difficulties.
     const int min_cost = use_general_costs ? -INF : 0;
     vector<int> saturated_costs(num_ops, min_cost);
-    for (AbstractState *state : states) {
-        const int g = state->get_search_info().get_g_value();
-        const int h = state->get_h_value();
+    const vector<Transitions> &outgoing_transitions =
+        transition_updater.get_outgoing_transitions();
+    const vector<Loops> &loops = transition_updater.get_loops();
+    for (int state_id = 0; state_id < get_num_states(); ++state_id) {
+        const int g = abstract_search.get_g_value(state_id);
+        const int h = abstract_search.get_h_value(state_id);
 
         /*
           No need to maintain goal distances of unreachable (g == INF)
@@ -317,10 +352,9 @@ vector<int> Abstraction::get_saturated_costs() {
         if (g == INF || h == INF)
             continue;
 
-        for (const Transition &transition: state->get_outgoing_transitions()) {
+        for (const Transition &transition: outgoing_transitions[state_id]) {
             int op_id = transition.op_id;
-            AbstractState *successor = transition.target;
-            const int succ_h = successor->get_h_value();
+            const int succ_h = abstract_search.get_h_value(transition.target_id);
 
             if (succ_h == INF)
                 continue;
@@ -332,7 +366,7 @@ vector<int> Abstraction::get_saturated_costs() {
         if (use_general_costs) {
             /* To prevent negative cost cycles, all operators inducing
                self-loops must have non-negative costs. */
-            for (int op_id : state->get_loops()) {
+            for (int op_id : loops[state_id]) {
                 saturated_costs[op_id] = max(saturated_costs[op_id], 0);
             }
         }
@@ -345,12 +379,14 @@ void Abstraction::print_statistics() {
     int total_outgoing_transitions = 0;
     int total_loops = 0;
     int dead_ends = 0;
-    for (AbstractState *state : states) {
-        if (state->get_h_value() == INF)
+    for (int state_id = 0; state_id < get_num_states(); ++state_id) {
+        if (abstract_search.get_h_value(state_id) == INF)
             ++dead_ends;
-        total_incoming_transitions += state->get_incoming_transitions().size();
-        total_outgoing_transitions += state->get_outgoing_transitions().size();
-        total_loops += state->get_loops().size();
+        total_incoming_transitions +=
+            transition_updater.get_incoming_transitions()[state_id].size();
+        total_outgoing_transitions +=
+            transition_updater.get_outgoing_transitions()[state_id].size();
+        total_loops += transition_updater.get_loops()[state_id].size();
     }
     assert(total_outgoing_transitions == total_incoming_transitions);
 
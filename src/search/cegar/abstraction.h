@@ -2,6 +2,7 @@
 #define CEGAR_ABSTRACTION_H
 
 #include "abstract_search.h"
+#include "abstract_state.h"
 #include "refinement_hierarchy.h"
 #include "split_selector.h"
 #include "transition_updater.h"
@@ -22,7 +23,6 @@ class AdditiveHeuristic;
 }
 
 namespace cegar {
-class AbstractState;
 struct Flaw;
 
 /*
@@ -38,28 +38,24 @@ class Abstraction {
     const bool use_general_costs;
 
     AbstractSearch abstract_search;
-    SplitSelector split_selector;
+    std::unique_ptr<SplitSelector> split_selector;
     TransitionUpdater transition_updater;
 
     // Limit the time for building the abstraction.
     utils::CountdownTimer timer;
 
     /*
-      Set of all (as of yet unsplit) abstract states.
-
-      TODO: Store states as unique_ptrs. C++11 doesn't really support
-      unordered_sets of unique_ptrs, so we should probably use an
-      unordered_map<AbstractState *, unique_ptr<AbstractState>> to
-      allow for removing elements (see
-      https://stackoverflow.com/questions/18939882).
+      All (as of yet unsplit) abstract states, indexed by state ID. When a
+      state is split, the first child takes over its ID and the second
+      child is appended.
     */
-    AbstractStates states;
+    std::vector<AbstractState> states;
 
     // Abstract initial state.
-    AbstractState *init;
+    int init_id;
     /* Abstract goal states. Landmark tasks may have multiple abstract
        goal states. */
-    AbstractStates goals;
+    Goals goals;
 
     // Count the number of times each flaw type is encountered.
     int deviations;
@@ -70,6 +66,8 @@ class Abstraction {
        current states. */
     RefinementHierarchy refinement_hierarchy;
 
+    // Print progress information while building the abstraction.
+    const bool verbose;
     const bool debug;
 
     void create_trivial_abstraction();
@@ -89,10 +87,10 @@ class Abstraction {
     // Build abstraction.
     void build();
 
-    bool is_goal(AbstractState *state) const;
+    bool is_goal(int state_id) const;
 
     // Split state into two child states.
-    void refine(AbstractState *state, int var, const std::vector<int> &wanted);
+    void refine(int state_id, int var, const std::vector<int> &wanted);
 
     AbstractState get_cartesian_set(const ConditionsProxy &conditions) const;
 
@@ -100,28 +98,36 @@ class Abstraction {
        first encountered flaw or nullptr if there is no flaw. */
     std::unique_ptr<Flaw> find_flaw(const Solution &solution);
 
-    // Perform Dijkstra's algorithm from the goal states to update the h-values.
-    void update_h_and_g_values();
-
-    void print_statistics();
+    // Compute the g values of all states, which saturated costs depend on.
+    void update_g_values();
 
 public:
+    /*
+      Without verbose output, the abstraction is built silently and the
+      caller is responsible for calling print_statistics. This allows
+      building several abstractions concurrently.
+    */
     Abstraction(
         const std::shared_ptr<AbstractTask> task,
         int max_states,
         int max_non_looping_transitions,
         double max_time,
         bool use_general_costs,
-        PickSplit pick,
+        std::unique_ptr<SplitSelector> split_selector,
+        bool verbose = true,
         bool debug = false);
-    ~Abstraction();
 
     Abstraction(const Abstraction &) = delete;
 
-    RefinementHierarchy extract_refinement_hierarchy() {
-        assert(refinement_hierarchy.get_root());
-        return std::move(refinement_hierarchy);
-    }
+    // Store the goal distances in the refinement hierarchy and return it.
+    RefinementHierarchy extract_refinement_hierarchy();
+
+    /*
+      Recompute all distances for the given operator costs. The abstract
+      states and transitions stay the same, so the abstraction yields an
+      admissible heuristic for the new costs as well.
+    */
+    void set_operator_costs(std::vector<int> &&operator_costs);
 
     int get_num_states() const {
         return states.size();
@@ -138,6 +144,8 @@ public:
     std::vector<int> get_saturated_costs();
 
     int get_h_value_of_initial_state() const;
+
+    void print_statistics();
 };
 }
 
@@ -9,6 +9,7 @@
 
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 
 #include <cassert>
 
@@ -26,7 +27,9 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<int>("max_transitions"),
         opts.get<double>("max_time"),
         opts.get<bool>("use_general_costs"),
-        static_cast<PickSplit>(opts.get<int>("pick")));
+        static_cast<PickSplit>(opts.get<int>("pick")),
+        opts.get<int>("batch_size"),
+        utils::parse_num_threads_from_options(opts));
     return cost_saturation.generate_heuristic_functions(
         opts.get<shared_ptr<AbstractTask>>("transform"));
 }
@@ -43,9 +46,10 @@ int AdditiveCartesianHeuristic::compute_heuristic(const GlobalState &global_stat
 }
 
 int AdditiveCartesianHeuristic::compute_heuristic(const State &state) {
+    const vector<int> &values = state.get_values();
     int sum_h = 0;
     for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
+        int value = function.get_value(values);
         assert(value >= 0);
         if (value == INF)
             return DEAD_END;
@@ -103,7 +107,7 @@ static Heuristic *_parse(OptionParser &parser) {
         Bounds("0", "infinity"));
     parser.add_option<double>(
         "max_time",
-        "maximum time in seconds for building abstractions",
+        "maximum wall-clock time in seconds for building abstractions",
         "infinity",
         Bounds("0.0", "infinity"));
     vector<string> pick_strategies;
@@ -120,6 +124,16 @@ static Heuristic *_parse(OptionParser &parser) {
         "use_general_costs",
         "allow negative costs in cost partitioning",
         "true");
+    parser.add_option<int>(
+        "batch_size",
+        "number of subtasks whose abstractions are refined concurrently. "
+        "All abstractions of a batch are refined for the remaining costs "
+        "before the batch and their costs are saturated in subtask order "
+        "afterwards. With batch_size=1, each abstraction is refined for "
+        "the costs left by all previous abstractions.",
+        "1",
+        Bounds("1", "infinity"));
+    utils::add_num_threads_option(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
 
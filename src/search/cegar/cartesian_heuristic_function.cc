@@ -1,18 +1,82 @@
 #include "cartesian_heuristic_function.h"
 
+#include "refinement_hierarchy.h"
+
+#include "../abstract_task.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <unordered_map>
+
 using namespace std;
 
 namespace cegar {
-CartesianHeuristicFunction::CartesianHeuristicFunction(
-    const shared_ptr<AbstractTask> &task,
-    RefinementHierarchy &&hierarchy)
-    : task(task),
-      task_proxy(*task),
-      refinement_hierarchy(move(hierarchy)) {
+/*
+  Return value_map with value_map[var][ancestor_value] being the
+  subtask value of var. This assumes that the subtask has the same
+  variables as its ancestor and converts the values of each variable
+  independently, which holds for all tasks used by CEGAR.
+*/
+static vector<vector<int>> get_value_map(
+    const AbstractTask &subtask, const AbstractTask &ancestor_task) {
+    int num_vars = ancestor_task.get_num_variables();
+    assert(subtask.get_num_variables() == num_vars);
+    int max_domain_size = 0;
+    for (int var = 0; var < num_vars; ++var) {
+        max_domain_size = max(
+            max_domain_size, ancestor_task.get_variable_domain_size(var));
+    }
+    vector<vector<int>> value_map(num_vars);
+    for (int value = 0; value < max_domain_size; ++value) {
+        vector<int> values(num_vars);
+        for (int var = 0; var < num_vars; ++var) {
+            values[var] = min(
+                value, ancestor_task.get_variable_domain_size(var) - 1);
+        }
+        subtask.convert_state_values(values, &ancestor_task);
+        for (int var = 0; var < num_vars; ++var) {
+            if (value < ancestor_task.get_variable_domain_size(var))
+                value_map[var].push_back(values[var]);
+        }
+    }
+    return value_map;
 }
 
-int CartesianHeuristicFunction::get_value(const State &parent_state) const {
-    State local_state = task_proxy.convert_ancestor_state(parent_state);
-    return refinement_hierarchy.get_node(local_state)->get_h_value();
+CartesianHeuristicFunction::CartesianHeuristicFunction(
+    const AbstractTask &subtask,
+    const AbstractTask &ancestor_task,
+    const RefinementHierarchy &hierarchy) {
+    vector<vector<int>> value_map = get_value_map(subtask, ancestor_task);
+
+    unordered_map<const Node *, int> node_ids;
+    deque<const Node *> queue;
+    auto get_entry =
+        [&](const Node *node) {
+            if (!node->is_split())
+                return ~node->get_h_value();
+            auto result = node_ids.emplace(
+                node, static_cast<int>(node_ids.size()));
+            if (result.second)
+                queue.push_back(node);
+            return result.first->second;
+        };
+
+    root = get_entry(hierarchy.get_root());
+    while (!queue.empty()) {
+        const Node *node = queue.front();
+        queue.pop_front();
+        assert(node_ids[node] == static_cast<int>(nodes.size()));
+        int var = node->get_var();
+        nodes.push_back({var, static_cast<int>(children.size())});
+        for (int subtask_value : value_map[var]) {
+            const Node *child = node;
+            while (child->is_split() && child->get_var() == var)
+                child = child->get_child(subtask_value);
+            children.push_back(get_entry(child));
+        }
+    }
+    nodes.shrink_to_fit();
+    children.shrink_to_fit();
 }
 }
@@ -1,38 +1,61 @@
 #ifndef CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 #define CEGAR_CARTESIAN_HEURISTIC_FUNCTION_H
 
-#include "refinement_hierarchy.h"
-
-#include "../task_proxy.h"
-
-#include <memory>
+#include <utility>
+#include <vector>
 
 class AbstractTask;
-class State;
 
 namespace cegar {
+class RefinementHierarchy;
+
 /*
-  Store RefinementHierarchy and subtask for looking up heuristic values
+  Store a compiled RefinementHierarchy for looking up heuristic values
   efficiently.
+
+  After refinement, the hierarchy is flattened into a breadth-first
+  array of decision nodes. Each node tests one variable and has one
+  child entry per value of that variable. Chains of nodes testing the
+  same variable, in particular the helper nodes of the hierarchy, are
+  collapsed into a single node. Child entries c >= 0 are node indices,
+  entries c < 0 are leaves with heuristic value ~c.
+
+  The tables are indexed by the values of an ancestor task of the
+  subtask (the task of the heuristic), so that all heuristic functions
+  can be evaluated on the same unpacked state without converting it.
 */
 class CartesianHeuristicFunction {
-    const std::shared_ptr<AbstractTask> task;
-    TaskProxy task_proxy;
-    RefinementHierarchy refinement_hierarchy;
+    struct DecisionNode {
+        int var;
+        int first_child;
+    };
+
+    std::vector<DecisionNode> nodes;
+    std::vector<int> children;
+    int root;
 
 public:
     CartesianHeuristicFunction(
-        const std::shared_ptr<AbstractTask> &task,
-        RefinementHierarchy &&hierarchy);
+        const AbstractTask &subtask,
+        const AbstractTask &ancestor_task,
+        const RefinementHierarchy &hierarchy);
 
     // Visual Studio 2013 needs an explicit implementation.
     CartesianHeuristicFunction(CartesianHeuristicFunction &&other)
-        : task(std::move(other.task)),
-          task_proxy(std::move(other.task_proxy)),
-          refinement_hierarchy(std::move(other.refinement_hierarchy)) {
+        : nodes(std::move(other.nodes)),
+          children(std::move(other.children)),
+          root(other.root) {
     }
 
-    int get_value(const State &parent_state) const;
+    // Take the state values of the ancestor task passed to the constructor.
+    int get_value(const std::vector<int> &ancestor_state_values) const {
+        int entry = root;
+        while (entry >= 0) {
+            const DecisionNode &node = nodes[entry];
+            entry = children[node.first_child + ancestor_state_values[node.var]];
+        }
+        return ~entry;
+    }
 };
 }
 
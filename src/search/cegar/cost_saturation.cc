@@ -13,9 +13,12 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
+#include "../utils/rng.h"
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace std;
 
@@ -37,13 +40,17 @@ CostSaturation::CostSaturation(
     int max_non_looping_transitions,
     double max_time,
     bool use_general_costs,
-    PickSplit pick_split)
+    PickSplit pick_split,
+    int batch_size,
+    int num_threads)
     : subtask_generators(subtask_generators),
       max_states(max_states),
       max_non_looping_transitions(max_non_looping_transitions),
       max_time(max_time),
       use_general_costs(use_general_costs),
       pick_split(pick_split),
+      batch_size(batch_size),
+      num_threads(num_threads),
       num_abstractions(0),
       num_states(0),
       num_non_looping_transitions(0) {
@@ -54,7 +61,11 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
     // For simplicity this is a member object. Make sure it is in a valid state.
     assert(heuristic_functions.empty());
 
-    utils::CountdownTimer timer(max_time);
+    /*
+      Abstractions may be built on several threads, so we limit the
+      wall-clock time. The limit then does not depend on num_threads.
+    */
+    utils::CountdownTimer timer(max_time, utils::TimerType::WALL_CLOCK_TIME);
 
     TaskProxy task_proxy(*task);
 
@@ -77,7 +88,7 @@ vector<CartesianHeuristicFunction> CostSaturation::generate_heuristic_functions(
     utils::reserve_extra_memory_padding(memory_padding_in_mb);
     for (shared_ptr<SubtaskGenerator> subtask_generator : subtask_generators) {
         SharedTasks subtasks = subtask_generator->get_subtasks(task);
-        build_abstractions(subtasks, timer, should_abort);
+        build_abstractions(*task, subtasks, timer, should_abort);
         if (should_abort())
             break;
     }
@@ -126,46 +137,98 @@ shared_ptr<AbstractTask> CostSaturation::get_remaining_costs_task(
 
 bool CostSaturation::state_is_dead_end(const State &state) const {
     for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        if (function.get_value(state) == INF)
+        if (function.get_value(state.get_values()) == INF)
             return true;
     }
     return false;
 }
 
 void CostSaturation::build_abstractions(
+    const AbstractTask &task,
     const vector<shared_ptr<AbstractTask>> &subtasks,
     const utils::CountdownTimer &timer,
     function<bool()> should_abort) {
-    int rem_subtasks = subtasks.size();
-    for (shared_ptr<AbstractTask> subtask : subtasks) {
-        subtask = get_remaining_costs_task(subtask);
-
+    int num_subtasks = subtasks.size();
+    int rem_subtasks = num_subtasks;
+    for (int batch_start = 0; batch_start < num_subtasks;) {
         assert(num_states < max_states);
-        Abstraction abstraction(
-            subtask,
-            max(1, (max_states - num_states) / rem_subtasks),
-            max(1, (max_non_looping_transitions - num_non_looping_transitions) /
-                rem_subtasks),
-            timer.get_remaining_time() / rem_subtasks,
-            use_general_costs,
-            pick_split);
-
-        ++num_abstractions;
-        num_states += abstraction.get_num_states();
-        num_non_looping_transitions += abstraction.get_num_non_looping_transitions();
-        assert(num_states <= max_states);
-        reduce_remaining_costs(abstraction.get_saturated_costs());
-        int init_h = abstraction.get_h_value_of_initial_state();
-
-        if (init_h > 0) {
-            heuristic_functions.emplace_back(
-                subtask,
-                abstraction.extract_refinement_hierarchy());
+        /*
+          Every abstraction has at least one state, so we never start more
+          abstractions than fit into the remaining state budget.
+        */
+        int num_jobs = min({batch_size, rem_subtasks, max_states - num_states});
+        int job_max_states = max(1, (max_states - num_states) / rem_subtasks);
+        int job_max_non_looping_transitions = max(
+            1, (max_non_looping_transitions - num_non_looping_transitions) /
+            rem_subtasks);
+        double job_max_time = timer.get_remaining_time() / rem_subtasks;
+
+        /*
+          All abstractions of a batch are refined for the current remaining
+          costs. We prepare everything that uses global state or writes
+          to the log here, so that the abstractions can be built
+          concurrently. This includes the h^add values used by the split
+          selectors.
+        */
+        vector<shared_ptr<AbstractTask>> batch_subtasks;
+        vector<unique_ptr<SplitSelector>> split_selectors;
+        for (int job = 0; job < num_jobs; ++job) {
+            shared_ptr<AbstractTask> subtask = subtasks[batch_start + job];
+            batch_subtasks.push_back(get_remaining_costs_task(subtask));
+            shared_ptr<utils::RandomNumberGenerator> rng;
+            if (batch_size == 1) {
+                rng = g_rng();
+            } else {
+                rng = make_shared<utils::RandomNumberGenerator>(
+                    (*g_rng())(numeric_limits<int>::max()));
+            }
+            split_selectors.push_back(utils::make_unique_ptr<SplitSelector>(
+                                          batch_subtasks.back(), pick_split, rng));
         }
-        if (should_abort())
-            break;
-
-        --rem_subtasks;
+        vector<unique_ptr<Abstraction>> abstractions(num_jobs);
+        utils::run_in_parallel(
+            num_jobs, num_threads,
+            [&](int, int job) {
+                abstractions[job] = utils::make_unique_ptr<Abstraction>(
+                    batch_subtasks[job],
+                    job_max_states,
+                    job_max_non_looping_transitions,
+                    job_max_time,
+                    use_general_costs,
+                    move(split_selectors[job]),
+                    batch_size == 1);
+            });
+
+        // Saturate the costs in subtask order.
+        for (int job = 0; job < num_jobs; ++job) {
+            Abstraction &abstraction = *abstractions[job];
+            if (job > 0) {
+                // Earlier abstractions of the batch have consumed costs.
+                abstraction.set_operator_costs(vector<int>(remaining_costs));
+            }
+            if (batch_size > 1)
+                abstraction.print_statistics();
+
+            ++num_abstractions;
+            num_states += abstraction.get_num_states();
+            num_non_looping_transitions +=
+                abstraction.get_num_non_looping_transitions();
+            assert(num_states <= max_states);
+            reduce_remaining_costs(abstraction.get_saturated_costs());
+            int init_h = abstraction.get_h_value_of_initial_state();
+
+            if (init_h > 0) {
+                heuristic_functions.emplace_back(
+                    *batch_subtasks[job], task,
+                    abstraction.extract_refinement_hierarchy());
+            }
+            abstractions[job] = nullptr;
+            if (should_abort())
+                return;
+
+            --rem_subtasks;
+        }
+        batch_start += num_jobs;
     }
 }
 
@@ -16,10 +16,18 @@ class SubtaskGenerator;
 
 /*
   Get subtasks from SubtaskGenerators, reduce their costs by wrapping
-  them in ModifiedOperatorCostsTasks, compute Abstractions, move
-  RefinementHierarchies from Abstractions to
+  them in ModifiedOperatorCostsTasks, compute Abstractions, compile
+  RefinementHierarchies from Abstractions into
   CartesianHeuristicFunctions, allow extracting
   CartesianHeuristicFunctions into AdditiveCartesianHeuristic.
+
+  Subtasks are handled in batches of batch_size subtasks. The
+  abstractions of a batch are refined concurrently, all for the
+  remaining costs before the batch. Afterwards, we recompute their
+  distances for the actual remaining costs and saturate the costs in
+  subtask order. This keeps the cost partitioning admissible, but later
+  abstractions of a batch are refined for outdated costs. The result
+  depends on batch_size, but not on num_threads.
 */
 class CostSaturation {
     const std::vector<std::shared_ptr<SubtaskGenerator>> subtask_generators;
@@ -28,6 +36,8 @@ class CostSaturation {
     const double max_time;
     const bool use_general_costs;
     const PickSplit pick_split;
+    const int batch_size;
+    const int num_threads;
 
     std::vector<CartesianHeuristicFunction> heuristic_functions;
     std::vector<int> remaining_costs;
@@ -41,6 +51,7 @@ class CostSaturation {
         std::shared_ptr<AbstractTask> &parent) const;
     bool state_is_dead_end(const State &state) const;
     void build_abstractions(
+        const AbstractTask &task,
         const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
         const utils::CountdownTimer &timer,
         std::function<bool()> should_abort);
@@ -53,7 +64,9 @@ public:
         int max_non_looping_transitions,
         double max_time,
         bool use_general_costs,
-        PickSplit pick_split);
+        PickSplit pick_split,
+        int batch_size,
+        int num_threads);
 
     std::vector<CartesianHeuristicFunction> generate_heuristic_functions(
         const std::shared_ptr<AbstractTask> &task);
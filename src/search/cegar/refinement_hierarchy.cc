@@ -1,7 +1,5 @@
 #include "refinement_hierarchy.h"
 
-#include "../task_proxy.h"
-
 using namespace std;
 
 namespace cegar {
@@ -49,13 +47,4 @@ Node *Node::get_child(int value) const {
 RefinementHierarchy::RefinementHierarchy()
     : root(new Node()) {
 }
-
-Node *RefinementHierarchy::get_node(const State &state) const {
-    assert(root);
-    Node *current = root.get();
-    while (current->is_split()) {
-        current = current->get_child(state[current->get_var()].get_value());
-    }
-    return current;
-}
 }
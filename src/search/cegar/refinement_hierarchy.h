@@ -6,8 +6,6 @@
 #include <utility>
 #include <vector>
 
-class State;
-
 namespace cegar {
 class Node;
 
@@ -34,8 +32,6 @@ public:
         : root(std::move(other.root)) {
     }
 
-    Node *get_node(const State &state) const;
-
     Node *get_root() const {
         return root.get();
     }
@@ -3,8 +3,6 @@
 #include "abstract_state.h"
 #include "utils.h"
 
-#include "../globals.h"
-
 #include "../heuristics/additive_heuristic.h"
 
 #include "../utils/logging.h"
@@ -19,10 +17,12 @@ using namespace std;
 namespace cegar {
 SplitSelector::SplitSelector(
     const shared_ptr<AbstractTask> &task,
-    PickSplit pick)
+    PickSplit pick,
+    const shared_ptr<utils::RandomNumberGenerator> &rng)
     : task(task),
       task_proxy(*task),
-      pick(pick) {
+      pick(pick),
+      rng(rng) {
     if (pick == PickSplit::MIN_HADD || pick == PickSplit::MAX_HADD) {
         additive_heuristic = create_additive_heuristic(task);
         additive_heuristic->compute_heuristic_for_cegar(
@@ -119,7 +119,7 @@ const Split &SplitSelector::pick_split(const AbstractState &state,
     }
 
     if (pick == PickSplit::RANDOM) {
-        return *g_rng()->choose(splits);
+        return *rng->choose(splits);
     }
 
     double max_rating = numeric_limits<double>::lowest();
@@ -10,6 +10,10 @@ namespace additive_heuristic {
 class AdditiveHeuristic;
 }
 
+namespace utils {
+class RandomNumberGenerator;
+}
+
 namespace cegar {
 class AbstractState;
 
@@ -47,6 +51,8 @@ class SplitSelector {
     std::unique_ptr<additive_heuristic::AdditiveHeuristic> additive_heuristic;
 
     const PickSplit pick;
+    // Only used for random picks.
+    std::shared_ptr<utils::RandomNumberGenerator> rng;
 
     int get_num_unwanted_values(const AbstractState &state, const Split &split) const;
     double get_refinedness(const AbstractState &state, int var_id) const;
@@ -57,7 +63,9 @@ class SplitSelector {
     double rate_split(const AbstractState &state, const Split &split) const;
 
 public:
-    SplitSelector(const std::shared_ptr<AbstractTask> &task, PickSplit pick);
+    SplitSelector(
+        const std::shared_ptr<AbstractTask> &task, PickSplit pick,
+        const std::shared_ptr<utils::RandomNumberGenerator> &rng);
     ~SplitSelector();
 
     const Split &pick_split(
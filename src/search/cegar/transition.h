@@ -1,22 +1,27 @@
 #ifndef CEGAR_TRANSITION_H
 #define CEGAR_TRANSITION_H
 
-namespace cegar {
-class AbstractState;
+#include <vector>
 
+namespace cegar {
 struct Transition {
     int op_id;
-    AbstractState *target;
+    int target_id;
 
-    Transition(int op_id, AbstractState *state)
+    Transition(int op_id, int target_id)
         : op_id(op_id),
-          target(state) {
+          target_id(target_id) {
     }
 
-    bool operator==(const Transition &other) {
-        return op_id == other.op_id && target == other.target;
+    bool operator==(const Transition &other) const {
+        return op_id == other.op_id && target_id == other.target_id;
     }
 };
+
+using Transitions = std::vector<Transition>;
+
+// To save space we store self-loops (operator indices) separately.
+using Loops = std::vector<int>;
 }
 
 #endif
@@ -81,164 +81,207 @@ int TransitionUpdater::get_postcondition_value(int op_id, int var) const {
     return lookup_value(postconditions_by_operator[op_id], var);
 }
 
-void TransitionUpdater::add_loops_to_trivial_abstract_state(AbstractState *state) {
+void TransitionUpdater::add_loops_to_trivial_abstract_state() {
+    assert(get_num_states() == 0);
+    incoming.emplace_back();
+    outgoing.emplace_back();
+    loops.emplace_back();
     for (size_t i = 0; i < preconditions_by_operator.size(); ++i) {
-        add_loop(state, i);
+        add_loop(0, i);
     }
 }
 
-void TransitionUpdater::add_transition(
-    AbstractState *src, int op_id, AbstractState *target) {
-    assert(src != target);
-    src->add_outgoing_transition(op_id, target);
-    target->add_incoming_transition(op_id, src);
+void TransitionUpdater::add_transition(int src_id, int op_id, int target_id) {
+    assert(src_id != target_id);
+    outgoing[src_id].emplace_back(op_id, target_id);
+    incoming[target_id].emplace_back(op_id, src_id);
     ++num_non_loops;
 }
 
-void TransitionUpdater::add_loop(AbstractState *state, int op_id) {
-    state->add_loop(op_id);
+void TransitionUpdater::add_loop(int state_id, int op_id) {
+    loops[state_id].push_back(op_id);
     ++num_loops;
 }
 
+void TransitionUpdater::remove_transition(
+    Transitions &transitions, int op_id, int other_id) {
+    auto pos = find(
+        transitions.begin(), transitions.end(), Transition(op_id, other_id));
+    assert(pos != transitions.end());
+    swap(*pos, transitions.back());
+    transitions.pop_back();
+}
+
 void TransitionUpdater::remove_incoming_transition(
-    AbstractState *src, int op_id, AbstractState *target) {
-    target->remove_incoming_transition(op_id, src);
+    int src_id, int op_id, int target_id) {
+    remove_transition(incoming[target_id], op_id, src_id);
     --num_non_loops;
 }
 
 void TransitionUpdater::remove_outgoing_transition(
-    AbstractState *src, int op_id, AbstractState *target) {
-    src->remove_outgoing_transition(op_id, target);
+    int src_id, int op_id, int target_id) {
+    remove_transition(outgoing[src_id], op_id, target_id);
     --num_non_loops;
 }
 
 void TransitionUpdater::rewire_incoming_transitions(
-    AbstractState *v, AbstractState *v1, AbstractState *v2, int var) {
+    const vector<AbstractState> &states, const Transitions &old_incoming,
+    int v_id, const AbstractState &v1, const AbstractState &v2, int var) {
     /* State v has been split into v1 and v2. Now for all transitions
        u->v we need to add transitions u->v1, u->v2, or both. */
-    for (const Transition &transition : v->get_incoming_transitions()) {
+    int v1_id = v_id;
+    int v2_id = get_num_states() - 1;
+    for (const Transition &transition : old_incoming) {
         int op_id = transition.op_id;
-        AbstractState *u = transition.target;
-        assert(u != v);
+        int u_id = transition.target_id;
+        assert(u_id != v_id);
+        const AbstractState &u = states[u_id];
         int post = get_postcondition_value(op_id, var);
         if (post == UNDEFINED_VALUE) {
             // op has no precondition and no effect on var.
-            bool u_and_v1_intersect = u->domains_intersect(v1, var);
+            bool u_and_v1_intersect = u.domains_intersect(v1, var);
             if (u_and_v1_intersect) {
-                add_transition(u, op_id, v1);
+                add_transition(u_id, op_id, v1_id);
             }
             /* If the domains of u and v1 don't intersect, we must add
                the other transition and can avoid an intersection test. */
-            if (!u_and_v1_intersect || u->domains_intersect(v2, var)) {
-                add_transition(u, op_id, v2);
+            if (!u_and_v1_intersect || u.domains_intersect(v2, var)) {
+                add_transition(u_id, op_id, v2_id);
             }
-        } else if (v1->contains(var, post)) {
+        } else if (v1.contains(var, post)) {
             // op can only end in v1.
-            add_transition(u, op_id, v1);
+            add_transition(u_id, op_id, v1_id);
         } else {
             // op can only end in v2.
-            assert(v2->contains(var, post));
-            add_transition(u, op_id, v2);
+            assert(v2.contains(var, post));
+            add_transition(u_id, op_id, v2_id);
         }
-        remove_outgoing_transition(u, op_id, v);
+        /* Since v1 reuses the ID of v, u may now have two transitions
+           u->v for op. The old one comes first, so we remove it. */
+        remove_outgoing_transition(u_id, op_id, v_id);
     }
 }
 
 void TransitionUpdater::rewire_outgoing_transitions(
-    AbstractState *v, AbstractState *v1, AbstractState *v2, int var) {
+    const vector<AbstractState> &states, const Transitions &old_outgoing,
+    int v_id, const AbstractState &v1, const AbstractState &v2, int var) {
     /* State v has been split into v1 and v2. Now for all transitions
        v->w we need to add transitions v1->w, v2->w, or both. */
-    for (const Transition &transition : v->get_outgoing_transitions()) {
+    int v1_id = v_id;
+    int v2_id = get_num_states() - 1;
+    for (const Transition &transition : old_outgoing) {
         int op_id = transition.op_id;
-        AbstractState *w = transition.target;
-        assert(w != v);
+        int w_id = transition.target_id;
+        assert(w_id != v_id);
+        const AbstractState &w = states[w_id];
         int pre = get_precondition_value(op_id, var);
         int post = get_postcondition_value(op_id, var);
         if (post == UNDEFINED_VALUE) {
             assert(pre == UNDEFINED_VALUE);
             // op has no precondition and no effect on var.
-            bool v1_and_w_intersect = v1->domains_intersect(w, var);
+            bool v1_and_w_intersect = v1.domains_intersect(w, var);
             if (v1_and_w_intersect) {
-                add_transition(v1, op_id, w);
+                add_transition(v1_id, op_id, w_id);
             }
             /* If the domains of v1 and w don't intersect, we must add
                the other transition and can avoid an intersection test. */
-            if (!v1_and_w_intersect || v2->domains_intersect(w, var)) {
-                add_transition(v2, op_id, w);
+            if (!v1_and_w_intersect || v2.domains_intersect(w, var)) {
+                add_transition(v2_id, op_id, w_id);
             }
         } else if (pre == UNDEFINED_VALUE) {
             // op has no precondition, but an effect on var.
-            add_transition(v1, op_id, w);
-            add_transition(v2, op_id, w);
-        } else if (v1->contains(var, pre)) {
+            add_transition(v1_id, op_id, w_id);
+            add_transition(v2_id, op_id, w_id);
+        } else if (v1.contains(var, pre)) {
             // op can only start in v1.
-            add_transition(v1, op_id, w);
+            add_transition(v1_id, op_id, w_id);
         } else {
             // op can only start in v2.
-            assert(v2->contains(var, pre));
-            add_transition(v2, op_id, w);
+            assert(v2.contains(var, pre));
+            add_transition(v2_id, op_id, w_id);
         }
-        remove_incoming_transition(v, op_id, w);
+        // As above, the old transition v->w comes before the new ones.
+        remove_incoming_transition(v_id, op_id, w_id);
     }
 }
 
 void TransitionUpdater::rewire_loops(
-    AbstractState *v, AbstractState *v1, AbstractState *v2, int var) {
+    const Loops &old_loops, int v_id, const AbstractState &v1,
+    const AbstractState &v2, int var) {
     /* State v has been split into v1 and v2. Now for all self-loops
        v->v we need to add one or two of the transitions v1->v1, v1->v2,
        v2->v1 and v2->v2. */
-    for (int op_id : v->get_loops()) {
+    int v1_id = v_id;
+    int v2_id = get_num_states() - 1;
+    for (int op_id : old_loops) {
         int pre = get_precondition_value(op_id, var);
         int post = get_postcondition_value(op_id, var);
         if (pre == UNDEFINED_VALUE) {
             // op has no precondition on var --> it must start in v1 and v2.
             if (post == UNDEFINED_VALUE) {
                 // op has no effect on var --> it must end in v1 and v2.
-                add_loop(v1, op_id);
-                add_loop(v2, op_id);
-            } else if (v2->contains(var, post)) {
+                add_loop(v1_id, op_id);
+                add_loop(v2_id, op_id);
+            } else if (v2.contains(var, post)) {
                 // op must end in v2.
-                add_transition(v1, op_id, v2);
-                add_loop(v2, op_id);
+                add_transition(v1_id, op_id, v2_id);
+                add_loop(v2_id, op_id);
             } else {
                 // op must end in v1.
-                assert(v1->contains(var, post));
-                add_loop(v1, op_id);
-                add_transition(v2, op_id, v1);
+                assert(v1.contains(var, post));
+                add_loop(v1_id, op_id);
+                add_transition(v2_id, op_id, v1_id);
             }
-        } else if (v1->contains(var, pre)) {
+        } else if (v1.contains(var, pre)) {
             // op must start in v1.
             assert(post != UNDEFINED_VALUE);
-            if (v1->contains(var, post)) {
+            if (v1.contains(var, post)) {
                 // op must end in v1.
-                add_loop(v1, op_id);
+                add_loop(v1_id, op_id);
             } else {
                 // op must end in v2.
-                assert(v2->contains(var, post));
-                add_transition(v1, op_id, v2);
+                assert(v2.contains(var, post));
+                add_transition(v1_id, op_id, v2_id);
             }
         } else {
             // op must start in v2.
-            assert(v2->contains(var, pre));
+            assert(v2.contains(var, pre));
             assert(post != UNDEFINED_VALUE);
-            if (v1->contains(var, post)) {
+            if (v1.contains(var, post)) {
                 // op must end in v1.
-                add_transition(v2, op_id, v1);
+                add_transition(v2_id, op_id, v1_id);
             } else {
                 // op must end in v2.
-                assert(v2->contains(var, post));
-                add_loop(v2, op_id);
+                assert(v2.contains(var, post));
+                add_loop(v2_id, op_id);
             }
         }
     }
-    num_loops -= v->get_loops().size();
+    num_loops -= old_loops.size();
 }
 
 void TransitionUpdater::rewire(
-    AbstractState *v, AbstractState *v1, AbstractState *v2, int var) {
-    rewire_incoming_transitions(v, v1, v2, var);
-    rewire_outgoing_transitions(v, v1, v2, var);
-    rewire_loops(v, v1, v2, var);
+    const vector<AbstractState> &states, int v_id,
+    const AbstractState &v1, const AbstractState &v2, int var) {
+    assert(static_cast<int>(states.size()) == get_num_states());
+    /*
+      Take the transitions of v out of the table, so that v1 starts
+      without transitions under the ID of v.
+    */
+    Transitions old_incoming;
+    Transitions old_outgoing;
+    Loops old_loops;
+    swap(old_incoming, incoming[v_id]);
+    swap(old_outgoing, outgoing[v_id]);
+    swap(old_loops, loops[v_id]);
+
+    incoming.emplace_back();
+    outgoing.emplace_back();
+    loops.emplace_back();
+
+    rewire_incoming_transitions(states, old_incoming, v_id, v1, v2, var);
+    rewire_outgoing_transitions(states, old_outgoing, v_id, v1, v2, var);
+    rewire_loops(old_loops, v_id, v1, v2, var);
 }
 
 int TransitionUpdater::get_num_non_loops() const {
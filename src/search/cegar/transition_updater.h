@@ -1,51 +1,84 @@
 #ifndef CEGAR_TRANSITION_UPDATER_H
 #define CEGAR_TRANSITION_UPDATER_H
 
-struct FactPair;
-class OperatorsProxy;
+#include "transition.h"
 
 #include <memory>
 #include <vector>
 
+struct FactPair;
+class OperatorsProxy;
+
 namespace cegar {
 class AbstractState;
 
 /*
-  Rewire transitions after each split.
+  Store the transitions of all abstract states, indexed by state ID,
+  and rewire them after each split.
 */
 class TransitionUpdater {
     std::vector<std::vector<FactPair>> preconditions_by_operator;
     std::vector<std::vector<FactPair>> postconditions_by_operator;
 
+    // Transitions from and to other abstract states.
+    std::vector<Transitions> incoming;
+    std::vector<Transitions> outgoing;
+
+    // Self-loops.
+    std::vector<Loops> loops;
+
     int num_non_loops;
     int num_loops;
 
     int get_precondition_value(int op_id, int var) const;
     int get_postcondition_value(int op_id, int var) const;
 
-    void add_transition(AbstractState *src, int op_id, AbstractState *target);
-    void add_loop(AbstractState *state, int op_id);
+    void add_transition(int src_id, int op_id, int target_id);
+    void add_loop(int state_id, int op_id);
 
-    void remove_incoming_transition(
-        AbstractState *src, int op_id, AbstractState *target);
-    void remove_outgoing_transition(
-        AbstractState *src, int op_id, AbstractState *target);
+    void remove_transition(Transitions &transitions, int op_id, int other_id);
+    void remove_incoming_transition(int src_id, int op_id, int target_id);
+    void remove_outgoing_transition(int src_id, int op_id, int target_id);
 
     void rewire_incoming_transitions(
-        AbstractState *v, AbstractState *v1, AbstractState *v2, int var);
+        const std::vector<AbstractState> &states, const Transitions &old_incoming,
+        int v_id, const AbstractState &v1, const AbstractState &v2, int var);
     void rewire_outgoing_transitions(
-        AbstractState *v, AbstractState *v1, AbstractState *v2, int var);
+        const std::vector<AbstractState> &states, const Transitions &old_outgoing,
+        int v_id, const AbstractState &v1, const AbstractState &v2, int var);
     void rewire_loops(
-        AbstractState *v, AbstractState *v1, AbstractState *v2, int var);
+        const Loops &old_loops, int v_id, const AbstractState &v1,
+        const AbstractState &v2, int var);
 
 public:
     explicit TransitionUpdater(const OperatorsProxy &ops);
 
-    void add_loops_to_trivial_abstract_state(AbstractState *state);
+    void add_loops_to_trivial_abstract_state();
 
-    // Update transition system after v has been split into v1 and v2.
+    /*
+      Update transition system after state v has been split into v1 and v2.
+      v1 takes over the ID of v and v2 receives the next free ID. The
+      states vector must still hold v and must not hold v2 yet.
+    */
     void rewire(
-        AbstractState *v, AbstractState *v1, AbstractState *v2, int var);
+        const std::vector<AbstractState> &states, int v_id,
+        const AbstractState &v1, const AbstractState &v2, int var);
+
+    const std::vector<Transitions> &get_incoming_transitions() const {
+        return incoming;
+    }
+
+    const std::vector<Transitions> &get_outgoing_transitions() const {
+        return outgoing;
+    }
+
+    const std::vector<Loops> &get_loops() const {
+        return loops;
+    }
+
+    int get_num_states() const {
+        return loops.size();
+    }
 
     int get_num_non_loops() const;
     int get_num_loops() const;
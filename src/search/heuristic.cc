@@ -6,15 +6,26 @@
 #include "globals.h"
 #include "option_parser.h"
 #include "plugin.h"
+#include "preferred_operator_cache.h"
 
 #include "tasks/cost_adapted_task.h"
 
+#include "utils/memory.h"
+
 #include <cassert>
 #include <cstdlib>
 #include <limits>
 
 using namespace std;
 
+/*
+  Number of states for which we remember preferred operators if the
+  preferred operator cache is enabled. In eager search, most states are
+  expanded long before this many other states have been evaluated, or
+  never at all.
+*/
+static const int PREFERRED_OPERATOR_CACHE_CAPACITY = 100000;
+
 Heuristic::Heuristic(const Options &opts)
     : description(opts.get_unparsed_config()),
       heuristic_cache(HEntry(NO_VALUE, true)), //TODO: is true really a good idea here?
@@ -26,6 +37,21 @@ Heuristic::Heuristic(const Options &opts)
 Heuristic::~Heuristic() {
 }
 
+void Heuristic::enable_preferred_operator_cache() {
+    if (cache_h_values && !preferred_operator_cache) {
+        preferred_operator_cache =
+            utils::make_unique_ptr<PreferredOperatorCache>(
+                PREFERRED_OPERATOR_CACHE_CAPACITY);
+    }
+}
+
+void Heuristic::print_statistics() const {
+    if (preferred_operator_cache) {
+        cout << "Preferred operator cache of " << description << ":" << endl;
+        preferred_operator_cache->print_statistics();
+    }
+}
+
 void Heuristic::set_preferred(const GlobalOperator *op) {
     preferred_operators.insert(op);
 }
@@ -73,10 +99,17 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     bool calculate_preferred = eval_context.get_calculate_preferred();
 
     int heuristic = NO_VALUE;
-
-    if (!calculate_preferred && cache_h_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
+    vector<const GlobalOperator *> cached_preferred_operators;
+    bool h_is_cached = cache_h_values &&
+        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty;
+
+    if (h_is_cached && (!calculate_preferred ||
+                        (preferred_operator_cache &&
+                         preferred_operator_cache->extract(
+                             state, cached_preferred_operators)))) {
         heuristic = heuristic_cache[state].h;
+        for (const GlobalOperator *op : cached_preferred_operators)
+            preferred_operators.insert(op);
         result.set_count_evaluation(false);
     } else {
         heuristic = compute_heuristic(state);
@@ -108,7 +141,13 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 #endif
 
     result.set_h_value(heuristic);
-    result.set_preferred_operators(preferred_operators.pop_as_vector());
+    vector<const GlobalOperator *> preferred_operator_vector =
+        preferred_operators.pop_as_vector();
+    if (preferred_operator_cache && result.get_count_evaluation() &&
+        heuristic != EvaluationResult::INFTY) {
+        preferred_operator_cache->store(state, preferred_operator_vector);
+    }
+    result.set_preferred_operators(move(preferred_operator_vector));
     assert(preferred_operators.empty());
 
     return result;
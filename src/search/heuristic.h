@@ -12,6 +12,7 @@
 
 class GlobalOperator;
 class GlobalState;
+class PreferredOperatorCache;
 class TaskProxy;
 
 namespace options {
@@ -41,6 +42,13 @@ class Heuristic : public ScalarEvaluator {
     */
     algorithms::OrderedSet<const GlobalOperator *> preferred_operators;
 
+    /*
+      Preferred operators of recently evaluated states. Only used if
+      enabled via enable_preferred_operator_cache() and if h values are
+      cached.
+    */
+    std::unique_ptr<PreferredOperatorCache> preferred_operator_cache;
+
 protected:
     /*
       Cache for saving h values
@@ -89,6 +97,21 @@ public:
         hset.insert(this);
     }
 
+    /*
+      Remember the preferred operators of evaluated states, so that
+      evaluating a state again with calculate_preferred set (as eager
+      search engines do when they expand a state) can reuse them
+      instead of computing the heuristic a second time. This has no
+      effect if the heuristic does not cache its estimates.
+    */
+    void enable_preferred_operator_cache();
+
+    /*
+      Print statistics collected during search. Search engines call
+      this once at the end of search for all heuristics they use.
+    */
+    virtual void print_statistics() const;
+
     static void add_options_to_parser(options::OptionParser &parser);
     static options::Options default_options();
 
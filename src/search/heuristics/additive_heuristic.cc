@@ -5,6 +5,8 @@
 #include "../plugin.h"
 #include "../task_tools.h"
 
+#include "../utils/memory.h"
+
 #include <cassert>
 #include <vector>
 
@@ -16,6 +18,12 @@ AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
       did_write_overflow_warning(false) {
     cout << "Initializing additive heuristic..." << endl;
+    int max_base_cost = get_max_base_cost();
+    if (max_base_cost <= MAX_BASE_COST_FOR_RADIX_QUEUE) {
+        cout << "Using radix queue for maximal operator cost "
+             << max_base_cost << endl;
+        radix_queue = utils::make_unique_ptr<RadixQueue<Proposition *>>();
+    }
 }
 
 AdditiveHeuristic::~AdditiveHeuristic() {
@@ -34,7 +42,8 @@ void AdditiveHeuristic::write_overflow_warning() {
 }
 
 // heuristic computation
-void AdditiveHeuristic::setup_exploration_queue() {
+template<typename Queue>
+void AdditiveHeuristic::setup_exploration_queue(Queue &queue) {
     queue.clear();
 
     for (size_t var = 0; var < propositions.size(); ++var) {
@@ -52,18 +61,21 @@ void AdditiveHeuristic::setup_exploration_queue() {
         op.cost = op.base_cost; // will be increased by precondition costs
 
         if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, &op);
+            enqueue_if_necessary(queue, op.effect, op.base_cost, &op);
     }
 }
 
-void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
+template<typename Queue>
+void AdditiveHeuristic::setup_exploration_queue_state(
+    Queue &queue, const State &state) {
     for (FactProxy fact : state) {
         Proposition *init_prop = get_proposition(fact);
-        enqueue_if_necessary(init_prop, 0, 0);
+        enqueue_if_necessary(queue, init_prop, 0, 0);
     }
 }
 
-void AdditiveHeuristic::relaxed_exploration() {
+template<typename Queue>
+void AdditiveHeuristic::relaxed_exploration(Queue &queue) {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
         pair<int, Proposition *> top_pair = queue.pop();
@@ -84,12 +96,19 @@ void AdditiveHeuristic::relaxed_exploration() {
             --unary_op->unsatisfied_preconditions;
             assert(unary_op->unsatisfied_preconditions >= 0);
             if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
+                enqueue_if_necessary(queue, unary_op->effect,
                                      unary_op->cost, unary_op);
         }
     }
 }
 
+template<typename Queue>
+void AdditiveHeuristic::compute_costs(Queue &queue, const State &state) {
+    setup_exploration_queue(queue);
+    setup_exploration_queue_state(queue, state);
+    relaxed_exploration(queue);
+}
+
 void AdditiveHeuristic::mark_preferred_operators(
     const State &state, Proposition *goal) {
     if (!goal->marked) { // Only consider each subgoal once.
@@ -114,9 +133,10 @@ void AdditiveHeuristic::mark_preferred_operators(
 }
 
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (radix_queue)
+        compute_costs(*radix_queue, state);
+    else
+        compute_costs(adaptive_queue, state);
 
     int total_cost = 0;
     for (size_t i = 0; i < goal_propositions.size(); ++i) {
@@ -8,6 +8,7 @@
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <memory>
 
 class State;
 
@@ -25,15 +26,35 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
      */
     static const int MAX_COST_VALUE = 100000000;
 
-    AdaptiveQueue<Proposition *> queue;
+    static const int MAX_BASE_COST_FOR_RADIX_QUEUE = 1;
+
+    AdaptiveQueue<Proposition *> adaptive_queue;
+    /*
+      For tasks with unit costs (and 0-cost axioms), we use a RadixQueue
+      instead of the adaptive queue. It never needs to be converted and
+      avoids virtual calls. Both queues pop propositions in order of
+      increasing cost, so the h^add values are the same. Propositions of
+      equal cost may be popped in a different order, for example after
+      the adaptive queue has switched to a heap. This can change the
+      best supporters, and hence the relaxed plans and preferred
+      operators of h^FF.
+    */
+    std::unique_ptr<RadixQueue<Proposition *>> radix_queue;
     bool did_write_overflow_warning;
 
-    void setup_exploration_queue();
-    void setup_exploration_queue_state(const State &state);
-    void relaxed_exploration();
+    template<typename Queue>
+    void setup_exploration_queue(Queue &queue);
+    template<typename Queue>
+    void setup_exploration_queue_state(Queue &queue, const State &state);
+    template<typename Queue>
+    void relaxed_exploration(Queue &queue);
+    template<typename Queue>
+    void compute_costs(Queue &queue, const State &state);
     void mark_preferred_operators(const State &state, Proposition *goal);
 
-    void enqueue_if_necessary(Proposition *prop, int cost, UnaryOperator *op) {
+    template<typename Queue>
+    void enqueue_if_necessary(
+        Queue &queue, Proposition *prop, int cost, UnaryOperator *op) {
         assert(cost >= 0);
         if (prop->cost == -1 || prop->cost > cost) {
             prop->cost = cost;
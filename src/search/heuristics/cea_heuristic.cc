@@ -8,6 +8,9 @@
 #include "../plugin.h"
 #include "../task_tools.h"
 
+#include "../utils/memory.h"
+
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -30,149 +33,84 @@ using namespace std;
      Keeps track of how many unachieved preconditions there still are,
      what the cost of enabling the transition are and things like that.
 
-   The following two design decisions might be worth revisiting:
-   - Each local problem keeps its own copy of the graph itself
-     (what is connected to what via which labels), even though this
-     is not necessary. The "static" graph info and the "dynamic" info
-     could be split, potentially saving quite a bit of memory.
-   - The graph is encoded with reference cycles: each transition knows
-     what its source node is, even though this is in a sense redundant
-     (the source must be the node which holds the transition), and
-     every node knows what its local problem is, which is similarly
-     redundant (the local problem must be the one that holds this node).
-     If we got rid of this, the main queue of the algorithm would need
-     (LocalProblem *, LocalProblemNode *) pairs rather than straight
-     node pointers, and the waiting lists would need to contain
-     (LocalProblemNode *, LocalTransition *) pairs rather than straight
-     transitions. So it's not clear if this would really save much, which
-     is why we do not currently do it.
+   All of these objects are stored in arenas (one vector per type) and
+   refer to each other by index. The nodes of a local problem and the
+   outgoing transitions of a node are contiguous. Node contexts are
+   stored in a further arena of values, and the waiting lists of all
+   nodes are linked lists in a shared arena of entries that is emptied
+   before every evaluation. Since local problems are created lazily,
+   the arenas can grow during an evaluation, so we must not keep
+   references to their elements across calls to get_local_problem().
+
+   Instead of resetting all local problems before every evaluation, we
+   increase an epoch counter. A local problem is set up for the current
+   evaluation iff its epoch equals the current one.
+
+   Each local problem still keeps its own copy of the graph itself
+   (what is connected to what via which labels), even though this is
+   not necessary. The "static" graph info and the "dynamic" info could
+   be split, potentially saving quite a bit of memory.
  */
 namespace cea_heuristic {
-struct LocalTransition {
-    LocalProblemNode *source;
-    LocalProblemNode *target;
-    const ValueTransitionLabel *label;
-    int action_cost;
-
-    int target_cost;
-    int unreached_conditions;
-
-    LocalTransition(
-        LocalProblemNode *source_, LocalProblemNode *target_,
-        const ValueTransitionLabel *label_, int action_cost_)
-        : source(source_), target(target_),
-          label(label_), action_cost(action_cost_),
-          target_cost(-1), unreached_conditions(-1) {
-        // target_cost and unreached_cost are initialized by
-        // expand_transition.
-    }
-
-    ~LocalTransition() {
-    }
-};
-
-
-struct LocalProblemNode {
-    // Attributes fixed during initialization.
-    LocalProblem *owner;
-    vector<LocalTransition> outgoing_transitions;
-
-    // Dynamic attributes (modified during heuristic computation).
-    int cost;
-    bool expanded;
-    vector<short> context;
-
-    LocalTransition *reached_by;
-    /* Before a node is expanded, reached_by is the "current best"
-       transition leading to this node. After a node is expanded, the
-       reached_by value of the parent is copied (unless the parent is
-       the initial node), so that reached_by is the *first* transition
-       on the optimal path to this node. This is useful for preferred
-       operators. (The two attributes used to be separate, but this
-       was a bit wasteful.) */
-
-    vector<LocalTransition *> waiting_list;
-
-    LocalProblemNode(LocalProblem *owner_, int context_size)
-        : owner(owner_),
-          cost(-1),
-          expanded(false),
-          context(context_size, -1),
-          reached_by(0) {
-    }
-
-    ~LocalProblemNode() {
-    }
-};
-
-struct LocalProblem {
-    int base_priority;
-    vector<LocalProblemNode> nodes;
-    vector<int> *context_variables;
-public:
-    LocalProblem()
-        : base_priority(-1) {
-    }
-
-    ~LocalProblem() {
-    }
-};
-
-LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
+int ContextEnhancedAdditiveHeuristic::get_local_problem(
     int var_no, int value) {
-    LocalProblem * &table_entry = local_problem_index[var_no][value];
-    if (!table_entry) {
+    int &table_entry =
+        local_problem_index[local_problem_offsets[var_no] + value];
+    if (table_entry == -1)
         table_entry = build_problem_for_variable(var_no);
-        local_problems.push_back(table_entry);
-    }
     return table_entry;
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
-    int var_no) const {
-    LocalProblem *problem = new LocalProblem;
+int ContextEnhancedAdditiveHeuristic::add_local_problem(
+    const vector<int> *context_variables, int num_values) {
+    int problem_id = local_problems.size();
+    int first_node = nodes.size();
+    int num_parents = context_variables->size();
+    local_problems.emplace_back(first_node, num_values, context_variables);
+    for (int value = 0; value < num_values; ++value) {
+        nodes.emplace_back(problem_id, contexts.size(), num_parents);
+        contexts.resize(contexts.size() + num_parents, -1);
+    }
+    return problem_id;
+}
 
+int ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
+    int var_no) {
     DomainTransitionGraph *dtg = transition_graphs[var_no];
-
-    problem->context_variables = &dtg->local_to_global_child;
-
-    int num_parents = problem->context_variables->size();
-    size_t num_values = task_proxy.get_variables()[var_no].get_domain_size();
-    problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
+    int num_values = task_proxy.get_variables()[var_no].get_domain_size();
+    int problem_id = add_local_problem(
+        &dtg->local_to_global_child, num_values);
+    int first_node = local_problems[problem_id].first_node;
 
     // Compile the DTG arcs into LocalTransition objects.
-    for (size_t value = 0; value < num_values; ++value) {
-        LocalProblemNode &node = problem->nodes[value];
+    for (int value = 0; value < num_values; ++value) {
+        int node_id = first_node + value;
+        LocalProblemNode &node = nodes[node_id];
+        node.first_transition = transitions.size();
         const ValueNode &dtg_node = dtg->nodes[value];
-        for (size_t i = 0; i < dtg_node.transitions.size(); ++i) {
-            const ValueTransition &dtg_trans = dtg_node.transitions[i];
-            int target_value = dtg_trans.target->value;
-            LocalProblemNode &target = problem->nodes[target_value];
+        for (const ValueTransition &dtg_trans : dtg_node.transitions) {
+            int target_id = first_node + dtg_trans.target->value;
             for (const ValueTransitionLabel &label : dtg_trans.labels) {
                 OperatorProxy op = label.is_axiom ?
                                    task_proxy.get_axioms()[label.op_id] :
                                    task_proxy.get_operators()[label.op_id];
-                LocalTransition trans(&node, &target, &label, op.get_cost());
-                node.outgoing_transitions.push_back(trans);
+                transitions.emplace_back(
+                    node_id, target_id, &label, op.get_cost());
             }
         }
+        node.num_transitions = transitions.size() - node.first_transition;
     }
-    return problem;
+    return problem_id;
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
-    LocalProblem *problem = new LocalProblem;
-
+int ContextEnhancedAdditiveHeuristic::build_problem_for_goal() {
     GoalsProxy goals_proxy = task_proxy.get_goals();
 
-    problem->context_variables = new vector<int>;
     for (FactProxy goal : goals_proxy)
-        problem->context_variables->push_back(goal.get_variable().get_id());
+        goal_variables.push_back(goal.get_variable().get_id());
 
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, goals_proxy.size()));
+    int problem_id = add_local_problem(&goal_variables, 2);
+    int first_node = local_problems[problem_id].first_node;
 
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < goals_proxy.size(); ++goal_no) {
@@ -180,14 +118,16 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
         goals.push_back(LocalAssignment(goal_no, goal_value));
     }
     vector<LocalAssignment> no_effects;
-    ValueTransitionLabel *label = new ValueTransitionLabel(0, true, goals, no_effects);
-    LocalTransition trans(&problem->nodes[0], &problem->nodes[1], label, 0);
-    problem->nodes[0].outgoing_transitions.push_back(trans);
-    return problem;
+    goal_label = utils::make_unique_ptr<ValueTransitionLabel>(
+        0, true, goals, no_effects);
+    LocalProblemNode &start = nodes[first_node];
+    start.first_transition = transitions.size();
+    start.num_transitions = 1;
+    transitions.emplace_back(first_node, first_node + 1, goal_label.get(), 0);
+    return problem_id;
 }
 
-int ContextEnhancedAdditiveHeuristic::get_priority(
-    LocalProblemNode *node) const {
+int ContextEnhancedAdditiveHeuristic::get_priority(int node_id) const {
     /* Nodes have both a "cost" and a "priority", which are related.
        The cost is an estimate of how expensive it is to reach this
        node. The "priority" is the lowest cost value in the overall
@@ -195,174 +135,216 @@ int ContextEnhancedAdditiveHeuristic::get_priority(
        essentially the sum of the cost and a local-problem-specific
        "base priority", which depends on where this local problem is
        needed for the overall computation. */
-    return node->owner->base_priority + node->cost;
+    const LocalProblemNode &node = nodes[node_id];
+    return node.base_priority + node.cost;
 }
 
 inline void ContextEnhancedAdditiveHeuristic::initialize_heap() {
     node_queue.clear();
 }
 
-inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
-    LocalProblemNode *node) {
-    node_queue.push(get_priority(node), node);
+inline void ContextEnhancedAdditiveHeuristic::add_to_heap(int node_id) {
+    node_queue.push(get_priority(node_id), node_id);
 }
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
-    const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    int problem_id) const {
+    return local_problems[problem_id].epoch == epoch;
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
-    LocalProblem *problem, int base_priority,
-    int start_value, const State &state) {
-    assert(problem->base_priority == -1);
-    problem->base_priority = base_priority;
-
-    for (auto &to_node : problem->nodes) {
+    int problem_id, int base_priority, int start_value, const State &state) {
+    assert(!is_local_problem_set_up(problem_id));
+    LocalProblem &problem = local_problems[problem_id];
+    problem.epoch = epoch;
+
+    int end_node = problem.first_node + problem.num_nodes;
+    for (int node_id = problem.first_node; node_id < end_node; ++node_id) {
+        LocalProblemNode &to_node = nodes[node_id];
+        to_node.base_priority = base_priority;
         to_node.expanded = false;
         to_node.cost = numeric_limits<int>::max();
-        to_node.waiting_list.clear();
-        to_node.reached_by = 0;
+        to_node.waiting_head = -1;
+        to_node.waiting_tail = -1;
+        to_node.reached_by = -1;
     }
 
-    LocalProblemNode *start = &problem->nodes[start_value];
-    start->cost = 0;
-    for (size_t i = 0; i < problem->context_variables->size(); ++i)
-        start->context[i] = state[(*problem->context_variables)[i]].get_value();
+    int start_id = problem.first_node + start_value;
+    LocalProblemNode &start = nodes[start_id];
+    start.cost = 0;
+    const vector<int> &context_variables = *problem.context_variables;
+    for (size_t i = 0; i < context_variables.size(); ++i)
+        contexts[start.context_start + i] =
+            state[context_variables[i]].get_value();
 
-    add_to_heap(start);
+    add_to_heap(start_id);
 }
 
-void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
-    LocalTransition *trans) {
-    if (!trans->unreached_conditions) {
-        LocalProblemNode *target = trans->target;
-        if (trans->target_cost < target->cost) {
-            target->cost = trans->target_cost;
-            target->reached_by = trans;
-            add_to_heap(target);
+inline void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
+    int trans_id) {
+    const LocalTransition &trans = transitions[trans_id];
+    if (!trans.unreached_conditions) {
+        LocalProblemNode &target = nodes[trans.target];
+        if (trans.target_cost < target.cost) {
+            target.cost = trans.target_cost;
+            target.reached_by = trans_id;
+            add_to_heap(trans.target);
         }
     }
 }
 
-void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
-    node->expanded = true;
+inline void ContextEnhancedAdditiveHeuristic::add_to_waiting_list(
+    int node_id, int trans_id) {
+    // Append to keep the order in which waiting transitions are fired.
+    int entry_id = waiting_entries.size();
+    waiting_entries.emplace_back(trans_id);
+    LocalProblemNode &node = nodes[node_id];
+    if (node.waiting_tail == -1)
+        node.waiting_head = entry_id;
+    else
+        waiting_entries[node.waiting_tail].next = entry_id;
+    node.waiting_tail = entry_id;
+}
+
+void ContextEnhancedAdditiveHeuristic::expand_node(int node_id) {
+    LocalProblemNode &node = nodes[node_id];
+    node.expanded = true;
     // Set context unless this was an initial node.
-    LocalTransition *reached_by = node->reached_by;
-    if (reached_by) {
-        LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
-        context = parent->context;
-        const vector<LocalAssignment> &precond = reached_by->label->precond;
-        for (size_t i = 0; i < precond.size(); ++i)
-            context[precond[i].local_var] = precond[i].value;
-        const vector<LocalAssignment> &effect = reached_by->label->effect;
-        for (size_t i = 0; i < effect.size(); ++i)
-            context[effect[i].local_var] = effect[i].value;
-        if (parent->reached_by)
-            node->reached_by = parent->reached_by;
+    int reached_by = node.reached_by;
+    if (reached_by != -1) {
+        const LocalTransition &trans = transitions[reached_by];
+        const LocalProblemNode &parent = nodes[trans.source];
+        short *context = &contexts[node.context_start];
+        copy(contexts.begin() + parent.context_start,
+             contexts.begin() + parent.context_start + node.context_size,
+             context);
+        for (const LocalAssignment &precond : trans.label->precond)
+            context[precond.local_var] = precond.value;
+        for (const LocalAssignment &effect : trans.label->effect)
+            context[effect.local_var] = effect.value;
+        if (parent.reached_by != -1)
+            node.reached_by = parent.reached_by;
     }
-    for (size_t i = 0; i < node->waiting_list.size(); ++i) {
-        LocalTransition *trans = node->waiting_list[i];
-        assert(trans->unreached_conditions);
-        --trans->unreached_conditions;
-        trans->target_cost += node->cost;
-        try_to_fire_transition(trans);
+    for (int entry_id = node.waiting_head; entry_id != -1;
+         entry_id = waiting_entries[entry_id].next) {
+        int trans_id = waiting_entries[entry_id].transition;
+        LocalTransition &trans = transitions[trans_id];
+        assert(trans.unreached_conditions);
+        --trans.unreached_conditions;
+        trans.target_cost += node.cost;
+        try_to_fire_transition(trans_id);
     }
-    node->waiting_list.clear();
+    node.waiting_head = -1;
+    node.waiting_tail = -1;
 }
 
 void ContextEnhancedAdditiveHeuristic::expand_transition(
-    LocalTransition *trans, const State &state) {
+    int trans_id, const State &state) {
     /* Called when the source of trans is reached by Dijkstra
        exploration. Try to compute cost for the target of the
        transition from the source cost, action cost, and set-up costs
        for the conditions on the label. The latter may yet be unknown,
        in which case we "subscribe" to the waiting list of the node
-       that will tell us the correct value. */
-
-    assert(trans->source->cost >= 0);
-    assert(trans->source->cost < numeric_limits<int>::max());
-
-    trans->target_cost = trans->source->cost + trans->action_cost;
-
-    if (trans->target->cost <= trans->target_cost) {
-        // Transition cannot find a shorter path to target.
-        return;
-    }
-
-    trans->unreached_conditions = 0;
+       that will tell us the correct value.
+
+       The caller has already set target_cost to the source cost plus
+       the action cost and checked that this is cheaper than the
+       current cost of the target. */
+
+    LocalTransition *trans = &transitions[trans_id];
+    const LocalProblemNode &source = nodes[trans->source];
+    assert(source.cost >= 0);
+    assert(source.cost < numeric_limits<int>::max());
+    int source_priority = get_priority(trans->source);
+    int context_start = source.context_start;
+    const vector<int> &parent_vars =
+        *local_problems[source.owner].context_variables;
     const vector<LocalAssignment> &precond = trans->label->precond;
 
-    vector<LocalAssignment>::const_iterator
-        curr_precond = precond.begin(),
-        last_precond = precond.end();
-
-    vector<short>::const_iterator context = trans->source->context.begin();
-    vector<int>::const_iterator parent_vars =
-        trans->source->owner->context_variables->begin();
+    trans->unreached_conditions = 0;
 
-    for (; curr_precond != last_precond; ++curr_precond) {
-        int local_var = curr_precond->local_var;
-        int current_val = context[local_var];
-        int precond_value = curr_precond->value;
+    for (const LocalAssignment &assignment : precond) {
+        int local_var = assignment.local_var;
+        int current_val = contexts[context_start + local_var];
+        int precond_value = assignment.value;
         int precond_var_no = parent_vars[local_var];
 
         if (current_val == precond_value)
             continue;
 
-        LocalProblem *subproblem = get_local_problem(
-            precond_var_no, current_val);
+        int subproblem = local_problem_index[
+            local_problem_offsets[precond_var_no] + current_val];
+        if (subproblem == -1) {
+            subproblem = get_local_problem(precond_var_no, current_val);
+            // Building the local problem may have moved the arenas.
+            trans = &transitions[trans_id];
+        }
 
         if (!is_local_problem_set_up(subproblem)) {
             set_up_local_problem(
-                subproblem, get_priority(trans->source), current_val, state);
+                subproblem, source_priority, current_val, state);
         }
 
-        LocalProblemNode *cond_node = &subproblem->nodes[precond_value];
-        if (cond_node->expanded) {
-            trans->target_cost += cond_node->cost;
-            if (trans->target->cost <= trans->target_cost) {
+        int cond_node_id = local_problems[subproblem].first_node + precond_value;
+        const LocalProblemNode &cond_node = nodes[cond_node_id];
+        if (cond_node.expanded) {
+            trans->target_cost += cond_node.cost;
+            if (nodes[trans->target].cost <= trans->target_cost) {
                 // Transition cannot find a shorter path to target.
                 return;
             }
         } else {
-            cond_node->waiting_list.push_back(trans);
+            add_to_waiting_list(cond_node_id, trans_id);
             ++trans->unreached_conditions;
         }
     }
-    try_to_fire_transition(trans);
+    try_to_fire_transition(trans_id);
 }
 
 int ContextEnhancedAdditiveHeuristic::compute_costs(const State &state) {
     while (!node_queue.empty()) {
-        pair<int, LocalProblemNode *> top_pair = node_queue.pop();
+        pair<int, int> top_pair = node_queue.pop();
         int curr_priority = top_pair.first;
-        LocalProblemNode *node = top_pair.second;
+        int node_id = top_pair.second;
 
-        assert(is_local_problem_set_up(node->owner));
-        if (get_priority(node) < curr_priority)
+        assert(is_local_problem_set_up(nodes[node_id].owner));
+        if (get_priority(node_id) < curr_priority)
             continue;
-        if (node == goal_node)
-            return node->cost;
-
-        assert(get_priority(node) == curr_priority);
-        expand_node(node);
-        for (auto &transition : node->outgoing_transitions)
-            expand_transition(&transition, state);
+        if (node_id == goal_node)
+            return nodes[node_id].cost;
+
+        assert(get_priority(node_id) == curr_priority);
+        expand_node(node_id);
+        const LocalProblemNode &node = nodes[node_id];
+        int source_cost = node.cost;
+        int first_transition = node.first_transition;
+        int end_transition = first_transition + node.num_transitions;
+        for (int trans_id = first_transition; trans_id < end_transition;
+             ++trans_id) {
+            /* Most transitions cannot find a shorter path to their
+               target, so we test this here before calling
+               expand_transition. The arenas may grow in
+               expand_transition, so we must not keep references. */
+            LocalTransition &trans = transitions[trans_id];
+            trans.target_cost = source_cost + trans.action_cost;
+            if (trans.target_cost < nodes[trans.target].cost)
+                expand_transition(trans_id, state);
+        }
     }
     return DEAD_END;
 }
 
 void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
-    LocalProblem *problem, LocalProblemNode *node, const State &state) {
-    assert(node->cost >= 0 && node->cost < numeric_limits<int>::max());
-    LocalTransition *first_on_path = node->reached_by;
-    if (first_on_path) {
-        node->reached_by = 0; // Clear to avoid revisiting this node later.
-        if (first_on_path->target_cost == first_on_path->action_cost) {
+    int problem_id, int node_id, const State &state) {
+    LocalProblemNode &node = nodes[node_id];
+    assert(node.cost >= 0 && node.cost < numeric_limits<int>::max());
+    int first_on_path = node.reached_by;
+    if (first_on_path != -1) {
+        node.reached_by = -1; // Clear to avoid revisiting this node later.
+        const LocalTransition &trans = transitions[first_on_path];
+        const ValueTransitionLabel &label = *trans.label;
+        if (trans.target_cost == trans.action_cost) {
             // Transition possibly applicable.
-            const ValueTransitionLabel &label = *first_on_path->label;
             OperatorProxy op = label.is_axiom ?
                                task_proxy.get_axioms()[label.op_id] :
                                task_proxy.get_operators()[label.op_id];
@@ -374,16 +356,18 @@ void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
             }
         } else {
             // Recursively compute helpful transitions for preconditions.
-            int *context_vars = &*problem->context_variables->begin();
-            for (const auto &assignment : first_on_path->label->precond) {
+            const vector<int> &context_vars =
+                *local_problems[problem_id].context_variables;
+            for (const auto &assignment : label.precond) {
                 int precond_value = assignment.value;
                 int local_var = assignment.local_var;
                 int precond_var_no = context_vars[local_var];
                 if (state[precond_var_no].get_value() == precond_value)
                     continue;
-                LocalProblem *subproblem = get_local_problem(
+                int subproblem = get_local_problem(
                     precond_var_no, state[precond_var_no].get_value());
-                LocalProblemNode *subnode = &subproblem->nodes[precond_value];
+                int subnode =
+                    local_problems[subproblem].first_node + precond_value;
                 mark_helpful_transitions(subproblem, subnode, state);
             }
         }
@@ -393,9 +377,14 @@ void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
 int ContextEnhancedAdditiveHeuristic::compute_heuristic(const GlobalState &g_state) {
     const State state = convert_global_state(g_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    waiting_entries.clear();
+    if (epoch == numeric_limits<int>::max()) {
+        for (LocalProblem &problem : local_problems)
+            problem.epoch = -1;
+        epoch = 0;
+    } else {
+        ++epoch;
+    }
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
@@ -410,30 +399,25 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(const GlobalState &g_sta
 ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     const Options &opts)
     : Heuristic(opts),
-      min_action_cost(get_min_operator_cost(task_proxy)) {
+      min_action_cost(get_min_operator_cost(task_proxy)),
+      epoch(0) {
     cout << "Initializing context-enhanced additive heuristic..." << endl;
 
     DTGFactory factory(task_proxy, true, [](int, int) {return false; });
     transition_graphs = factory.build_dtgs();
 
     goal_problem = build_problem_for_goal();
-    goal_node = &goal_problem->nodes[1];
+    goal_node = local_problems[goal_problem].first_node + 1;
 
     VariablesProxy vars = task_proxy.get_variables();
-    local_problem_index.resize(vars.size());
-    for (VariableProxy var : vars)
-        local_problem_index[var.get_id()].resize(var.get_domain_size(), 0);
+    for (VariableProxy var : vars) {
+        local_problem_offsets.push_back(local_problem_index.size());
+        local_problem_index.resize(
+            local_problem_index.size() + var.get_domain_size(), -1);
+    }
 }
 
 ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
-    if (goal_problem) {
-        delete goal_problem->context_variables;
-        delete goal_problem->nodes[0].outgoing_transitions[0].label;
-    }
-    delete goal_problem;
-
-    for (LocalProblem *problem : local_problems)
-        delete problem;
     for (DomainTransitionGraph *dtg : transition_graphs)
         delete dtg;
 }
@@ -5,44 +5,156 @@
 #include "../heuristic.h"
 #include "../priority_queue.h"
 
+#include <memory>
 #include <vector>
 
 class State;
 
 namespace cea_heuristic {
-struct LocalProblem;
-struct LocalProblemNode;
-struct LocalTransition;
+/*
+  All local problems, nodes and transitions live in arenas (vectors)
+  owned by the heuristic and refer to each other by index. See the
+  implementation notes in cea_heuristic.cc.
+*/
+struct LocalTransition {
+    // Attributes fixed during initialization.
+    int source;
+    int target;
+    const ValueTransitionLabel *label;
+    int action_cost;
+
+    // Dynamic attributes (modified during heuristic computation).
+    int target_cost;
+    int unreached_conditions;
+
+    LocalTransition(
+        int source, int target, const ValueTransitionLabel *label,
+        int action_cost)
+        : source(source), target(target), label(label),
+          action_cost(action_cost), target_cost(-1),
+          unreached_conditions(-1) {
+        // target_cost and unreached_conditions are initialized by
+        // expand_transition.
+    }
+};
+
+struct LocalProblemNode {
+    // Attributes fixed during initialization.
+    int owner;
+    int first_transition;
+    int num_transitions;
+    // Position and size of the context in the context arena.
+    int context_start;
+    int context_size;
+
+    // Dynamic attributes (modified during heuristic computation).
+    /* Copy of the base priority of the owning local problem. Keeping
+       it here saves a lookup of the owner whenever we compute the
+       priority of a node. */
+    int base_priority;
+    int cost;
+    bool expanded;
+
+    int reached_by;
+    /* Before a node is expanded, reached_by is the "current best"
+       transition leading to this node. After a node is expanded, the
+       reached_by value of the parent is copied (unless the parent is
+       the initial node), so that reached_by is the *first* transition
+       on the optimal path to this node. This is useful for preferred
+       operators. (The two attributes used to be separate, but this
+       was a bit wasteful.) */
+
+    // First and last entry of the waiting list in the waiting arena.
+    int waiting_head;
+    int waiting_tail;
+
+    LocalProblemNode(int owner, int context_start, int context_size)
+        : owner(owner),
+          first_transition(-1),
+          num_transitions(0),
+          context_start(context_start),
+          context_size(context_size),
+          base_priority(-1),
+          cost(-1),
+          expanded(false),
+          reached_by(-1),
+          waiting_head(-1),
+          waiting_tail(-1) {
+    }
+};
+
+struct LocalProblem {
+    int first_node;
+    int num_nodes;
+    const std::vector<int> *context_variables;
+
+    // The problem is set up iff epoch equals the heuristic's epoch.
+    int epoch;
+
+    LocalProblem(int first_node, int num_nodes,
+                 const std::vector<int> *context_variables)
+        : first_node(first_node),
+          num_nodes(num_nodes),
+          context_variables(context_variables),
+          epoch(-1) {
+    }
+};
+
+struct WaitingEntry {
+    int transition;
+    int next;
+
+    explicit WaitingEntry(int transition)
+        : transition(transition), next(-1) {
+    }
+};
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
     std::vector<DomainTransitionGraph *> transition_graphs;
-    std::vector<LocalProblem *> local_problems;
-    std::vector<std::vector<LocalProblem *>> local_problem_index;
-    LocalProblem *goal_problem;
-    LocalProblemNode *goal_node;
+
+    std::vector<LocalProblem> local_problems;
+    std::vector<LocalProblemNode> nodes;
+    std::vector<LocalTransition> transitions;
+    std::vector<short> contexts;
+    /* Entries of all waiting lists. The arena is emptied for every
+       evaluation. */
+    std::vector<WaitingEntry> waiting_entries;
+
+    /* Index of the local problem for each variable and start value.
+       The entries for variable v start at local_problem_offsets[v]. */
+    std::vector<int> local_problem_index;
+    std::vector<int> local_problem_offsets;
+    std::vector<int> goal_variables;
+    std::unique_ptr<ValueTransitionLabel> goal_label;
+    int goal_problem;
+    int goal_node;
     int min_action_cost;
+    int epoch;
 
-    AdaptiveQueue<LocalProblemNode *> node_queue;
+    AdaptiveQueue<int> node_queue;
 
-    LocalProblem *get_local_problem(int var_no, int value);
-    LocalProblem *build_problem_for_variable(int var_no) const;
-    LocalProblem *build_problem_for_goal() const;
+    int get_local_problem(int var_no, int value);
+    int build_problem_for_variable(int var_no);
+    int build_problem_for_goal();
+    int add_local_problem(const std::vector<int> *context_variables,
+                          int num_values);
 
-    int get_priority(LocalProblemNode *node) const;
+    int get_priority(int node_id) const;
     void initialize_heap();
-    void add_to_heap(LocalProblemNode *node);
+    void add_to_heap(int node_id);
 
-    bool is_local_problem_set_up(const LocalProblem *problem) const;
-    void set_up_local_problem(LocalProblem *problem, int base_priority,
+    bool is_local_problem_set_up(int problem_id) const;
+    void set_up_local_problem(int problem_id, int base_priority,
                               int start_value, const State &state);
 
-    void try_to_fire_transition(LocalTransition *trans);
-    void expand_node(LocalProblemNode *node);
-    void expand_transition(LocalTransition *trans, const State &state);
+    void try_to_fire_transition(int trans_id);
+    void add_to_waiting_list(int node_id, int trans_id);
+    void expand_node(int node_id);
+    void expand_transition(int trans_id, const State &state);
 
     int compute_costs(const State &state);
     void mark_helpful_transitions(
-        LocalProblem *problem, LocalProblemNode *node, const State &state);
+        int problem_id, int node_id, const State &state);
     // Clears "reached_by" of visited nodes as a side effect to avoid
     // recursing to the same node again.
 protected:
@@ -1,14 +1,14 @@
 #include "cg_cache.h"
 
+#include "../abstract_task.h"
 #include "../causal_graph.h"
 #include "../task_proxy.h"
 
-#include "../utils/collections.h"
-#include "../utils/math.h"
-
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <vector>
 
 using namespace std;
@@ -16,10 +16,32 @@ using namespace std;
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
 
-CGCache::CGCache(TaskProxy &task_proxy) : task_proxy(task_proxy) {
+/*
+  Caches currently in use, indexed by task and budget. We only hold
+  weak pointers, so a cache is destroyed together with the last
+  heuristic using it and a new task allocated at the same address
+  never sees stale entries.
+*/
+static map<pair<const AbstractTask *, int>, weak_ptr<CGCache>> shared_caches;
+
+CGCache::CGCache(const shared_ptr<AbstractTask> &task, int max_cache_size)
+    : task(task),
+      task_proxy(*task),
+      max_cache_size(max_cache_size),
+      slots(16, -1),
+      slot_mask(slots.size() - 1),
+      clock_hand(0),
+      num_users(0),
+      num_lookups(0),
+      num_hits(0),
+      num_stores(0),
+      num_evictions(0) {
     cout << "Initializing heuristic cache... " << flush;
 
     int var_count = task_proxy.get_variables().size();
+    domain_sizes.reserve(var_count);
+    for (VariableProxy var : task_proxy.get_variables())
+        domain_sizes.push_back(var.get_domain_size());
     const CausalGraph &cg = task_proxy.get_causal_graph();
 
     // Compute inverted causal graph.
@@ -50,18 +72,10 @@ CGCache::CGCache(TaskProxy &task_proxy) : task_proxy(task_proxy) {
                               depends_on[var].end());
     }
 
-    cache.resize(var_count);
-    helpful_transition_cache.resize(var_count);
-
-    for (int var = 0; var < var_count; ++var) {
-        int required_cache_size = compute_required_cache_size(
-            var, depends_on[var]);
-        if (required_cache_size != -1) {
-            //  cout << "Cache for var " << var << ": "
-            //       << required_cache_size << " entries" << endl;
-            cache[var].resize(required_cache_size, NOT_COMPUTED);
-            helpful_transition_cache[var].resize(required_cache_size, 0);
-        }
+    cacheable.resize(var_count, false);
+    if (max_cache_size > 0) {
+        for (int var = 0; var < var_count; ++var)
+            cacheable[var] = has_packable_key(var);
     }
 
     cout << "done!" << endl;
@@ -70,63 +84,181 @@ CGCache::CGCache(TaskProxy &task_proxy) : task_proxy(task_proxy) {
 CGCache::~CGCache() {
 }
 
-int CGCache::compute_required_cache_size(
-    int var_id, const vector<int> &depends_on) const {
+bool CGCache::has_packable_key(int var) const {
     /*
-      Compute the size of the cache required for variable with id "var_id",
-      which depends on the variables in "depends_on". Requires that the caches
-      for all variables in "depends_on" have already been allocated. Returns -1
-      if the variable cannot be cached because the required cache size would be
-      too large.
+      Test if the number of possible keys for var, i.e., the product
+      of dom(var) * (dom(var) - 1) and the domain sizes of all
+      ancestors of var, fits into 64 bits.
     */
+    const uint64_t max_key = numeric_limits<uint64_t>::max();
+    uint64_t var_domain = domain_sizes[var];
+    uint64_t num_keys = var_domain * (var_domain - 1);
+    for (int dep_var : depends_on[var]) {
+        uint64_t dep_domain = domain_sizes[dep_var];
+        if (num_keys > max_key / dep_domain)
+            return false;
+        num_keys *= dep_domain;
+    }
+    return true;
+}
 
-    const int MAX_CACHE_SIZE = 1000000;
+uint64_t CGCache::get_key(int var, const State &state,
+                          int from_val, int to_val) const {
+    assert(is_cached(var));
+    assert(from_val != to_val);
+    uint64_t key = from_val;
+    uint64_t multiplier = domain_sizes[var];
+    for (int dep_var : depends_on[var]) {
+        key += state[dep_var].get_value() * multiplier;
+        multiplier *= domain_sizes[dep_var];
+    }
+    if (to_val > from_val)
+        --to_val;
+    key += to_val * multiplier;
+    return key;
+}
+
+size_t CGCache::get_home_slot(int var, uint64_t key) const {
+    uint64_t hash = (key + var * 0x9e3779b97f4a7c15ULL) * 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 31;
+    return hash & slot_mask;
+}
 
-    VariablesProxy variables = task_proxy.get_variables();
-    int var_domain = variables[var_id].get_domain_size();
-    if (!utils::is_product_within_limit(var_domain, var_domain - 1,
-                                        MAX_CACHE_SIZE))
-        return -1;
+size_t CGCache::find_slot(int var, uint64_t key) const {
+    /*
+      Return the slot holding the entry for (var, key) or the empty
+      slot where such an entry would have to be inserted.
+    */
+    size_t slot = get_home_slot(var, key);
+    while (slots[slot] != -1) {
+        const Entry &entry = entries[slots[slot]];
+        if (entry.key == key && entry.var == var)
+            break;
+        slot = (slot + 1) & slot_mask;
+    }
+    return slot;
+}
 
-    int required_size = var_domain * (var_domain - 1);
+void CGCache::erase_slot(size_t slot) {
+    /*
+      Backward-shift deletion: move later entries of the probe
+      sequence into the gap unless this would put them before their
+      home slot. This keeps lookups correct without tombstones.
+    */
+    size_t gap = slot;
+    size_t next = slot;
+    while (true) {
+        next = (next + 1) & slot_mask;
+        if (slots[next] == -1)
+            break;
+        const Entry &entry = entries[slots[next]];
+        size_t home = get_home_slot(entry.var, entry.key);
+        // Distance from home to next and from gap to next (cyclically).
+        if (((next - home) & slot_mask) >= ((next - gap) & slot_mask)) {
+            slots[gap] = slots[next];
+            gap = next;
+        }
+    }
+    slots[gap] = -1;
+}
 
-    for (int depend_var_id : depends_on) {
-        int depend_var_domain = variables[depend_var_id].get_domain_size();
+void CGCache::grow_slots() {
+    vector<int> old_slots(slots.size() * 2, -1);
+    old_slots.swap(slots);
+    slot_mask = slots.size() - 1;
+    for (int id : old_slots) {
+        if (id != -1) {
+            const Entry &entry = entries[id];
+            slots[find_slot(entry.var, entry.key)] = id;
+        }
+    }
+}
 
-        /*
-          If var depends on a variable var_i that is not cached, then
-          it cannot be cached. This is possible even if var would have
-          an acceptable cache size because the domain of var_i
-          contributes quadratically to its own cache size but only
-          linearly to the cache size of var.
-        */
-        if (cache[depend_var_id].empty())
-            return -1;
+int CGCache::allocate_entry() {
+    if (static_cast<int>(entries.size()) < max_cache_size) {
+        entries.emplace_back();
+        return entries.size() - 1;
+    }
+    /*
+      Advance the clock hand to the first entry that has not been
+      referenced since the hand last passed it, clearing the reference
+      bits on the way. This terminates after at most one round.
+    */
+    while (entries[clock_hand].referenced) {
+        entries[clock_hand].referenced = false;
+        clock_hand = (clock_hand + 1) % max_cache_size;
+    }
+    int victim = clock_hand;
+    clock_hand = (clock_hand + 1) % max_cache_size;
+    const Entry &entry = entries[victim];
+    erase_slot(find_slot(entry.var, entry.key));
+    ++num_evictions;
+    return victim;
+}
 
-        if (!utils::is_product_within_limit(required_size, depend_var_domain,
-                                            MAX_CACHE_SIZE))
-            return -1;
+int CGCache::lookup(int var, const State &state, int from_val, int to_val,
+                    int &helpful_transition) {
+    ++num_lookups;
+    int id = slots[find_slot(var, get_key(var, state, from_val, to_val))];
+    if (id == -1)
+        return NOT_COMPUTED;
+    ++num_hits;
+    Entry &entry = entries[id];
+    entry.referenced = true;
+    helpful_transition = entry.helpful_transition;
+    return entry.cost;
+}
 
-        required_size *= depend_var_domain;
+void CGCache::store(int var, const State &state, int from_val, int to_val,
+                    int cost, int helpful_transition) {
+    uint64_t key = get_key(var, state, from_val, to_val);
+    size_t slot = find_slot(var, key);
+    int id = slots[slot];
+    if (id == -1) {
+        id = allocate_entry();
+        if (2 * entries.size() > slots.size())
+            grow_slots();
+        /* Allocating or growing may have moved slots around, so we
+           have to search for the insertion point again. */
+        slot = find_slot(var, key);
+        slots[slot] = id;
     }
+    Entry &entry = entries[id];
+    entry.key = key;
+    entry.var = var;
+    entry.cost = cost;
+    entry.helpful_transition = helpful_transition;
+    entry.referenced = false;
+    ++num_stores;
+}
 
-    return required_size;
+void CGCache::print_statistics() const {
+    long long num_misses = num_lookups - num_hits;
+    cout << "CG cache lookups: " << num_lookups << endl;
+    cout << "CG cache hits: " << num_hits << endl;
+    cout << "CG cache misses: " << num_misses << endl;
+    if (num_lookups > 0) {
+        cout << "CG cache hit rate: "
+             << 100.0 * num_hits / num_lookups << "%" << endl;
+    }
+    cout << "CG cache stores: " << num_stores << endl;
+    cout << "CG cache evictions: " << num_evictions << endl;
+    cout << "CG cache entries: " << entries.size()
+         << " (budget: " << max_cache_size << ")" << endl;
+    cout << "CG cache users: " << num_users << endl;
 }
 
-int CGCache::get_index(int var, const State &state,
-                       int from_val, int to_val) const {
-    assert(is_cached(var));
-    assert(from_val != to_val);
-    int index = from_val;
-    int multiplier = task_proxy.get_variables()[var].get_domain_size();
-    for (int dep_var : depends_on[var]) {
-        index += state[dep_var].get_value() * multiplier;
-        multiplier *= task_proxy.get_variables()[dep_var].get_domain_size();
+shared_ptr<CGCache> get_shared_cache(
+    const shared_ptr<AbstractTask> &task, int max_cache_size) {
+    pair<const AbstractTask *, int> id = make_pair(task.get(), max_cache_size);
+    shared_ptr<CGCache> cache = shared_caches[id].lock();
+    if (cache) {
+        cout << "Sharing existing heuristic cache." << endl;
+    } else {
+        cache = make_shared<CGCache>(task, max_cache_size);
+        shared_caches[id] = cache;
     }
-    if (to_val > from_val)
-        --to_val;
-    index += to_val * multiplier;
-    assert(utils::in_bounds(index, cache[var]));
-    return index;
+    cache->add_user();
+    return cache;
 }
 }
@@ -3,52 +3,110 @@
 
 #include "../task_proxy.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
-struct ValueTransitionLabel;
+class AbstractTask;
 
 namespace cg_heuristic {
+/*
+  Cache for the transition costs computed by the causal graph
+  heuristic.
+
+  The cost of changing a variable from one value to another only
+  depends on the values of its ancestors in the (reduced) causal
+  graph. An entry is identified by the variable and a key that packs
+  the source value, the ancestor values and the target value into a
+  64-bit mixed-radix number. Variables for which no such packing
+  exists are not cached.
+
+  The cache holds at most max_cache_size entries. When it is full,
+  entries are evicted with the CLOCK algorithm (an approximation of
+  least recently used). Evicted entries are simply recomputed on
+  demand, so the budget only trades time for memory.
+
+  Helpful transitions are stored as ids of labels, which are numbered
+  in the order in which they appear in the domain transition graph of
+  the variable. This makes the cache independent of the domain
+  transition graph objects of a given heuristic, so that several
+  heuristics using identically built graphs for the same task can
+  share one cache (see get_shared_cache).
+*/
 class CGCache {
+    struct Entry {
+        std::uint64_t key;
+        int var;
+        int cost;
+        int helpful_transition;
+        bool referenced;
+    };
+
+    std::shared_ptr<AbstractTask> task;
     TaskProxy task_proxy;
-    std::vector<std::vector<int>> cache;
-    std::vector<std::vector<ValueTransitionLabel *>> helpful_transition_cache;
+    int max_cache_size;
+    std::vector<int> domain_sizes;
     std::vector<std::vector<int>> depends_on;
+    std::vector<bool> cacheable;
+
+    std::vector<Entry> entries;
+    /*
+      Open-addressing hash table with linear probing that maps
+      (var, key) pairs to entries. Empty slots hold -1. The table
+      grows with the number of entries and is kept at most half full.
+    */
+    std::vector<int> slots;
+    std::size_t slot_mask;
+    int clock_hand;
+
+    int num_users;
+    long long num_lookups;
+    long long num_hits;
+    long long num_stores;
+    long long num_evictions;
 
-    int get_index(int var, const State &state, int from_val, int to_val) const;
-    int compute_required_cache_size(int var_id,
-                                    const std::vector<int> &depends_on) const;
+    bool has_packable_key(int var) const;
+    std::uint64_t get_key(int var, const State &state,
+                          int from_val, int to_val) const;
+    std::size_t get_home_slot(int var, std::uint64_t key) const;
+    std::size_t find_slot(int var, std::uint64_t key) const;
+    void erase_slot(std::size_t slot);
+    void grow_slots();
+    int allocate_entry();
 public:
     static const int NOT_COMPUTED = -2;
 
-    explicit CGCache(TaskProxy &task_proxy);
+    CGCache(const std::shared_ptr<AbstractTask> &task, int max_cache_size);
     ~CGCache();
 
     bool is_cached(int var) const {
-        return !cache[var].empty();
+        return cacheable[var];
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
-    }
-
-    void store(int var, const State &state,
-               int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+    /*
+      Return the cached cost of changing var from from_val to to_val
+      in the given state, or NOT_COMPUTED if there is no entry. On a
+      hit, helpful_transition is set to the id of the stored label.
+    */
+    int lookup(int var, const State &state, int from_val, int to_val,
+               int &helpful_transition);
+    void store(int var, const State &state, int from_val, int to_val,
+               int cost, int helpful_transition);
 
-    ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
+    void add_user() {
+        ++num_users;
     }
 
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    void print_statistics() const;
 };
+
+/*
+  Return a cache for the given task and budget, creating it if no
+  heuristic currently uses such a cache.
+*/
+extern std::shared_ptr<CGCache> get_shared_cache(
+    const std::shared_ptr<AbstractTask> &task, int max_cache_size);
 }
 
 #endif
@@ -10,17 +10,17 @@
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <memory>
 #include <vector>
 
 using namespace std;
 
-// TODO: Turn this into an option and check its impact.
-#define USE_CACHE true
-
 namespace cg_heuristic {
 CGHeuristic::CGHeuristic(const Options &opts)
     : Heuristic(opts),
-      cache(new CGCache(task_proxy)), cache_hits(0), cache_misses(0),
+      cache(opts.get<bool>("shared_cache") ?
+            get_shared_cache(task, opts.get<int>("max_cache_size")) :
+            make_shared<CGCache>(task, opts.get<int>("max_cache_size"))),
       helpful_transition_extraction_counter(0),
       min_action_cost(get_min_operator_cost(task_proxy)) {
     cout << "Initializing causal graph heuristic..." << endl;
@@ -34,6 +34,7 @@ CGHeuristic::CGHeuristic(const Options &opts)
         [](int dtg_var, int cond_var) {return dtg_var <= cond_var; };
     DTGFactory factory(task_proxy, false, pruning_condition);
     transition_graphs = factory.build_dtgs();
+    number_labels();
 }
 
 CGHeuristic::~CGHeuristic() {
@@ -43,10 +44,31 @@ CGHeuristic::~CGHeuristic() {
         delete transition_graphs[i];
 }
 
+void CGHeuristic::number_labels() {
+    labels_by_id.resize(transition_graphs.size());
+    for (DomainTransitionGraph *dtg : transition_graphs) {
+        vector<ValueTransitionLabel *> &labels = labels_by_id[dtg->var];
+        for (ValueNode &node : dtg->nodes) {
+            for (ValueTransition &transition : node.transitions) {
+                for (ValueTransitionLabel &label : transition.labels) {
+                    label_ids[&label] = labels.size();
+                    labels.push_back(&label);
+                }
+            }
+        }
+    }
+}
+
 bool CGHeuristic::dead_ends_are_reliable() const {
     return false;
 }
 
+void CGHeuristic::print_statistics() const {
+    Heuristic::print_statistics();
+    cout << "Cache of " << get_description() << ":" << endl;
+    cache->print_statistics();
+}
+
 int CGHeuristic::compute_heuristic(const GlobalState &g_state) {
     const State state = convert_global_state(g_state);
     setup_domain_transition_graphs();
@@ -88,15 +110,13 @@ int CGHeuristic::get_transition_cost(const State &state,
     int var_no = dtg->var;
 
     // Check cache.
-    bool use_the_cache = USE_CACHE && cache->is_cached(var_no);
+    bool use_the_cache = cache->is_cached(var_no);
     if (use_the_cache) {
-        int cached_val = cache->lookup(var_no, state, start_val, goal_val);
-        if (cached_val != CGCache::NOT_COMPUTED) {
-            ++cache_hits;
+        int helpful_id;
+        int cached_val = cache->lookup(
+            var_no, state, start_val, goal_val, helpful_id);
+        if (cached_val != CGCache::NOT_COMPUTED)
             return cached_val;
-        }
-    } else {
-        ++cache_misses;
     }
 
     ValueNode *start = &dtg->nodes[start_val];
@@ -210,9 +230,8 @@ int CGHeuristic::get_transition_cost(const State &state,
             ValueTransitionLabel *helpful = start->helpful_transitions[val];
             // We should have a helpful transition iff distance is infinite.
             assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+            int helpful_id = helpful ? label_ids[helpful] : -1;
+            cache->store(var_no, state, start_val, val, distance, helpful_id);
         }
     }
 
@@ -250,14 +269,25 @@ void CGHeuristic::mark_helpful_transitions(const State &state,
     dtg->last_helpful_transition_extraction_time =
         helpful_transition_extraction_counter;
 
-    ValueTransitionLabel *helpful;
-    int cost;
+    ValueTransitionLabel *helpful = 0;
+    int cost = CGCache::NOT_COMPUTED;
     // Check cache.
-    if (USE_CACHE && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
-        assert(helpful);
-    } else {
+    if (cache->is_cached(var_no)) {
+        int helpful_id;
+        cost = cache->lookup(var_no, state, from, to, helpful_id);
+        if (cost != CGCache::NOT_COMPUTED) {
+            assert(helpful_id != -1);
+            helpful = labels_by_id[var_no][helpful_id];
+        } else {
+            /*
+              The entry has been evicted since it was computed for
+              this state. Recomputing it fills the data of the start
+              node, which we use below.
+            */
+            get_transition_cost(state, dtg, from, to);
+        }
+    }
+    if (cost == CGCache::NOT_COMPUTED) {
         ValueNode *start_node = &dtg->nodes[from];
         assert(!start_node->helpful_transitions.empty());
         helpful = start_node->helpful_transitions[to];
@@ -295,6 +325,18 @@ static Heuristic *_parse(OptionParser &parser) {
     parser.document_property("safe", "no");
     parser.document_property("preferred operators", "yes");
 
+    parser.add_option<int>(
+        "max_cache_size",
+        "maximum number of transition costs kept in the cache. When the "
+        "cache is full, entries are evicted with the CLOCK algorithm. "
+        "Each entry takes about 40 bytes. Use 0 to disable caching.",
+        "1000000",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>(
+        "shared_cache",
+        "share the cache with all other causal graph heuristics that use "
+        "the same task and cache size",
+        "true");
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -4,13 +4,16 @@
 #include "../heuristic.h"
 #include "../priority_queue.h"
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class DomainTransitionGraph;
 class GlobalState;
 class State;
 struct ValueNode;
+struct ValueTransitionLabel;
 
 namespace cg_heuristic {
 class CGCache;
@@ -19,14 +22,20 @@ class CGHeuristic : public Heuristic {
     std::vector<AdaptiveQueue<ValueNode *> *> prio_queues;
     std::vector<DomainTransitionGraph *> transition_graphs;
 
-    CGCache *cache;
-    int cache_hits;
-    int cache_misses;
+    std::shared_ptr<CGCache> cache;
+    /*
+      The cache refers to helpful transitions by label ids. Labels are
+      numbered per variable in the order in which they appear in its
+      domain transition graph.
+    */
+    std::vector<std::vector<ValueTransitionLabel *>> labels_by_id;
+    std::unordered_map<const ValueTransitionLabel *, int> label_ids;
 
     int helpful_transition_extraction_counter;
 
     int min_action_cost;
 
+    void number_labels();
     void setup_domain_transition_graphs();
     int get_transition_cost(const State &state, DomainTransitionGraph *dtg, int start_val, int goal_val);
     void mark_helpful_transitions(const State &state, DomainTransitionGraph *dtg, int to);
@@ -36,6 +45,7 @@ public:
     CGHeuristic(const options::Options &opts);
     ~CGHeuristic();
     virtual bool dead_ends_are_reliable() const;
+    virtual void print_statistics() const override;
 };
 }
 
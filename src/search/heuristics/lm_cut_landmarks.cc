@@ -8,23 +8,69 @@ using namespace std;
 
 namespace lm_cut_heuristic {
 // construction and destruction
-LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
+LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy)
+    : round(0) {
     verify_no_axioms(task_proxy);
     verify_no_conditional_effects(task_proxy);
 
+    build_operators_and_propositions(task_proxy);
+}
+
+LandmarkCutLandmarks::~LandmarkCutLandmarks() {
+}
+
+void LandmarkCutLandmarks::build_operators_and_propositions(
+    const TaskProxy &task_proxy) {
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
     VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    int num_propositions = 0;
+    proposition_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        proposition_offsets.push_back(num_propositions);
+        num_propositions += var.get_domain_size();
     }
+    int artificial_precondition_id = num_propositions++;
+    int artificial_goal_id = num_propositions++;
+    propositions.resize(num_propositions);
+    artificial_precondition = &propositions[artificial_precondition_id];
+    artificial_goal = &propositions[artificial_goal_id];
+
+    /*
+      Build relaxed operators for operators and the artificial goal
+      operator. We first collect their preconditions and effects as
+      proposition ids and resolve them once all vectors have their
+      final size.
+    */
+    vector<int> proposition_ids;
+    vector<int> operators_start;
+    auto add_relaxed_operator = [&](const vector<int> &precondition,
+                                    const vector<int> &effects,
+                                    int base_cost) {
+        operators_start.push_back(proposition_ids.size());
+        if (precondition.empty()) {
+            proposition_ids.push_back(artificial_precondition_id);
+        } else {
+            proposition_ids.insert(proposition_ids.end(),
+                                   precondition.begin(), precondition.end());
+        }
+        int num_preconditions = max<int>(precondition.size(), 1);
+        proposition_ids.insert(proposition_ids.end(),
+                               effects.begin(), effects.end());
+        relaxed_operators.emplace_back(
+            num_preconditions, effects.size(), base_cost);
+    };
 
-    // Build relaxed operators for operators and axioms.
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_relaxed_operator(op);
+    vector<int> precondition;
+    vector<int> effects;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        precondition.clear();
+        effects.clear();
+        for (FactProxy pre : op.get_preconditions())
+            precondition.push_back(get_proposition_id(pre));
+        for (EffectProxy eff : op.get_effects())
+            effects.push_back(get_proposition_id(eff.get_fact()));
+        add_relaxed_operator(precondition, effects, op.get_cost());
+    }
 
     // Simplify relaxed operators.
     // simplify();
@@ -32,75 +78,74 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
        but only after trying out whether and how much the change to
        unary operators hurts. */
 
-    // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
-    for (FactProxy goal : task_proxy.get_goals()) {
-        goal_op_pre.push_back(get_proposition(goal));
-    }
-    goal_op_eff.push_back(&artificial_goal);
-    /* Use the invalid operator id -1 so accessing
-       the artificial operator will generate an error. */
-    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
+    // Build artificial goal operator.
+    precondition.clear();
+    for (FactProxy goal : task_proxy.get_goals())
+        precondition.push_back(get_proposition_id(goal));
+    effects.assign(1, artificial_goal_id);
+    add_relaxed_operator(precondition, effects, 0);
 
-    // Cross-reference relaxed operators.
-    for (RelaxedOperator &op : relaxed_operators) {
-        for (RelaxedProposition *pre : op.preconditions)
-            pre->precondition_of.push_back(&op);
-        for (RelaxedProposition *eff : op.effects)
-            eff->effect_of.push_back(&op);
+    operator_propositions.reserve(proposition_ids.size());
+    for (int prop_id : proposition_ids)
+        operator_propositions.push_back(&propositions[prop_id]);
+    for (size_t op_id = 0; op_id < relaxed_operators.size(); ++op_id) {
+        relaxed_operators[op_id].preconditions =
+            &operator_propositions[operators_start[op_id]];
     }
-}
-
-LandmarkCutLandmarks::~LandmarkCutLandmarks() {
-}
 
-void LandmarkCutLandmarks::build_relaxed_operator(const OperatorProxy &op) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
-    for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
+    /*
+      Cross-reference relaxed operators. The precondition_of and
+      effect_of lists are ordered by operator id.
+    */
+    vector<int> num_precondition_of(num_propositions, 0);
+    vector<int> num_effect_of(num_propositions, 0);
+    for (size_t op_id = 0; op_id < relaxed_operators.size(); ++op_id) {
+        const RelaxedOperator &op = relaxed_operators[op_id];
+        const int *op_props = &proposition_ids[operators_start[op_id]];
+        for (int i = 0; i < op.num_preconditions; ++i)
+            ++num_precondition_of[op_props[i]];
+        for (int i = op.num_preconditions;
+             i < op.num_preconditions + op.num_effects; ++i)
+            ++num_effect_of[op_props[i]];
     }
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(get_proposition(eff.get_fact()));
+    vector<int> next_precondition_of(num_propositions);
+    vector<int> next_effect_of(num_propositions);
+    int num_entries = 0;
+    for (int prop_id = 0; prop_id < num_propositions; ++prop_id) {
+        next_precondition_of[prop_id] = num_entries;
+        num_entries += num_precondition_of[prop_id];
+        next_effect_of[prop_id] = num_entries;
+        num_entries += num_effect_of[prop_id];
+    }
+    proposition_operators.resize(num_entries);
+    for (int prop_id = 0; prop_id < num_propositions; ++prop_id) {
+        RelaxedProposition &prop = propositions[prop_id];
+        prop.precondition_of =
+            proposition_operators.data() + next_precondition_of[prop_id];
+        prop.num_precondition_of = num_precondition_of[prop_id];
+        prop.num_effect_of = num_effect_of[prop_id];
+    }
+    for (size_t op_id = 0; op_id < relaxed_operators.size(); ++op_id) {
+        RelaxedOperator *op = &relaxed_operators[op_id];
+        const int *op_props = &proposition_ids[operators_start[op_id]];
+        for (int i = 0; i < op->num_preconditions; ++i)
+            proposition_operators[next_precondition_of[op_props[i]]++] = op;
+        for (int i = op->num_preconditions;
+             i < op->num_preconditions + op->num_effects; ++i)
+            proposition_operators[next_effect_of[op_props[i]]++] = op;
     }
-    add_relaxed_operator(
-        move(precondition), move(effects), op.get_id(), op.get_cost());
-}
-
-void LandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects,
-    int op_id, int base_cost) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), op_id, base_cost);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
-}
-
-RelaxedProposition *LandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
-    int var_id = fact.get_variable().get_id();
-    int val = fact.get_value();
-    return &propositions[var_id][val];
 }
 
 // heuristic computation
 void LandmarkCutLandmarks::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
-    }
-
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
+    for (RelaxedProposition &prop : propositions)
+        prop.status = UNREACHED;
 
     for (RelaxedOperator &op : relaxed_operators) {
-        op.unsatisfied_preconditions = op.preconditions.size();
-        op.h_max_supporter = 0;
+        op.unsatisfied_preconditions = op.num_preconditions;
+        op.h_max_supporter = nullptr;
         op.h_max_supporter_cost = numeric_limits<int>::max();
     }
 }
@@ -109,7 +154,7 @@ void LandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
     for (FactProxy init_fact : state) {
         enqueue_if_necessary(get_proposition(init_fact), 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
 void LandmarkCutLandmarks::first_exploration(const State &state) {
@@ -124,18 +169,20 @@ void LandmarkCutLandmarks::first_exploration(const State &state) {
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
+        RelaxedOperator **triggered_operators = prop->precondition_of;
+        int num_triggered_operators = prop->num_precondition_of;
+        for (int i = 0; i < num_triggered_operators; ++i) {
+            RelaxedOperator *relaxed_op = triggered_operators[i];
             --relaxed_op->unsatisfied_preconditions;
             assert(relaxed_op->unsatisfied_preconditions >= 0);
             if (relaxed_op->unsatisfied_preconditions == 0) {
                 relaxed_op->h_max_supporter = prop;
                 relaxed_op->h_max_supporter_cost = prop_cost;
                 int target_cost = prop_cost + relaxed_op->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    enqueue_if_necessary(effect, target_cost);
-                }
+                RelaxedProposition **effects = relaxed_op->effects();
+                int num_effects = relaxed_op->num_effects;
+                for (int j = 0; j < num_effects; ++j)
+                    enqueue_if_necessary(effects[j], target_cost);
             }
         }
     }
@@ -149,11 +196,12 @@ void LandmarkCutLandmarks::first_exploration_incremental(
        heap-based too aggressively. This should prevent ever switching
        to heap-based in problems where action costs are at most 1.
     */
-    priority_queue.add_virtual_pushes(num_propositions);
+    priority_queue.add_virtual_pushes(propositions.size());
     for (RelaxedOperator *relaxed_op : cut) {
         int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (RelaxedProposition *effect : relaxed_op->effects)
-            enqueue_if_necessary(effect, cost);
+        RelaxedProposition **effects = relaxed_op->effects();
+        for (int j = 0; j < relaxed_op->num_effects; ++j)
+            enqueue_if_necessary(effects[j], cost);
     }
     while (!priority_queue.empty()) {
         pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
@@ -163,9 +211,10 @@ void LandmarkCutLandmarks::first_exploration_incremental(
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
+        RelaxedOperator **triggered_operators = prop->precondition_of;
+        int num_triggered_operators = prop->num_precondition_of;
+        for (int i = 0; i < num_triggered_operators; ++i) {
+            RelaxedOperator *relaxed_op = triggered_operators[i];
             if (relaxed_op->h_max_supporter == prop) {
                 int old_supp_cost = relaxed_op->h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
@@ -175,8 +224,10 @@ void LandmarkCutLandmarks::first_exploration_incremental(
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
                         int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
-                            enqueue_if_necessary(effect, target_cost);
+                        RelaxedProposition **effects = relaxed_op->effects();
+                        int num_effects = relaxed_op->num_effects;
+                        for (int j = 0; j < num_effects; ++j)
+                            enqueue_if_necessary(effects[j], target_cost);
                     }
                 }
             }
@@ -190,25 +241,31 @@ void LandmarkCutLandmarks::second_exploration(
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    const int goal_zone_mark = goal_zone();
+    const int before_goal_zone_mark = before_goal_zone();
+
+    artificial_precondition->status = before_goal_zone_mark;
+    second_exploration_queue.push_back(artificial_precondition);
 
     for (FactProxy init_fact : state) {
         RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+        init_prop->status = before_goal_zone_mark;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
         RelaxedProposition *prop = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
+        RelaxedOperator **triggered_operators = prop->precondition_of;
+        int num_triggered_operators = prop->num_precondition_of;
+        for (int i = 0; i < num_triggered_operators; ++i) {
+            RelaxedOperator *relaxed_op = triggered_operators[i];
             if (relaxed_op->h_max_supporter == prop) {
+                RelaxedProposition **effects = relaxed_op->effects();
+                int num_effects = relaxed_op->num_effects;
                 bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
+                for (int j = 0; j < num_effects; ++j) {
+                    if (effects[j]->status == goal_zone_mark) {
                         assert(relaxed_op->cost > 0);
                         reached_goal_zone = true;
                         cut.push_back(relaxed_op);
@@ -216,10 +273,11 @@ void LandmarkCutLandmarks::second_exploration(
                     }
                 }
                 if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
+                    for (int j = 0; j < num_effects; ++j) {
+                        RelaxedProposition *effect = effects[j];
+                        if (effect->status != before_goal_zone_mark) {
+                            assert(effect->status != UNREACHED);
+                            effect->status = before_goal_zone_mark;
                             second_exploration_queue.push_back(effect);
                         }
                     }
@@ -234,11 +292,12 @@ void LandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
     // a zero-cost action that is relaxed unreachable. (This can only
     // happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->cost == 0)
-                mark_goal_plateau(achiever->h_max_supporter);
+    if (subgoal && subgoal->status != goal_zone()) {
+        subgoal->status = goal_zone();
+        RelaxedOperator **achievers = subgoal->effect_of();
+        for (int i = 0; i < subgoal->num_effect_of; ++i)
+            if (achievers[i]->cost == 0)
+                mark_goal_plateau(achievers[i]->h_max_supporter);
     }
 }
 
@@ -250,8 +309,8 @@ void LandmarkCutLandmarks::validate_h_max() const {
     for (const RelaxedOperator &op : relaxed_operators) {
         if (op.unsatisfied_preconditions) {
             bool reachable = true;
-            for (RelaxedProposition *pre : op.preconditions) {
-                if (pre->status == UNREACHED) {
+            for (int i = 0; i < op.num_preconditions; ++i) {
+                if (op.preconditions[i]->status == UNREACHED) {
                     reachable = false;
                     break;
                 }
@@ -262,9 +321,9 @@ void LandmarkCutLandmarks::validate_h_max() const {
             assert(op.h_max_supporter);
             int h_max_cost = op.h_max_supporter_cost;
             assert(h_max_cost == op.h_max_supporter->h_max_cost);
-            for (RelaxedProposition *pre : op.preconditions) {
-                assert(pre->status != UNREACHED);
-                assert(pre->h_max_cost <= h_max_cost);
+            for (int i = 0; i < op.num_preconditions; ++i) {
+                assert(op.preconditions[i]->status != UNREACHED);
+                assert(op.preconditions[i]->h_max_cost <= h_max_cost);
             }
         }
     }
@@ -286,13 +345,17 @@ bool LandmarkCutLandmarks::compute_landmarks(
     vector<RelaxedProposition *> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    if (artificial_goal->status == UNREACHED)
         return true;
 
-    int num_iterations = 0;
-    while (artificial_goal.h_max_cost != 0) {
-        ++num_iterations;
-        mark_goal_plateau(&artificial_goal);
+    /*
+      All propositions are UNREACHED or REACHED now, so we can restart
+      counting rounds. Incrementing the round after each cut turns the
+      goal zone marks of the previous round into REACHED.
+    */
+    round = 0;
+    while (artificial_goal->h_max_cost != 0) {
+        mark_goal_plateau(artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
@@ -306,9 +369,11 @@ bool LandmarkCutLandmarks::compute_landmarks(
             cost_callback(cut_cost);
         }
         if (landmark_callback) {
+            /* The artificial goal operator has cost 0 and is never
+               part of a cut, so all ids are valid operator ids. */
             landmark.clear();
             for (RelaxedOperator *op : cut) {
-                landmark.push_back(op->original_op_id);
+                landmark.push_back(op - relaxed_operators.data());
             }
             landmark_callback(landmark, cut_cost);
         }
@@ -316,21 +381,7 @@ bool LandmarkCutLandmarks::compute_landmarks(
         first_exploration_incremental(cut);
         // validate_h_max();  // too expensive to use even in regular debug mode
         cut.clear();
-
-        /*
-          Note: This could perhaps be made more efficient, for example by
-          using a round-dependent counter for GOAL_ZONE and BEFORE_GOAL_ZONE,
-          or something based on total_cost, so that we don't need a per-round
-          reinitialization.
-        */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
-        }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
+        ++round;
     }
     return false;
 }
@@ -11,56 +11,98 @@
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
-
+struct RelaxedOperator;
+
+/*
+  The status of a proposition is UNREACHED, REACHED or a goal zone
+  mark. The marks depend on the round of the cut computation: in round
+  r, the goal zone is marked with 2 + 2r and the zone before it with
+  3 + 2r. Marks of earlier rounds count as REACHED, which saves
+  resetting all propositions after each cut.
+*/
 enum PropositionStatus {
     UNREACHED = 0,
-    REACHED = 1,
-    GOAL_ZONE = 2,
-    BEFORE_GOAL_ZONE = 3
+    REACHED = 1
+};
+
+/*
+  Propositions and operators live in two flat vectors. Their
+  adjacency lists are ranges of two further flat vectors: the
+  preconditions of an operator are directly followed by its effects,
+  and the operators having a proposition as precondition are directly
+  followed by those having it as effect. Both structs are kept small
+  because the explorations touch them in random order.
+
+  The adjacency lists hold pointers rather than indices. We tried both,
+  and resolving indices made the explorations measurably slower.
+*/
+struct RelaxedProposition {
+    RelaxedOperator **precondition_of;
+    int num_precondition_of;
+    int num_effect_of;
+
+    int status;
+    int h_max_cost;
+
+    RelaxedProposition()
+        : precondition_of(nullptr), num_precondition_of(0), num_effect_of(0),
+          status(UNREACHED), h_max_cost(0) {
+    }
+
+    RelaxedOperator **effect_of() const {
+        return precondition_of + num_precondition_of;
+    }
 };
 
 struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
+    RelaxedProposition **preconditions;
+    RelaxedProposition *h_max_supporter;
+    int num_preconditions;
+    int num_effects;
     int base_cost; // 0 for axioms, 1 for regular operators
 
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
-                    int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base) {
-    }
 
-    inline void update_h_max_supporter();
-};
+    RelaxedOperator(int num_preconditions, int num_effects, int base)
+        : preconditions(nullptr), h_max_supporter(nullptr),
+          num_preconditions(num_preconditions), num_effects(num_effects),
+          base_cost(base), cost(base), unsatisfied_preconditions(0),
+          h_max_supporter_cost(0) {
+    }
 
-struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
+    RelaxedProposition **effects() const {
+        return preconditions + num_preconditions;
+    }
 
-    PropositionStatus status;
-    int h_max_cost;
+    inline void update_h_max_supporter();
 };
 
 class LandmarkCutLandmarks {
+    /*
+      Relaxed operator i corresponds to operator i of the task. The
+      last relaxed operator is the artificial goal operator.
+    */
     std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
-    int num_propositions;
+    std::vector<RelaxedProposition> propositions;
+    std::vector<RelaxedProposition *> operator_propositions;
+    std::vector<RelaxedOperator *> proposition_operators;
+    // The propositions of variable v start at proposition_offsets[v].
+    std::vector<int> proposition_offsets;
+    RelaxedProposition *artificial_precondition;
+    RelaxedProposition *artificial_goal;
+    int round;
     AdaptiveQueue<RelaxedProposition *> priority_queue;
 
-    void initialize();
-    void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
-                              int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
+    void build_operators_and_propositions(const TaskProxy &task_proxy);
+    int get_proposition_id(const FactProxy &fact) const {
+        return proposition_offsets[fact.get_variable().get_id()] +
+               fact.get_value();
+    }
+    RelaxedProposition *get_proposition(const FactProxy &fact) {
+        return &propositions[get_proposition_id(fact)];
+    }
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
@@ -69,6 +111,14 @@ class LandmarkCutLandmarks {
                             std::vector<RelaxedProposition *> &queue,
                             std::vector<RelaxedOperator *> &cut);
 
+    int goal_zone() const {
+        return 2 + 2 * round;
+    }
+
+    int before_goal_zone() const {
+        return 3 + 2 * round;
+    }
+
     void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
         assert(cost >= 0);
         if (prop->status == UNREACHED || prop->h_max_cost > cost) {
@@ -107,10 +157,17 @@ public:
 
 inline void RelaxedOperator::update_h_max_supporter() {
     assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+    RelaxedProposition *supporter = h_max_supporter;
+    int supporter_cost = supporter->h_max_cost;
+    for (int i = 0; i < num_preconditions; ++i) {
+        int pre_cost = preconditions[i]->h_max_cost;
+        if (pre_cost > supporter_cost) {
+            supporter = preconditions[i];
+            supporter_cost = pre_cost;
+        }
+    }
+    h_max_supporter = supporter;
+    h_max_supporter_cost = supporter_cost;
 }
 }
 
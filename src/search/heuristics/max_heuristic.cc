@@ -4,6 +4,8 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/memory.h"
+
 #include <cassert>
 #include <vector>
 using namespace std;
@@ -25,13 +27,21 @@ namespace max_heuristic {
 HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
     : RelaxationHeuristic(opts) {
     cout << "Initializing HSP max heuristic..." << endl;
+    int max_base_cost = get_max_base_cost();
+    if (max_base_cost <= MAX_BASE_COST_FOR_MONOTONE_QUEUE) {
+        cout << "Using Dial queue for maximal operator cost "
+             << max_base_cost << endl;
+        dial_queue = utils::make_unique_ptr<DialQueue<Proposition *>>(
+            max_base_cost);
+    }
 }
 
 HSPMaxHeuristic::~HSPMaxHeuristic() {
 }
 
 // heuristic computation
-void HSPMaxHeuristic::setup_exploration_queue() {
+template<typename Queue>
+void HSPMaxHeuristic::setup_exploration_queue(Queue &queue) {
     queue.clear();
 
     for (vector<Proposition> &props_of_var : propositions) {
@@ -46,18 +56,21 @@ void HSPMaxHeuristic::setup_exploration_queue() {
         op.cost = op.base_cost; // will be increased by precondition costs
 
         if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+            enqueue_if_necessary(queue, op.effect, op.base_cost);
     }
 }
 
-void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
+template<typename Queue>
+void HSPMaxHeuristic::setup_exploration_queue_state(
+    Queue &queue, const State &state) {
     for (FactProxy fact : state) {
         Proposition *init_prop = get_proposition(fact);
-        enqueue_if_necessary(init_prop, 0);
+        enqueue_if_necessary(queue, init_prop, 0);
     }
 }
 
-void HSPMaxHeuristic::relaxed_exploration() {
+template<typename Queue>
+void HSPMaxHeuristic::relaxed_exploration(Queue &queue) {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
         pair<int, Proposition *> top_pair = queue.pop();
@@ -77,17 +90,25 @@ void HSPMaxHeuristic::relaxed_exploration() {
                                  unary_op->base_cost + prop_cost);
             assert(unary_op->unsatisfied_preconditions >= 0);
             if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+                enqueue_if_necessary(queue, unary_op->effect, unary_op->cost);
         }
     }
 }
 
+template<typename Queue>
+void HSPMaxHeuristic::compute_costs(Queue &queue, const State &state) {
+    setup_exploration_queue(queue);
+    setup_exploration_queue_state(queue, state);
+    relaxed_exploration(queue);
+}
+
 int HSPMaxHeuristic::compute_heuristic(const GlobalState &global_state) {
     const State state = convert_global_state(global_state);
 
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (dial_queue)
+        compute_costs(*dial_queue, state);
+    else
+        compute_costs(adaptive_queue, state);
 
     int total_cost = 0;
     for (Proposition *prop : goal_propositions) {
@@ -6,19 +6,33 @@
 #include "../priority_queue.h"
 
 #include <cassert>
+#include <memory>
 
 namespace max_heuristic {
 using relaxation_heuristic::Proposition;
 using relaxation_heuristic::UnaryOperator;
 
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
-    AdaptiveQueue<Proposition *> queue;
-
-    void setup_exploration_queue();
-    void setup_exploration_queue_state(const State &state);
-    void relaxed_exploration();
-
-    void enqueue_if_necessary(Proposition *prop, int cost) {
+    AdaptiveQueue<Proposition *> adaptive_queue;
+    /*
+      For tasks with small operator costs, all keys in the queue lie
+      within max_base_cost of the last popped key, so we use a
+      DialQueue instead of the adaptive queue. With unit costs (and
+      0-cost axioms), this is a two-bucket queue.
+    */
+    std::unique_ptr<DialQueue<Proposition *>> dial_queue;
+
+    template<typename Queue>
+    void setup_exploration_queue(Queue &queue);
+    template<typename Queue>
+    void setup_exploration_queue_state(Queue &queue, const State &state);
+    template<typename Queue>
+    void relaxed_exploration(Queue &queue);
+    template<typename Queue>
+    void compute_costs(Queue &queue, const State &state);
+
+    template<typename Queue>
+    void enqueue_if_necessary(Queue &queue, Proposition *prop, int cost) {
         assert(cost >= 0);
         if (prop->cost == -1 || prop->cost > cost) {
             prop->cost = cost;
@@ -67,6 +67,13 @@ Proposition *RelaxationHeuristic::get_proposition(const FactProxy &fact) {
     return &propositions[var][value];
 }
 
+int RelaxationHeuristic::get_max_base_cost() const {
+    int max_base_cost = 0;
+    for (const UnaryOperator &op : unary_operators)
+        max_base_cost = max(max_base_cost, op.base_cost);
+    return max_base_cost;
+}
+
 void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op, int op_no) {
     int base_cost = op.get_cost();
     vector<Proposition *> precondition_props;
@@ -50,11 +50,19 @@ class RelaxationHeuristic : public Heuristic {
     void build_unary_operators(const OperatorProxy &op, int operator_no);
     void simplify();
 protected:
+    /*
+      If no unary operator costs more than this, the h^max exploration
+      uses a DialQueue instead of AdaptiveQueue. The h^add exploration
+      only uses a monotone queue for unit costs (see AdditiveHeuristic).
+    */
+    static const int MAX_BASE_COST_FOR_MONOTONE_QUEUE = 100;
+
     std::vector<UnaryOperator> unary_operators;
     std::vector<std::vector<Proposition>> propositions;
     std::vector<Proposition *> goal_propositions;
 
     Proposition *get_proposition(const FactProxy &fact);
+    int get_max_base_cost() const;
     virtual int compute_heuristic(const GlobalState &state) = 0;
 public:
     RelaxationHeuristic(const options::Options &options);
@@ -2,10 +2,12 @@
 
 #include "util.h"
 
+#include "../option_parser.h"
 #include "../task_tools.h"
 
 #include "../utils/collections.h"
 #include "../utils/hash.h"
+#include "../utils/memory.h"
 
 #include <algorithm>
 #include <cassert>
@@ -38,42 +40,80 @@ Exploration::Exploration(const options::Options &opts)
     cout << "Initializing Exploration..." << endl;
 
     // Build propositions.
-    for (VariableProxy var : task_proxy.get_variables()) {
+    VariablesProxy variables = task_proxy.get_variables();
+    for (VariableProxy var : variables) {
         int var_id = var.get_id();
-        propositions.push_back(vector<ExProposition>(var.get_domain_size()));
+        proposition_offsets.push_back(propositions.size());
         for (int value = 0; value < var.get_domain_size(); ++value) {
-            propositions[var_id][value].fact = FactPair(var_id, value);
+            propositions.emplace_back(FactPair(var_id, value));
         }
     }
 
     // Build goal propositions.
     for (FactProxy goal_fact : task_proxy.get_goals()) {
-        int var_id = goal_fact.get_variable().get_id();
-        int value = goal_fact.get_value();
-        propositions[var_id][value].is_goal_condition = true;
-        propositions[var_id][value].is_termination_condition = true;
-        goal_propositions.push_back(&propositions[var_id][value]);
-        termination_propositions.push_back(&propositions[var_id][value]);
+        ExProposition *prop = get_proposition(goal_fact.get_pair());
+        prop->is_goal_condition = true;
+        prop->is_termination_condition = true;
+        goal_propositions.push_back(prop);
+        termination_propositions.push_back(prop);
     }
 
     // Build unary operators for operators and axioms.
     OperatorsProxy operators = task_proxy.get_operators();
-    for (OperatorProxy op : operators)
+    for (OperatorProxy op : operators) {
+        unary_operator_offsets.push_back(unary_operators.size());
         build_unary_operators(op);
+    }
     AxiomsProxy axioms = task_proxy.get_axioms();
-    for (OperatorProxy op : axioms)
+    for (OperatorProxy op : axioms) {
+        unary_operator_offsets.push_back(unary_operators.size());
         build_unary_operators(op);
-
-    // Cross-reference unary operators.
-    for (ExUnaryOperator &op : unary_operators) {
-        for (ExProposition *pre : op.precondition)
-            pre->precondition_of.push_back(&op);
     }
+    unary_operator_offsets.push_back(unary_operators.size());
+
+    cross_reference();
     // Set flag that before heuristic values can be used, computation
     // (relaxed exploration) needs to be done
     heuristic_recomputation_needed = true;
 }
 
+void Exploration::cross_reference() {
+    /*
+      Point the unary operators to their preconditions, which
+      build_unary_operators stored consecutively in
+      unary_operator_preconditions, and fill the precondition_of lists
+      in the order of the unary operators.
+    */
+    ExProposition **next_precondition = unary_operator_preconditions.data();
+    for (ExUnaryOperator &op : unary_operators) {
+        op.precondition = next_precondition;
+        next_precondition += op.num_preconditions;
+        for (int i = 0; i < op.num_preconditions; ++i)
+            ++op.precondition[i]->num_precondition_of;
+    }
+
+    proposition_precondition_of.resize(unary_operator_preconditions.size());
+    ExUnaryOperator **next_operator = proposition_precondition_of.data();
+    for (ExProposition &prop : propositions) {
+        prop.precondition_of = next_operator;
+        next_operator += prop.num_precondition_of;
+        prop.num_precondition_of = 0;
+    }
+    for (ExUnaryOperator &op : unary_operators) {
+        for (int i = 0; i < op.num_preconditions; ++i) {
+            ExProposition *pre = op.precondition[i];
+            pre->precondition_of[pre->num_precondition_of++] = &op;
+        }
+    }
+}
+
+unique_ptr<Exploration> Exploration::create_independent_copy() const {
+    Options opts;
+    opts.set<shared_ptr<AbstractTask>>("transform", task);
+    opts.set<bool>("cache_estimates", false);
+    return utils::make_unique_ptr<Exploration>(opts);
+}
+
 void Exploration::increase_cost(int &cost, int amount) {
     assert(cost >= 0);
     assert(amount >= 0);
@@ -99,22 +139,19 @@ void Exploration::write_overflow_warning() {
 void Exploration::set_additional_goals(const vector<FactPair> &add_goals) {
     //Clear previous additional goals.
     for (ExProposition *prop : termination_propositions) {
-        propositions[prop->fact.var][prop->fact.value].is_termination_condition = false;
+        prop->is_termination_condition = false;
     }
     termination_propositions.clear();
-    for (FactProxy goal_fact : task_proxy.get_goals()) {
-        int var_id = goal_fact.get_variable().get_id();
-        int value = goal_fact.get_value();
-        propositions[var_id][value].is_termination_condition = true;
-        termination_propositions.push_back(&propositions[var_id][value]);
+    for (ExProposition *prop : goal_propositions) {
+        prop->is_termination_condition = true;
+        termination_propositions.push_back(prop);
     }
     // Build new additional goal propositions.
     for (const FactPair &fact : add_goals) {
-        int var_id = fact.var;
-        int value = fact.value;
-        if (!propositions[var_id][value].is_goal_condition) {
-            propositions[var_id][value].is_termination_condition = true;
-            termination_propositions.push_back(&propositions[var_id][value]);
+        ExProposition *prop = get_proposition(fact);
+        if (!prop->is_goal_condition) {
+            prop->is_termination_condition = true;
+            termination_propositions.push_back(prop);
         }
     }
     heuristic_recomputation_needed = true;
@@ -123,7 +160,8 @@ void Exploration::set_additional_goals(const vector<FactPair> &add_goals) {
 void Exploration::build_unary_operators(const OperatorProxy &op) {
     // Note: changed from the original to allow sorting of operator conditions
     int base_cost = op.get_cost();
-    vector<ExProposition *> precondition;
+    int op_or_axiom_id = get_operator_or_axiom_id(op);
+    bool is_axiom = op.is_axiom();
     vector<FactPair> precondition_facts1;
 
     for (FactProxy pre : op.get_preconditions()) {
@@ -139,51 +177,58 @@ void Exploration::build_unary_operators(const OperatorProxy &op) {
         sort(precondition_facts2.begin(), precondition_facts2.end());
 
         for (const FactPair &precondition_fact : precondition_facts2)
-            precondition.push_back(&propositions[precondition_fact.var]
-                                   [precondition_fact.value]);
-
-        FactProxy effect_fact = effect.get_fact();
-        ExProposition *effect_proposition = &propositions[effect_fact.get_variable().get_id()][effect_fact.get_value()];
-        int op_or_axiom_id = get_operator_or_axiom_id(op);
-        unary_operators.emplace_back(precondition, effect_proposition, op_or_axiom_id, base_cost);
-        precondition.clear();
-        precondition_facts2.clear();
+            unary_operator_preconditions.push_back(
+                get_proposition(precondition_fact));
+
+        ExProposition *effect_proposition =
+            get_proposition(effect.get_fact().get_pair());
+        unary_operators.emplace_back(
+            precondition_facts2.size(), effect_proposition, op_or_axiom_id,
+            base_cost, is_axiom);
     }
 }
 
 // heuristic computation
 void Exploration::setup_exploration_queue(const State &state,
                                           const vector<FactPair> &excluded_props,
-                                          const unordered_set<int> &excluded_op_ids,
+                                          const vector<int> &excluded_op_ids,
                                           bool use_h_max) {
     prop_queue.clear();
 
-    for (size_t var_id = 0; var_id < propositions.size(); ++var_id) {
-        for (size_t value = 0; value < propositions[var_id].size(); ++value) {
-            ExProposition &prop = propositions[var_id][value];
-            prop.h_add_cost = -1;
-            prop.h_max_cost = -1;
-            prop.depth = -1;
-            prop.marked = false;
-        }
+    for (ExProposition &prop : propositions) {
+        prop.h_add_cost = -1;
+        prop.h_max_cost = -1;
+        prop.depth = -1;
+        prop.marked = false;
     }
 
     for (const FactPair &fact : excluded_props) {
-        ExProposition &prop = propositions[fact.var][fact.value];
-        prop.h_add_cost = -2;
+        get_proposition(fact)->h_add_cost = -2;
+    }
+
+    int num_operators = task_proxy.get_operators().size();
+    for (int op_or_axiom_id : excluded_op_ids) {
+        int index = (op_or_axiom_id >= 0) ?
+            op_or_axiom_id : num_operators - op_or_axiom_id - 1;
+        for (int i = unary_operator_offsets[index];
+             i < unary_operator_offsets[index + 1]; ++i) {
+            unary_operators[i].excluded = true;
+        }
     }
 
     // Deal with current state.
     for (FactProxy fact : state) {
-        ExProposition *init_prop = &propositions[fact.get_variable().get_id()][fact.get_value()];
+        ExProposition *init_prop = get_proposition(fact.get_pair());
         enqueue_if_necessary(init_prop, 0, 0, 0, use_h_max);
     }
 
     // Initialize operator data, deal with precondition-free operators/axioms.
+    bool use_excludes = !excluded_op_ids.empty();
     for (ExUnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.precondition.size();
-        if (!excluded_op_ids.empty() &&
-            (op.effect->h_add_cost == -2 || excluded_op_ids.count(op.op_or_axiom_id))) {
+        op.unsatisfied_preconditions = op.num_preconditions;
+        bool excluded = op.excluded;
+        op.excluded = false;
+        if (use_excludes && (op.effect->h_add_cost == -2 || excluded)) {
             op.h_add_cost = -2; // operator will not be applied during relaxed exploration
             continue;
         }
@@ -193,7 +238,7 @@ void Exploration::setup_exploration_queue(const State &state,
 
         if (op.unsatisfied_preconditions == 0) {
             op.depth = 0;
-            int depth = op.is_induced_by_axiom(task_proxy) ? 0 : 1;
+            int depth = op.is_induced_by_axiom ? 0 : 1;
             enqueue_if_necessary(op.effect, op.base_cost, depth, &op, use_h_max);
         }
     }
@@ -216,8 +261,8 @@ void Exploration::relaxed_exploration(bool use_h_max, bool level_out) {
             continue;
         if (!level_out && prop->is_termination_condition && --unsolved_goals == 0)
             return;
-        const vector<ExUnaryOperator *> &triggered_operators = prop->precondition_of;
-        for (size_t i = 0; i < triggered_operators.size(); ++i) {
+        ExUnaryOperator **triggered_operators = prop->precondition_of;
+        for (int i = 0; i < prop->num_precondition_of; ++i) {
             ExUnaryOperator *unary_op = triggered_operators[i];
             if (unary_op->h_add_cost == -2) // operator is not applied
                 continue;
@@ -228,7 +273,7 @@ void Exploration::relaxed_exploration(bool use_h_max, bool level_out) {
             unary_op->depth = max(unary_op->depth, prop->depth);
             assert(unary_op->unsatisfied_preconditions >= 0);
             if (unary_op->unsatisfied_preconditions == 0) {
-                int depth = unary_op->is_induced_by_axiom(task_proxy)
+                int depth = unary_op->is_induced_by_axiom
                             ? unary_op->depth : unary_op->depth + 1;
                 if (use_h_max)
                     enqueue_if_necessary(unary_op->effect, unary_op->h_max_cost,
@@ -299,8 +344,8 @@ void Exploration::collect_relaxed_plan(ExProposition *goal,
         goal->marked = true;
         ExUnaryOperator *unary_op = goal->reached_by;
         if (unary_op) { // We have not yet chained back to a start node.
-            for (ExProposition *pre : unary_op->precondition)
-                collect_relaxed_plan(pre, relaxed_plan, state);
+            for (int i = 0; i < unary_op->num_preconditions; ++i)
+                collect_relaxed_plan(unary_op->precondition[i], relaxed_plan, state);
             int op_or_axiom_id = unary_op->op_or_axiom_id;
             bool added_to_relaxed_plan = false;
             /* Using axioms in the relaxed plan actually improves
@@ -311,7 +356,7 @@ void Exploration::collect_relaxed_plan(ExProposition *goal,
             if (added_to_relaxed_plan
                 && unary_op->h_add_cost == unary_op->base_cost
                 && unary_op->depth == 0
-                && !unary_op->is_induced_by_axiom(task_proxy)) {
+                && !unary_op->is_induced_by_axiom) {
                 set_preferred(get_operator_or_axiom(task_proxy, op_or_axiom_id));
                 assert(is_applicable(get_operator_or_axiom(task_proxy, op_or_axiom_id), state));
             }
@@ -323,26 +368,24 @@ void Exploration::compute_reachability_with_excludes(vector<vector<int>> &lvl_va
                                                      vector<unordered_map<FactPair, int>> &lvl_op,
                                                      bool level_out,
                                                      const vector<FactPair> &excluded_props,
-                                                     const unordered_set<int> &excluded_op_ids,
+                                                     const vector<int> &excluded_op_ids,
                                                      bool compute_lvl_ops) {
     // Perform exploration using h_max-values
     setup_exploration_queue(task_proxy.get_initial_state(), excluded_props, excluded_op_ids, true);
     relaxed_exploration(true, level_out);
 
     // Copy reachability information into lvl_var and lvl_op
-    for (size_t var_id = 0; var_id < propositions.size(); ++var_id) {
-        for (size_t value = 0; value < propositions[var_id].size(); ++value) {
-            ExProposition &prop = propositions[var_id][value];
-            if (prop.h_max_cost >= 0)
-                lvl_var[var_id][value] = prop.h_max_cost;
-        }
+    for (const ExProposition &prop : propositions) {
+        if (prop.h_max_cost >= 0)
+            lvl_var[prop.fact.var][prop.fact.value] = prop.h_max_cost;
     }
     if (compute_lvl_ops) {
         for (ExUnaryOperator &op : unary_operators) {
             // H_max_cost of operator might be wrongly 0 or 1, if the operator
             // did not get applied during relaxed exploration. Look through
             // preconditions and adjust.
-            for (ExProposition *prop : op.precondition) {
+            for (int i = 0; i < op.num_preconditions; ++i) {
+                const ExProposition *prop = op.precondition[i];
                 if (prop->h_max_cost == -1) {
                     // Operator cannot be applied due to unreached precondition
                     op.h_max_cost = numeric_limits<int>::max();
@@ -388,17 +431,17 @@ void Exploration::collect_helpful_actions(
 
     ExUnaryOperator *unary_op = goal->reached_by;
     if (unary_op) { // We have not yet chained back to a start node.
-        for (ExProposition *pre : unary_op->precondition)
-            collect_helpful_actions(pre, relaxed_plan, state);
+        for (int i = 0; i < unary_op->num_preconditions; ++i)
+            collect_helpful_actions(unary_op->precondition[i], relaxed_plan, state);
         int op_or_axiom_id = unary_op->op_or_axiom_id;
         bool added_to_relaxed_plan = false;
-        if (!unary_op->is_induced_by_axiom(task_proxy)) {
+        if (!unary_op->is_induced_by_axiom) {
             added_to_relaxed_plan = relaxed_plan.insert(op_or_axiom_id).second;
         }
         if (added_to_relaxed_plan
             && unary_op->h_add_cost == unary_op->base_cost
             && unary_op->depth == 0
-            && !unary_op->is_induced_by_axiom(task_proxy)) {
+            && !unary_op->is_induced_by_axiom) {
             exported_op_ids.push_back(op_or_axiom_id); // This is a helpful action.
             assert(is_applicable(get_operator_or_axiom(task_proxy, op_or_axiom_id), state));
         }
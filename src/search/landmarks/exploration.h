@@ -8,79 +8,76 @@
 #include "../priority_queue.h"
 
 #include <cassert>
+#include <memory>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 class OperatorProxy;
 
 namespace landmarks {
-struct ExProposition;
 struct ExUnaryOperator;
 
+/*
+  Propositions and unary operators live in two flat vectors, and their
+  adjacency lists are ranges of two further flat vectors (see
+  Exploration). This saves one indirection per access in the
+  explorations, which the landmark factories run many times.
+*/
 struct ExProposition {
+    ExUnaryOperator **precondition_of;
+    int num_precondition_of;
     FactPair fact;
     bool is_goal_condition;
     bool is_termination_condition;
-    std::vector<ExUnaryOperator *> precondition_of;
+    bool marked; // used when computing preferred operators
 
     int h_add_cost;
     int h_max_cost;
     int depth;
-    bool marked; // used when computing preferred operators
     ExUnaryOperator *reached_by;
 
-    ExProposition()
-        : fact(FactPair::no_fact),
+    explicit ExProposition(const FactPair &fact)
+        : precondition_of(nullptr),
+          num_precondition_of(0),
+          fact(fact),
           is_goal_condition(false),
           is_termination_condition(false),
+          marked(false),
           h_add_cost(-1),
           h_max_cost(-1),
           depth(-1),
-          marked(false),
           reached_by(nullptr)
     {}
-
-    bool operator<(const ExProposition &other) const {
-        return fact < other.fact;
-    }
 };
 
 struct ExUnaryOperator {
-    int op_or_axiom_id;
-    std::vector<ExProposition *> precondition;
+    ExProposition **precondition;
+    int num_preconditions;
     ExProposition *effect;
+    int op_or_axiom_id;
     int base_cost; // 0 for axioms, 1 for regular operators
+    bool is_induced_by_axiom;
+    // Set for the excluded operators of a query, reset when setting it up.
+    bool excluded;
 
     int unsatisfied_preconditions;
     int h_add_cost;
     int h_max_cost;
     int depth;
-    ExUnaryOperator(const std::vector<ExProposition *> &pre, ExProposition *eff,
-                    int op_or_axiom_id, int base)
-        : op_or_axiom_id(op_or_axiom_id), precondition(pre), effect(eff), base_cost(base) {}
-
-
-    bool operator<(const ExUnaryOperator &other) const {
-        if (*(other.effect) < *effect)
-            return false;
-        else if (*effect < *(other.effect))
-            return true;
-
-        else {
-            for (size_t i = 0; i < precondition.size(); ++i) {
-                if (i == other.precondition.size() ||
-                    *(other.precondition[i]) < *(precondition[i]))
-                    return false;
-                else if (*(precondition[i]) < *(other.precondition[i]))
-                    return true;
-            }
-            return true;
-        }
-    }
 
-    bool is_induced_by_axiom(const TaskProxy &task_proxy) const {
-        return get_operator_or_axiom(task_proxy, op_or_axiom_id).is_axiom();
+    ExUnaryOperator(int num_preconditions, ExProposition *eff,
+                    int op_or_axiom_id, int base, bool is_induced_by_axiom)
+        : precondition(nullptr),
+          num_preconditions(num_preconditions),
+          effect(eff),
+          op_or_axiom_id(op_or_axiom_id),
+          base_cost(base),
+          is_induced_by_axiom(is_induced_by_axiom),
+          excluded(false),
+          unsatisfied_preconditions(0),
+          h_add_cost(0),
+          h_max_cost(0),
+          depth(-1) {
     }
 };
 
@@ -90,7 +87,16 @@ class Exploration : public Heuristic {
     using RelaxedPlan = std::set<int>;
     RelaxedPlan relaxed_plan;
     std::vector<ExUnaryOperator> unary_operators;
-    std::vector<std::vector<ExProposition>> propositions;
+    std::vector<ExProposition> propositions;
+    std::vector<ExProposition *> unary_operator_preconditions;
+    std::vector<ExUnaryOperator *> proposition_precondition_of;
+    // The propositions of variable v start at proposition_offsets[v].
+    std::vector<int> proposition_offsets;
+    /*
+      The unary operators of operator i (axiom i) start at
+      unary_operator_offsets[i] (unary_operator_offsets[num_operators + i]).
+    */
+    std::vector<int> unary_operator_offsets;
     std::vector<ExProposition *> goal_propositions;
     std::vector<ExProposition *> termination_propositions;
 
@@ -99,16 +105,20 @@ class Exploration : public Heuristic {
 
     bool heuristic_recomputation_needed;
 
+    ExProposition *get_proposition(const FactPair &fact) {
+        return &propositions[proposition_offsets[fact.var] + fact.value];
+    }
+
     void build_unary_operators(const OperatorProxy &op);
-    void simplify();
+    void cross_reference();
 
     void setup_exploration_queue(const State &state,
                                  const std::vector<FactPair> &excluded_props,
-                                 const std::unordered_set<int> &excluded_op_ids,
+                                 const std::vector<int> &excluded_op_ids,
                                  bool use_h_max);
     void setup_exploration_queue(const State &state, bool h_max) {
         std::vector<FactPair> excluded_props;
-        std::unordered_set<int> excluded_op_ids;
+        std::vector<int> excluded_op_ids;
         setup_exploration_queue(state, excluded_props, excluded_op_ids, h_max);
     }
     void relaxed_exploration(bool use_h_max, bool level_out);
@@ -130,13 +140,25 @@ protected:
 public:
     explicit Exploration(const options::Options &opts);
 
+    /*
+      Create an exploration of the same task that shares no mutable
+      state with this one, so that both can be used in different threads.
+    */
+    std::unique_ptr<Exploration> create_independent_copy() const;
+
     void set_additional_goals(const std::vector<FactPair> &goals);
     void set_recompute_heuristic() {heuristic_recomputation_needed = true; }
+    /*
+      Operators and axioms are given by their IDs as returned by
+      get_operator_or_axiom_id() and may be listed more than once.
+      Excluded propositions only exclude their achievers if
+      excluded_op_ids is not empty.
+    */
     void compute_reachability_with_excludes(std::vector<std::vector<int>> &lvl_var,
                                             std::vector<std::unordered_map<FactPair, int>> &lvl_op,
                                             bool level_out,
                                             const std::vector<FactPair> &excluded_props,
-                                            const std::unordered_set<int> &excluded_op_ids,
+                                            const std::vector<int> &excluded_op_ids,
                                             bool compute_lvl_ops);
     // Only needed for computing helpful actions for landmark count heuristic.
     std::vector<int> exported_op_ids;
@@ -11,6 +11,7 @@
 #include <functional>
 #include <iostream>
 #include <limits>
+#include <utility>
 
 using namespace std;
 
@@ -20,15 +21,15 @@ LandmarkCostAssignment::LandmarkCostAssignment(const vector<int> &operator_costs
     : lm_graph(graph), operator_costs(operator_costs) {
 }
 
-const set<int> &LandmarkCostAssignment::get_achievers(
-    int lmn_status, const LandmarkNode &lmn) const {
+ConstRange<int> LandmarkCostAssignment::get_achievers(
+    int lmn_status, int lm_id) const {
     // Return relevant achievers of the landmark according to its status.
     if (lmn_status == lm_not_reached)
-        return lmn.first_achievers;
+        return lm_graph.get_first_achievers(lm_id);
     else if (lmn_status == lm_needed_again)
-        return lmn.possible_achievers;
+        return lm_graph.get_possible_achievers(lm_id);
     else
-        return empty;
+        return ConstRange<int>(nullptr, nullptr);
 }
 
 
@@ -43,17 +44,17 @@ double LandmarkUniformSharedCostAssignment::cost_sharing_h_value() {
     vector<int> achieved_lms_by_op(operator_costs.size(), 0);
     vector<bool> action_landmarks(operator_costs.size(), false);
 
-    const set<LandmarkNode *> &nodes = lm_graph.get_nodes();
+    int num_landmarks = lm_graph.number_of_landmarks();
 
     double h = 0;
 
     /* First pass:
        compute which op achieves how many landmarks. Along the way,
        mark action landmarks and add their cost to h. */
-    for (const LandmarkNode *node : nodes) {
-        int lmn_status = node->get_status();
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        int lmn_status = lm_graph.get_status(lm_id);
         if (lmn_status != lm_reached) {
-            const set<int> &achievers = get_achievers(lmn_status, *node);
+            ConstRange<int> achievers = get_achievers(lmn_status, lm_id);
             assert(!achievers.empty());
             if (use_action_landmarks && achievers.size() == 1) {
                 // We have found an action landmark for this state.
@@ -72,16 +73,16 @@ double LandmarkUniformSharedCostAssignment::cost_sharing_h_value() {
         }
     }
 
-    vector<LandmarkNode *> relevant_lms;
+    vector<int> relevant_lms;
 
     /* Second pass:
        remove landmarks from consideration that are covered by
        an action landmark; decrease the counters accordingly
        so that no unnecessary cost is assigned to these landmarks. */
-    for (LandmarkNode *node : nodes) {
-        int lmn_status = node->get_status();
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        int lmn_status = lm_graph.get_status(lm_id);
         if (lmn_status != lm_reached) {
-            const set<int> &achievers = get_achievers(lmn_status, *node);
+            ConstRange<int> achievers = get_achievers(lmn_status, lm_id);
             bool covered_by_action_lm = false;
             for (int op_id : achievers) {
                 assert(utils::in_bounds(op_id, action_landmarks));
@@ -96,16 +97,16 @@ double LandmarkUniformSharedCostAssignment::cost_sharing_h_value() {
                     --achieved_lms_by_op[op_id];
                 }
             } else {
-                relevant_lms.push_back(node);
+                relevant_lms.push_back(lm_id);
             }
         }
     }
 
     /* Third pass:
        count shared costs for the remaining landmarks. */
-    for (const LandmarkNode *node : relevant_lms) {
-        int lmn_status = node->get_status();
-        const set<int> &achievers = get_achievers(lmn_status, *node);
+    for (int lm_id : relevant_lms) {
+        int lmn_status = lm_graph.get_status(lm_id);
+        ConstRange<int> achievers = get_achievers(lmn_status, lm_id);
         double min_cost = numeric_limits<double>::max();
         for (int op_id : achievers) {
             assert(utils::in_bounds(op_id, achieved_lms_by_op));
@@ -126,92 +127,116 @@ LandmarkEfficientOptimalSharedCostAssignment::LandmarkEfficientOptimalSharedCost
     const LandmarkGraph &graph,
     lp::LPSolverType solver_type)
     : LandmarkCostAssignment(operator_costs, graph),
-      lp_solver(solver_type) {
-    /* The LP has one variable (column) per landmark and one
-       inequality (row) per operator. */
-    int num_cols = lm_graph.number_of_landmarks();
-    int num_rows = operator_costs.size();
+      lp_solver(solver_type),
+      infinity(lp_solver.get_infinity()) {
+    /* The LP has one variable (column) per landmark and relevant
+       achiever set, and one inequality (row) per operator achieving
+       some landmark.
 
-    /* We want to maximize 1 * cost(lm_1) + ... + 1 * cost(lm_n),
+       We want to maximize 1 * cost(lm_1) + ... + 1 * cost(lm_n),
        so the coefficients are all 1.
        Variable bounds are state-dependent; we initialize the range to {0}. */
-    lp_variables.resize(num_cols, lp::LPVariable(0.0, 0.0, 1.0));
-
-    /* Set up lower bounds and upper bounds for the inequalities.
-       These simply say that the operator's total cost must fall
-       between 0 and the real operator cost. */
-    lp_constraints.resize(num_rows, lp::LPConstraint(0.0, 0.0));
-    for (size_t op_id = 0; op_id < operator_costs.size(); ++op_id) {
-        lp_constraints[op_id].set_lower_bound(0);
-        lp_constraints[op_id].set_upper_bound(operator_costs[op_id]);
+    int num_landmarks = lm_graph.number_of_landmarks();
+    int num_ops = operator_costs.size();
+    vector<lp::LPVariable> lp_variables;
+    vector<lp::LPConstraint> lp_constraints(num_ops, lp::LPConstraint(0.0, 0.0));
+    auto add_column = [&](ConstRange<int> achievers) {
+        int column = lp_variables.size();
+        lp_variables.emplace_back(0.0, 0.0, 1.0);
+        for (int op_id : achievers) {
+            assert(utils::in_bounds(op_id, lp_constraints));
+            lp_constraints[op_id].insert(column, 1.0);
+        }
+        return column;
+    };
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        ConstRange<int> first_achievers = lm_graph.get_first_achievers(lm_id);
+        ConstRange<int> possible_achievers = lm_graph.get_possible_achievers(lm_id);
+        first_achievers_column.push_back(add_column(first_achievers));
+        if (first_achievers.size() == possible_achievers.size() &&
+            equal(first_achievers.begin(), first_achievers.end(),
+                  possible_achievers.begin())) {
+            possible_achievers_column.push_back(first_achievers_column.back());
+        } else {
+            possible_achievers_column.push_back(add_column(possible_achievers));
+        }
+    }
+    column_is_open.resize(lp_variables.size(), false);
+
+    /* The inequalities say that the operator's total cost must fall
+       between 0 and the real operator cost. Rows of operators that
+       achieve no landmark are always satisfied, so we skip them. This
+       significantly speeds up solving the LP. See issue443. */
+    vector<lp::LPConstraint> non_empty_lp_constraints;
+    for (int op_id = 0; op_id < num_ops; ++op_id) {
+        lp::LPConstraint &constraint = lp_constraints[op_id];
+        if (!constraint.empty()) {
+            constraint.set_upper_bound(operator_costs[op_id]);
+            non_empty_lp_constraints.push_back(move(constraint));
+        }
+    }
+    lp_solver.load_problem(lp::LPObjectiveSense::MAXIMIZE,
+                           lp_variables, non_empty_lp_constraints);
+}
+
+void LandmarkEfficientOptimalSharedCostAssignment::compute_status_key() {
+    const int statuses_per_entry = 16;
+    int num_landmarks = lm_graph.number_of_landmarks();
+    status_key.assign(
+        (num_landmarks + statuses_per_entry - 1) / statuses_per_entry, 0);
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        unsigned int status = lm_graph.get_status(lm_id);
+        status_key[lm_id / statuses_per_entry] |=
+            status << (2 * (lm_id % statuses_per_entry));
     }
 }
 
+void LandmarkEfficientOptimalSharedCostAssignment::set_column_open(
+    int column, bool open) {
+    if (column_is_open[column] != open) {
+        lp_solver.set_variable_upper_bound(column, open ? infinity : 0.0);
+        column_is_open[column] = open;
+    }
+}
 
 double LandmarkEfficientOptimalSharedCostAssignment::cost_sharing_h_value() {
     /* TODO: We could also do the same thing with action landmarks we
              do in the uniform cost partitioning case. */
 
-    /*
-      Set up LP variable bounds for the landmarks.
-      The range of cost(lm_1) is {0} if the landmark is already
-      reached; otherwise it is [0, infinity].
-      The lower bounds are set to 0 in the constructor and never change.
-    */
-    int num_cols = lm_graph.number_of_landmarks();
-    for (int lm_id = 0; lm_id < num_cols; ++lm_id) {
-        const LandmarkNode *lm = lm_graph.get_lm_for_index(lm_id);
-        if (lm->get_status() == lm_reached) {
-            lp_variables[lm_id].upper_bound = 0;
-        } else {
-            lp_variables[lm_id].upper_bound = lp_solver.get_infinity();
-        }
-    }
+    compute_status_key();
+    auto it = cached_h_values.find(status_key);
+    if (it != cached_h_values.end())
+        return it->second;
 
     /*
-      Define the constraint matrix. The constraints are of the form
-      cost(lm_i1) + cost(lm_i2) + ... + cost(lm_in) <= cost(o)
-      where lm_i1 ... lm_in are the landmarks for which o is a
-      relevant achiever. Hence, we add a triple (op, lm, 1.0)
-      for each relevant achiever op of landmark lm, denoting that
-      in the op-th row and lm-th column, the matrix has a 1.0 entry.
+      The range of cost(lm_i) is [0, infinity] for the column of the
+      relevant achievers of lm_i and {0} for all other columns.
+      Landmarks that are already reached have no relevant achievers.
     */
-    // Reuse previous constraint objects to save the effort of recreating them.
-    for (lp::LPConstraint &constraint : lp_constraints) {
-        constraint.clear();
-    }
-    for (int lm_id = 0; lm_id < num_cols; ++lm_id) {
-        const LandmarkNode *lm = lm_graph.get_lm_for_index(lm_id);
-        int lm_status = lm->get_status();
-        if (lm_status != lm_reached) {
-            const set<int> &achievers = get_achievers(lm_status, *lm);
-            assert(!achievers.empty());
-            for (int op_id : achievers) {
-                assert(utils::in_bounds(op_id, lp_constraints));
-                lp_constraints[op_id].insert(lm_id, 1.0);
-            }
+    int num_landmarks = lm_graph.number_of_landmarks();
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        int lm_status = lm_graph.get_status(lm_id);
+        int first_column = first_achievers_column[lm_id];
+        int possible_column = possible_achievers_column[lm_id];
+        assert(lm_status == lm_reached ||
+               !get_achievers(lm_status, lm_id).empty());
+        if (first_column == possible_column) {
+            set_column_open(first_column, lm_status != lm_reached);
+        } else {
+            set_column_open(first_column, lm_status == lm_not_reached);
+            set_column_open(possible_column, lm_status == lm_needed_again);
         }
     }
 
-    /* Copy non-empty constraints and use those in the LP.
-       This significantly speeds up the heuristic calculation. See issue443. */
-    // TODO: do not copy the data here.
-    non_empty_lp_constraints.clear();
-    for (const lp::LPConstraint &constraint : lp_constraints) {
-        if (!constraint.empty())
-            non_empty_lp_constraints.push_back(constraint);
-    }
-
-    // Load the problem into the LP solver.
-    lp_solver.load_problem(lp::LPObjectiveSense::MAXIMIZE,
-                           lp_variables, non_empty_lp_constraints);
-
-    // Solve the linear program.
+    // Solve the linear program, starting from the basis of the last call.
     lp_solver.solve();
 
     assert(lp_solver.has_optimal_solution());
     double h = lp_solver.get_objective_value();
 
+    if (static_cast<int>(cached_h_values.size()) >= MAX_CACHED_H_VALUES)
+        cached_h_values.clear();
+    cached_h_values.emplace(status_key, h);
     return h;
 }
 }
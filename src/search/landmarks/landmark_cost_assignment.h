@@ -1,25 +1,24 @@
 #ifndef LANDMARKS_LANDMARK_COST_ASSIGNMENT_H
 #define LANDMARKS_LANDMARK_COST_ASSIGNMENT_H
 
+#include "landmark_graph.h"
+
 #include "../lp/lp_solver.h"
 
-#include <set>
+#include "../utils/hash.h"
+
+#include <unordered_map>
 #include <vector>
 
 class OperatorsProxy;
 
 namespace landmarks {
-class LandmarkGraph;
-class LandmarkNode;
-
 class LandmarkCostAssignment {
-    const std::set<int> empty;
 protected:
     const LandmarkGraph &lm_graph;
     const std::vector<int> operator_costs;
 
-    const std::set<int> &get_achievers(int lmn_status,
-                                       const LandmarkNode &lmn) const;
+    ConstRange<int> get_achievers(int lmn_status, int lm_id) const;
 public:
     LandmarkCostAssignment(const std::vector<int> &operator_costs,
                            const LandmarkGraph &graph);
@@ -39,16 +38,30 @@ public:
 };
 
 class LandmarkEfficientOptimalSharedCostAssignment : public LandmarkCostAssignment {
+    static const int MAX_CACHED_H_VALUES = 100000;
+
     lp::LPSolver lp_solver;
     /*
-      We keep the vectors for LP variables and constraints around instead of
-      recreating them for every state. The actual constraints have to be
-      recreated because the coefficient matrix of the LP changes from state to
-      state. Reusing the vectors still saves some dynamic allocation overhead.
-     */
-    std::vector<lp::LPVariable> lp_variables;
-    std::vector<lp::LPConstraint> lp_constraints;
-    std::vector<lp::LPConstraint> non_empty_lp_constraints;
+      The LP has one column for the first achievers of each landmark and,
+      if they differ, one for its possible achievers. The relevant
+      achievers only depend on the status of the landmark, so the
+      coefficient matrix is the same for all states: a state only opens
+      the upper bounds of the columns matching the landmark statuses and
+      closes all others. We load the LP once, only change the bounds that
+      differ from the previous state and let the solver start from the
+      previous basis.
+    */
+    std::vector<int> first_achievers_column;
+    std::vector<int> possible_achievers_column;
+    std::vector<bool> column_is_open;
+    double infinity;
+
+    // Cache of h values keyed by the landmark statuses (2 bits each).
+    std::vector<unsigned int> status_key;
+    std::unordered_map<std::vector<unsigned int>, double> cached_h_values;
+
+    void compute_status_key();
+    void set_column_open(int column, bool open);
 public:
     LandmarkEfficientOptimalSharedCostAssignment(const std::vector<int> &operator_costs,
                                                  const LandmarkGraph &graph,
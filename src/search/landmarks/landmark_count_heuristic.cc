@@ -78,8 +78,8 @@ LandmarkCountHeuristic::~LandmarkCountHeuristic() {
 
 void LandmarkCountHeuristic::set_exploration_goals(const GlobalState &global_state) {
     // Set additional goals for FF exploration
-    LandmarkSet reached_landmarks = convert_to_landmark_set(
-        lm_status_manager->get_reached_landmarks(global_state));
+    BitsetView reached_landmarks =
+        lm_status_manager->get_reached_landmarks(global_state);
     vector<FactPair> lm_leaves = collect_lm_leaves(
         ff_search_disjunctive_lms, reached_landmarks);
     exploration.set_additional_goals(lm_leaves);
@@ -137,10 +137,10 @@ int LandmarkCountHeuristic::compute_heuristic(const GlobalState &global_state) {
     // reached within next step, helpful actions are those occuring in a plan
     // to achieve one of the LM leaves.
 
-    LandmarkSet reached_lms = convert_to_landmark_set(
-        lm_status_manager->get_reached_landmarks(global_state));
+    BitsetView reached_lms =
+        lm_status_manager->get_reached_landmarks(global_state);
 
-    int num_reached = reached_lms.size();
+    int num_reached = reached_lms.count();
     if (num_reached == lgraph->number_of_landmarks() ||
         !generate_helpful_actions(state, reached_lms)) {
         set_exploration_goals(global_state);
@@ -163,25 +163,26 @@ int LandmarkCountHeuristic::compute_heuristic(const GlobalState &global_state) {
 }
 
 vector<FactPair> LandmarkCountHeuristic::collect_lm_leaves(
-    bool disjunctive_lms, const LandmarkSet &reached_lms) {
+    bool disjunctive_lms, const BitsetView &reached_lms) {
     vector<FactPair> leaves;
-    for (const LandmarkNode *node_p : lgraph->get_nodes()) {
-        if (!disjunctive_lms && node_p->disjunctive)
+    int num_landmarks = lgraph->number_of_landmarks();
+    for (int lm_id = 0; lm_id < num_landmarks; ++lm_id) {
+        if (!disjunctive_lms && lgraph->is_disjunctive(lm_id))
             continue;
 
-        if (!reached_lms.count(node_p) &&
-            !check_node_orders_disobeyed(*node_p, reached_lms)) {
-            leaves.insert(
-                leaves.end(), node_p->facts.begin(), node_p->facts.end());
+        if (!reached_lms.test(lm_id) &&
+            !check_node_orders_disobeyed(lm_id, reached_lms)) {
+            ConstRange<FactPair> facts = lgraph->get_facts(lm_id);
+            leaves.insert(leaves.end(), facts.begin(), facts.end());
         }
     }
     return leaves;
 }
 
-bool LandmarkCountHeuristic::check_node_orders_disobeyed(const LandmarkNode &node,
-                                                         const LandmarkSet &reached) const {
-    for (const auto &parent : node.parents) {
-        if (reached.count(parent.first) == 0) {
+bool LandmarkCountHeuristic::check_node_orders_disobeyed(int lm_id,
+                                                         const BitsetView &reached) const {
+    for (int parent_id : lgraph->get_parents(lm_id)) {
+        if (!reached.test(parent_id)) {
             return true;
         }
     }
@@ -189,7 +190,7 @@ bool LandmarkCountHeuristic::check_node_orders_disobeyed(const LandmarkNode &nod
 }
 
 bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
-                                                      const LandmarkSet &reached) {
+                                                      const BitsetView &reached) {
     /* Find actions that achieve new landmark leaves. If no such action exist,
      return false. If a simple landmark can be achieved, return only operators
      that achieve simple landmarks, else return operators that achieve
@@ -198,6 +199,7 @@ bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
     g_successor_generator->generate_applicable_ops(state, all_operators);
     vector<int> ha_simple;
     vector<int> ha_disj;
+    bool all_reached = reached.count() == lgraph->number_of_landmarks();
 
     for (OperatorProxy op : all_operators) {
         EffectsProxy effects = op.get_effects();
@@ -205,9 +207,10 @@ bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
             if (!does_fire(effect, state))
                 continue;
             FactProxy fact_proxy = effect.get_fact();
-            LandmarkNode *lm_p = lgraph->get_landmark(fact_proxy.get_pair());
-            if (lm_p != 0 && landmark_is_interesting(state, reached, *lm_p)) {
-                if (lm_p->disjunctive) {
+            int lm_id = lgraph->get_landmark_id(fact_proxy.get_pair());
+            if (lm_id != -1 &&
+                landmark_is_interesting(state, reached, all_reached, lm_id)) {
+                if (lgraph->is_disjunctive(lm_id)) {
                     ha_disj.push_back(op.get_id());
                 } else {
                     ha_simple.push_back(op.get_id());
@@ -232,19 +235,19 @@ bool LandmarkCountHeuristic::generate_helpful_actions(const State &state,
 }
 
 bool LandmarkCountHeuristic::landmark_is_interesting(
-    const State &state, const LandmarkSet &reached, LandmarkNode &lm) const {
+    const State &state, const BitsetView &reached, bool all_reached,
+    int lm_id) const {
     /* A landmark is interesting if it hasn't been reached before and
      its parents have all been reached, or if all landmarks have been
      reached before, the LM is a goal, and it's not true at moment */
 
-    int num_reached = reached.size();
-    if (num_reached != lgraph->number_of_landmarks()) {
-        if (reached.find(&lm) != reached.end())
+    if (!all_reached) {
+        if (reached.test(lm_id))
             return false;
         else
-            return !check_node_orders_disobeyed(lm, reached);
+            return !check_node_orders_disobeyed(lm_id, reached);
     }
-    return lm.is_goal() && !lm.is_true_in_state(state);
+    return lgraph->is_goal(lm_id) && !lgraph->is_true_in_state(lm_id, state);
 }
 
 void LandmarkCountHeuristic::notify_initial_state(const GlobalState &initial_state) {
@@ -269,19 +272,6 @@ bool LandmarkCountHeuristic::dead_ends_are_reliable() const {
     return dead_ends_reliable;
 }
 
-// This function exists purely so we don't have to change all the
-// functions in this class that use LandmarkSets for the reached LMs
-// (HACK).
-LandmarkSet LandmarkCountHeuristic::convert_to_landmark_set(
-    const vector<bool> &landmark_vector) {
-    LandmarkSet landmark_set;
-    for (size_t i = 0; i < landmark_vector.size(); ++i)
-        if (landmark_vector[i])
-            landmark_set.insert(lgraph->get_lm_for_index(i));
-    return landmark_set;
-}
-
-
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis("Landmark-count heuristic",
                              "See also Synergy");
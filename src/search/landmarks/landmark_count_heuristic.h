@@ -5,6 +5,7 @@
 #include "landmark_graph.h"
 
 #include "../heuristic.h"
+#include "../per_state_bitset.h"
 
 namespace landmarks {
 class LandmarkCostAssignment;
@@ -26,21 +27,17 @@ class LandmarkCountHeuristic : public Heuristic {
     int get_heuristic_value(const GlobalState &global_state);
 
     std::vector<FactPair> collect_lm_leaves(
-        bool disjunctive_lms, const LandmarkSet &result);
+        bool disjunctive_lms, const BitsetView &reached);
 
     bool check_node_orders_disobeyed(
-        const LandmarkNode &node, const LandmarkSet &reached) const;
-
-    void add_node_children(LandmarkNode &node, const LandmarkSet &reached) const;
+        int lm_id, const BitsetView &reached) const;
 
     bool landmark_is_interesting(
-        const State &state, const LandmarkSet &reached, LandmarkNode &lm) const;
+        const State &state, const BitsetView &reached, bool all_reached,
+        int lm_id) const;
     bool generate_helpful_actions(
-        const State &state, const LandmarkSet &reached);
+        const State &state, const BitsetView &reached);
     void set_exploration_goals(const GlobalState &global_state);
-
-    LandmarkSet convert_to_landmark_set(
-        const std::vector<bool> &landmark_vector);
 protected:
     virtual int compute_heuristic(const GlobalState &state) override;
 public:
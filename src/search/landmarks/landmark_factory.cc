@@ -3,6 +3,7 @@
 #include "landmark_graph.h"
 
 #include "exploration.h"
+#include "landmark_graph_cache.h"
 #include "util.h"
 
 #include "../option_parser.h"
@@ -26,7 +27,8 @@ LandmarkFactory::LandmarkFactory(const options::Options &opts)
       disjunctive_landmarks(opts.get<bool>("disjunctive_landmarks")),
       conjunctive_landmarks(opts.get<bool>("conjunctive_landmarks")),
       no_orders(opts.get<bool>("no_orders")),
-      lm_cost_type(static_cast<OperatorCost>(opts.get_enum("lm_cost_type"))) {
+      lm_cost_type(static_cast<OperatorCost>(opts.get_enum("lm_cost_type"))),
+      cache_directory(opts.get<string>("lm_cache", "")) {
 }
 /*
   Note: To allow reusing landmark graphs, we use the following temporary
@@ -59,11 +61,34 @@ shared_ptr<LandmarkGraph> LandmarkFactory::compute_lm_graph(
         make_shared<tasks::CostAdaptedTask>(options);
     TaskProxy cost_adapted_task_proxy(*cost_adapted_task);
 
-    lm_graph = make_shared<LandmarkGraph>(cost_adapted_task_proxy);
-    generate_landmarks(cost_adapted_task, exploration);
+    unique_ptr<LandmarkGraphCache> cache;
+    LandmarkGraphCacheKey cache_key;
+    if (!cache_directory.empty()) {
+        cache = utils::make_unique_ptr<LandmarkGraphCache>(cache_directory);
+        /*
+          The exploration works on the original costs, so the key
+          describes the original task. The adapted costs follow from the
+          options.
+        */
+        vector<int> factory_options;
+        add_cache_key_options(factory_options);
+        cache_key = compute_landmark_graph_cache_key(
+            TaskProxy(*task), factory_options);
+        lm_graph = cache->load(cost_adapted_task_proxy, cache_key);
+        if (lm_graph)
+            cout << "Loaded landmark graph from cache" << endl;
+    }
 
-    // the following replaces the old "build_lm_graph"
-    generate(cost_adapted_task_proxy, exploration);
+    if (!lm_graph) {
+        lm_graph = make_shared<LandmarkGraph>(cost_adapted_task_proxy);
+        generate_landmarks(cost_adapted_task, exploration);
+
+        // the following replaces the old "build_lm_graph"
+        generate(cost_adapted_task_proxy, exploration);
+        if (cache)
+            cache->store(cache_key, *lm_graph);
+    }
+    lm_graph->freeze();
     cout << "Landmarks generation time: " << lm_generation_timer << endl;
     if (lm_graph->number_of_landmarks() == 0)
         cout << "Warning! No landmarks found. Task unsolvable?" << endl;
@@ -78,6 +103,17 @@ shared_ptr<LandmarkGraph> LandmarkFactory::compute_lm_graph(
     return lm_graph;
 }
 
+void LandmarkFactory::add_common_cache_key_options(
+    LandmarkFactoryType type, vector<int> &options) const {
+    options.push_back(static_cast<int>(type));
+    options.push_back(reasonable_orders);
+    options.push_back(only_causal_landmarks);
+    options.push_back(disjunctive_landmarks);
+    options.push_back(conjunctive_landmarks);
+    options.push_back(no_orders);
+    options.push_back(lm_cost_type);
+}
+
 void LandmarkFactory::generate(const TaskProxy &task_proxy, Exploration &exploration) {
     if (only_causal_landmarks)
         discard_noncausal_landmarks(task_proxy, exploration);
@@ -161,12 +197,17 @@ bool LandmarkFactory::relaxed_task_solvable(const TaskProxy &task_proxy,
                                      numeric_limits<int>::max());
     }
     // Extract propositions from "exclude"
-    unordered_set<int> exclude_op_ids;
+    vector<int> exclude_op_ids;
     vector<FactPair> exclude_props;
     if (exclude) {
-        for (OperatorProxy op : operators) {
-            if (achieves_non_conditional(op, exclude))
-                exclude_op_ids.insert(op.get_id());
+        // Only operators adding a fact of "exclude" can achieve it.
+        for (const FactPair &lm_fact : exclude->facts) {
+            for (int op_or_axiom_id :
+                 lm_graph->get_operators_including_eff(lm_fact)) {
+                if (op_or_axiom_id >= 0 &&
+                    achieves_non_conditional(operators[op_or_axiom_id], exclude))
+                    exclude_op_ids.push_back(op_or_axiom_id);
+            }
         }
         exclude_props.insert(exclude_props.end(),
                              exclude->facts.begin(), exclude->facts.end());
@@ -210,11 +251,11 @@ bool LandmarkFactory::is_causal_landmark(const TaskProxy &task_proxy, Exploratio
         lvl_var[var.get_id()].resize(var.get_domain_size(),
                                      numeric_limits<int>::max());
     }
-    unordered_set<int> exclude_op_ids;
+    vector<int> exclude_op_ids;
     vector<FactPair> exclude_props;
     for (OperatorProxy op : task_proxy.get_operators()) {
         if (is_landmark_precondition(op, &landmark)) {
-            exclude_op_ids.insert(op.get_id());
+            exclude_op_ids.push_back(op.get_id());
         }
     }
     // Do relaxed exploration
@@ -855,6 +896,14 @@ void _add_options_to_parser(OptionParser &parser) {
                            cost_types,
                            "landmark action cost adjustment",
                            "NORMAL");
+    parser.add_option<string>(
+        "lm_cache",
+        "directory for caching landmark graphs on disk. If the directory "
+        "contains a graph for the same task and factory configuration, it "
+        "is loaded instead of generated, and new graphs are written to it. "
+        "The directory must exist. Several planner runs can share one "
+        "directory.",
+        options::OptionParser::NONE);
 }
 
 
@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -26,6 +27,15 @@ class LandmarkGraph;
 class LandmarkNode;
 enum class EdgeType;
 
+// Identifies the type of a landmark factory in landmark graph cache keys.
+enum class LandmarkFactoryType {
+    H_M,
+    MERGED,
+    RPG_EXHAUST,
+    RPG_SASP,
+    ZHU_GIVAN
+};
+
 class LandmarkFactory {
 public:
     explicit LandmarkFactory(const options::Options &opts);
@@ -39,11 +49,24 @@ public:
     bool use_reasonable_orders() const {return reasonable_orders; }
     virtual bool supports_conditional_effects() const = 0;
 
+    /*
+      Append the type of the factory and all options that the generated
+      landmark graph depends on to options. Options that do not affect
+      the graph, such as lm_cache and num_threads, are left out. Together
+      with the task, these values form the key of the landmark graph
+      cache (see landmark_graph_cache.h).
+    */
+    virtual void add_cache_key_options(std::vector<int> &options) const = 0;
+
 protected:
     std::shared_ptr<LandmarkGraph> lm_graph;
 
     bool use_orders() const {return !no_orders; }  // only needed by HMLandmark
 
+    // Append the type and the options shared by all factories.
+    void add_common_cache_key_options(
+        LandmarkFactoryType type, std::vector<int> &options) const;
+
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task, Exploration &exploration) = 0;
     void generate(const TaskProxy &task_proxy, Exploration &exploration);
     void discard_noncausal_landmarks(const TaskProxy &task_proxy, Exploration &exploration);
@@ -76,6 +99,8 @@ private:
     const bool conjunctive_landmarks;
     const bool no_orders;
     const OperatorCost lm_cost_type;
+    // Directory of the on-disk cache (see landmark_graph_cache.h), or empty.
+    const std::string cache_directory;
 
     bool interferes(const TaskProxy &task_proxy,
                     const LandmarkNode *lm_node1,
@@ -6,6 +6,7 @@
 #include "../task_tools.h"
 
 #include "../utils/collections.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 using namespace std;
@@ -94,7 +95,7 @@ void insert_into(list<T> &alist, const T &val) {
 }
 
 template<typename T>
-static bool contains(list<T> &alist, const T &val) {
+static bool contains(const list<T> &alist, const T &val) {
     return find(alist.begin(), alist.end(), val) != alist.end();
 }
 
@@ -447,7 +448,7 @@ void LandmarkFactoryHM::build_pm_ops(const TaskProxy &task_proxy) {
     FluentSet pc, eff;
     vector<FluentSet> pc_subsets, eff_subsets, noop_pc_subsets, noop_eff_subsets;
 
-    static int op_count = 0;
+    int op_count = 0;
     int set_index, noop_index;
 
     OperatorsProxy operators = task_proxy.get_operators();
@@ -561,7 +562,8 @@ bool LandmarkFactoryHM::interesting(const VariablesProxy &variables,
 
 LandmarkFactoryHM::LandmarkFactoryHM(const options::Options &opts)
     : LandmarkFactory(opts),
-      m_(opts.get<int>("m")) {
+      m_(opts.get<int>("m")),
+      num_threads(utils::parse_num_threads_from_options(opts)) {
 }
 
 void LandmarkFactoryHM::initialize(const TaskProxy &task_proxy) {
@@ -688,6 +690,102 @@ void LandmarkFactoryHM::propagate_pm_fact(int factindex, bool newly_discovered,
     }
 }
 
+void LandmarkFactoryHM::collect_pm_op_landmarks(
+    const set<int> &triggered_noops, PMOpLandmarks &result) const {
+    const PMOp &action = pm_ops_[result.op_index];
+    result.landmarks.clear();
+    result.necessary.clear();
+
+    // gather landmarks for pcs
+    // in the set of landmarks for each fact, the fact itself is not stored
+    // (only landmarks preceding it)
+    for (int pc : action.pc) {
+        union_with(result.landmarks, h_m_table_[pc].landmarks);
+        insert_into(result.landmarks, pc);
+
+        if (use_orders()) {
+            insert_into(result.necessary, pc);
+        }
+    }
+
+    result.noops.clear();
+    if (triggered_noops.empty()) {
+        // landmarks changed for action itself, have to recompute
+        // landmarks for all noop effects
+        for (size_t i = 0; i < action.cond_noops.size(); ++i) {
+            // actions pcs are satisfied, but cond. effects may still have
+            // unsatisfied pcs
+            if (unsat_pc_count_[result.op_index].second[i] == 0)
+                result.noops.push_back(i);
+        }
+    } else {
+        // only recompute landmarks for conditions whose
+        // landmarks have changed
+        for (int noop_index : triggered_noops) {
+            assert(unsat_pc_count_[result.op_index].second[noop_index] == 0);
+            result.noops.push_back(noop_index);
+        }
+    }
+
+    result.noop_landmarks.resize(result.noops.size());
+    result.noop_necessary.resize(result.noops.size());
+    for (size_t i = 0; i < result.noops.size(); ++i) {
+        const vector<int> &pc_eff_pair = action.cond_noops[result.noops[i]];
+        list<int> &cn_landmarks = result.noop_landmarks[i];
+        list<int> &cn_necessary = result.noop_necessary[i];
+        cn_landmarks = result.landmarks;
+        if (use_orders())
+            cn_necessary = result.necessary;
+        else
+            cn_necessary.clear();
+
+        for (size_t j = 0; pc_eff_pair[j] != -1; ++j) {
+            int pm_fluent = pc_eff_pair[j];
+            union_with(cn_landmarks, h_m_table_[pm_fluent].landmarks);
+            insert_into(cn_landmarks, pm_fluent);
+
+            if (use_orders()) {
+                insert_into(cn_necessary, pm_fluent);
+            }
+        }
+    }
+}
+
+void LandmarkFactoryHM::update_effect_landmarks(
+    int op_index, int pm_fluent,
+    const list<int> &local_landmarks,
+    const list<int> &local_necessary,
+    int level,
+    TriggerSet &next_trigger) {
+    HMEntry &entry = h_m_table_[pm_fluent];
+    if (entry.level != -1) {
+        size_t prev_size = entry.landmarks.size();
+        intersect_with(entry.landmarks, local_landmarks);
+
+        // if the add effect appears in local landmarks,
+        // fact is being achieved for >1st time
+        // no need to intersect for gn orderings
+        // or add op to first achievers
+        if (!contains(local_landmarks, pm_fluent)) {
+            insert_into(entry.first_achievers, op_index);
+            if (use_orders()) {
+                intersect_with(entry.necessary, local_necessary);
+            }
+        }
+
+        if (entry.landmarks.size() != prev_size)
+            propagate_pm_fact(pm_fluent, false, next_trigger);
+    } else {
+        entry.level = level;
+        entry.landmarks = local_landmarks;
+        if (use_orders()) {
+            entry.necessary = local_necessary;
+        }
+        insert_into(entry.first_achievers, op_index);
+        propagate_pm_fact(pm_fluent, true, next_trigger);
+    }
+}
+
 void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
     // get subsets of initial state
     vector<FluentSet> init_subsets;
@@ -712,93 +810,66 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
         }
     }
 
-    vector<int>::iterator it;
-    TriggerSet::iterator op_it;
-
-    list<int> local_landmarks;
-    list<int> local_necessary;
-
-    size_t prev_size;
+    /*
+      The triggered actions of a level are handled in chunks. First, we
+      compute the landmarks of all actions of a chunk and their
+      conditional noops in parallel, which only reads the table. Then
+      we update the effects in the original order. Actions later in a
+      chunk therefore see older landmark sets than they would if the
+      actions were handled one by one. Since the landmark sets only
+      shrink and every action whose preconditions change is triggered
+      again, this can only delay the fixpoint, not change it. With a
+      single thread, we handle one action at a time, because
+      converging in fewer iterations is faster.
+    */
+    const int chunk_size = (num_threads == 1) ? 1 : 1024;
+    vector<PMOpLandmarks> chunk(chunk_size);
+    vector<const set<int> *> triggered_noops(chunk_size);
 
     int level = 1;
 
     // while we have actions to apply
     while (!current_trigger.empty()) {
-        for (op_it = current_trigger.begin(); op_it != current_trigger.end(); ++op_it) {
-            local_landmarks.clear();
-            local_necessary.clear();
-
-            int op_index = op_it->first;
-            PMOp &action = pm_ops_[op_index];
-
-            // gather landmarks for pcs
-            // in the set of landmarks for each fact, the fact itself is not stored
-            // (only landmarks preceding it)
-            for (it = action.pc.begin(); it != action.pc.end(); ++it) {
-                union_with(local_landmarks, h_m_table_[*it].landmarks);
-                insert_into(local_landmarks, *it);
-
-                if (use_orders()) {
-                    insert_into(local_necessary, *it);
-                }
+        TriggerSet::const_iterator op_it = current_trigger.begin();
+        while (op_it != current_trigger.end()) {
+            int num_ops = 0;
+            for (; op_it != current_trigger.end() && num_ops < chunk_size;
+                 ++op_it, ++num_ops) {
+                chunk[num_ops].op_index = op_it->first;
+                triggered_noops[num_ops] = &op_it->second;
             }
 
-            for (it = action.eff.begin(); it != action.eff.end(); ++it) {
-                if (h_m_table_[*it].level != -1) {
-                    prev_size = h_m_table_[*it].landmarks.size();
-                    intersect_with(h_m_table_[*it].landmarks, local_landmarks);
-
-                    // if the add effect appears in local landmarks,
-                    // fact is being achieved for >1st time
-                    // no need to intersect for gn orderings
-                    // or add op to first achievers
-                    if (!contains(local_landmarks, *it)) {
-                        insert_into(h_m_table_[*it].first_achievers, op_index);
-                        if (use_orders()) {
-                            intersect_with(h_m_table_[*it].necessary, local_necessary);
-                        }
-                    }
-
-                    if (h_m_table_[*it].landmarks.size() != prev_size)
-                        propagate_pm_fact(*it, false, next_trigger);
-                } else {
-                    h_m_table_[*it].level = level;
-                    h_m_table_[*it].landmarks = local_landmarks;
-                    if (use_orders()) {
-                        h_m_table_[*it].necessary = local_necessary;
-                    }
-                    insert_into(h_m_table_[*it].first_achievers, op_index);
-                    propagate_pm_fact(*it, true, next_trigger);
+            utils::run_in_parallel(
+                num_ops, num_threads,
+                [&](int, int i) {
+                    collect_pm_op_landmarks(*triggered_noops[i], chunk[i]);
+                });
+
+            for (int i = 0; i < num_ops; ++i) {
+                const PMOpLandmarks &op_landmarks = chunk[i];
+                int op_index = op_landmarks.op_index;
+                const PMOp &action = pm_ops_[op_index];
+                for (int eff : action.eff) {
+                    update_effect_landmarks(
+                        op_index, eff, op_landmarks.landmarks,
+                        op_landmarks.necessary, level, next_trigger);
                 }
-            }
-
-            // landmarks changed for action itself, have to recompute
-            // landmarks for all noop effects
-            if (op_it->second.empty()) {
-                for (size_t i = 0; i < action.cond_noops.size(); ++i) {
-                    // actions pcs are satisfied, but cond. effects may still have
-                    // unsatisfied pcs
-                    if (unsat_pc_count_[op_index].second[i] == 0) {
-                        compute_noop_landmarks(op_index, i,
-                                               local_landmarks,
-                                               local_necessary,
-                                               level, next_trigger);
+                for (size_t j = 0; j < op_landmarks.noops.size(); ++j) {
+                    const vector<int> &pc_eff_pair =
+                        action.cond_noops[op_landmarks.noops[j]];
+                    // skip the preconditions and the separator
+                    size_t k = 0;
+                    while (pc_eff_pair[k] != -1)
+                        ++k;
+                    for (++k; k < pc_eff_pair.size(); ++k) {
+                        update_effect_landmarks(
+                            op_index, pc_eff_pair[k],
+                            op_landmarks.noop_landmarks[j],
+                            op_landmarks.noop_necessary[j],
+                            level, next_trigger);
                     }
                 }
             }
-            // only recompute landmarks for conditions whose
-            // landmarks have changed
-            else {
-                for (set<int>::iterator noop_it = op_it->second.begin();
-                     noop_it != op_it->second.end(); ++noop_it) {
-                    assert(unsat_pc_count_[op_index].second[*noop_it] == 0);
-
-                    compute_noop_landmarks(op_index, *noop_it,
-                                           local_landmarks,
-                                           local_necessary,
-                                           level, next_trigger);
-                }
-            }
         }
         current_trigger.swap(next_trigger);
         next_trigger.clear();
@@ -809,72 +880,6 @@ void LandmarkFactoryHM::compute_h_m_landmarks(const TaskProxy &task_proxy) {
     cout << "h^m landmarks computed." << endl;
 }
 
-void LandmarkFactoryHM::compute_noop_landmarks(
-    int op_index, int noop_index,
-    list<int> const &local_landmarks,
-    list<int> const &local_necessary,
-    int level,
-    TriggerSet &next_trigger) {
-    list<int> cn_necessary, cn_landmarks;
-    size_t prev_size;
-    int pm_fluent;
-
-    PMOp &action = pm_ops_[op_index];
-    vector<int> &pc_eff_pair = action.cond_noops[noop_index];
-
-    cn_landmarks.clear();
-
-    cn_landmarks = local_landmarks;
-
-    if (use_orders()) {
-        cn_necessary.clear();
-        cn_necessary = local_necessary;
-    }
-
-    size_t i;
-    for (i = 0; (pm_fluent = pc_eff_pair[i]) != -1; ++i) {
-        union_with(cn_landmarks, h_m_table_[pm_fluent].landmarks);
-        insert_into(cn_landmarks, pm_fluent);
-
-        if (use_orders()) {
-            insert_into(cn_necessary, pm_fluent);
-        }
-    }
-
-    // go to the beginning of the effects section
-    ++i;
-
-    for (; i < pc_eff_pair.size(); ++i) {
-        pm_fluent = pc_eff_pair[i];
-        if (h_m_table_[pm_fluent].level != -1) {
-            prev_size = h_m_table_[pm_fluent].landmarks.size();
-            intersect_with(h_m_table_[pm_fluent].landmarks, cn_landmarks);
-
-            // if the add effect appears in cn_landmarks,
-            // fact is being achieved for >1st time
-            // no need to intersect for gn orderings
-            // or add op to first achievers
-            if (!contains(cn_landmarks, pm_fluent)) {
-                insert_into(h_m_table_[pm_fluent].first_achievers, op_index);
-                if (use_orders()) {
-                    intersect_with(h_m_table_[pm_fluent].necessary, cn_necessary);
-                }
-            }
-
-            if (h_m_table_[pm_fluent].landmarks.size() != prev_size)
-                propagate_pm_fact(pm_fluent, false, next_trigger);
-        } else {
-            h_m_table_[pm_fluent].level = level;
-            h_m_table_[pm_fluent].landmarks = cn_landmarks;
-            if (use_orders()) {
-                h_m_table_[pm_fluent].necessary = cn_necessary;
-            }
-            insert_into(h_m_table_[pm_fluent].first_achievers, op_index);
-            propagate_pm_fact(pm_fluent, true, next_trigger);
-        }
-    }
-}
-
 void LandmarkFactoryHM::add_lm_node(int set_index, bool goal) {
     set<FactPair> lm;
 
@@ -972,6 +977,11 @@ bool LandmarkFactoryHM::supports_conditional_effects() const {
     return false;
 }
 
+void LandmarkFactoryHM::add_cache_key_options(vector<int> &options) const {
+    add_common_cache_key_options(LandmarkFactoryType::H_M, options);
+    options.push_back(m_);
+}
+
 static LandmarkFactory *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "h^m Landmarks",
@@ -982,6 +992,7 @@ static LandmarkFactory *_parse(OptionParser &parser) {
         "m, reasonable_orders, conjunctive_landmarks, no_orders");
     parser.add_option<int>(
         "m", "subset size (if unsure, use the default of 2)", "2");
+    utils::add_num_threads_option(parser);
     _add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.help_mode())
@@ -62,12 +62,24 @@ class LandmarkFactoryHM : public LandmarkFactory {
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task,
                                     Exploration &exploration) override;
 
+    // Landmarks of a triggered P^m operator and of its conditional noops.
+    struct PMOpLandmarks {
+        int op_index;
+        std::list<int> landmarks;
+        std::list<int> necessary;
+        std::vector<int> noops;
+        std::vector<std::list<int>> noop_landmarks;
+        std::vector<std::list<int>> noop_necessary;
+    };
+
     void compute_h_m_landmarks(const TaskProxy &task_proxy);
-    void compute_noop_landmarks(int op_index, int noop_index,
-                                std::list<int> const &local_landmarks,
-                                std::list<int> const &local_necessary,
-                                int level,
-                                TriggerSet &next_trigger);
+    void collect_pm_op_landmarks(const std::set<int> &triggered_noops,
+                                 PMOpLandmarks &result) const;
+    void update_effect_landmarks(int op_index, int pm_fluent,
+                                 const std::list<int> &local_landmarks,
+                                 const std::list<int> &local_necessary,
+                                 int level,
+                                 TriggerSet &next_trigger);
 
     void propagate_pm_fact(int fact, bool newly_discovered,
                            TriggerSet &trigger);
@@ -90,6 +102,7 @@ class LandmarkFactoryHM : public LandmarkFactory {
     void print_pm_op(const VariablesProxy &variables, const PMOp &op);
 
     const int m_;
+    const int num_threads;
 
     std::map<int, LandmarkNode *> lm_node_table_;
 
@@ -135,6 +148,7 @@ public:
     explicit LandmarkFactoryHM(const options::Options &opts);
 
     virtual bool supports_conditional_effects() const override;
+    virtual void add_cache_key_options(std::vector<int> &options) const override;
 };
 }
 
@@ -1,12 +1,15 @@
 #include "landmark_factory_merged.h"
 
+#include "exploration.h"
 #include "landmark_graph.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
+#include <algorithm>
 #include <set>
 
 using namespace std;
@@ -17,7 +20,8 @@ class LandmarkNode;
 
 LandmarkFactoryMerged::LandmarkFactoryMerged(const Options &opts)
     : LandmarkFactory(opts),
-      lm_factories(opts.get_list<LandmarkFactory *>("lm_factories")) {
+      lm_factories(opts.get_list<LandmarkFactory *>("lm_factories")),
+      num_threads(utils::parse_num_threads_from_options(opts)) {
 }
 
 LandmarkNode *LandmarkFactoryMerged::get_matching_landmark(const LandmarkNode &lm) const {
@@ -44,8 +48,43 @@ void LandmarkFactoryMerged::generate_landmarks(
     const shared_ptr<AbstractTask> &task, Exploration &exploration) {
     cout << "Merging " << lm_factories.size() << " landmark graphs" << endl;
 
+    /*
+      The component graphs are computed in parallel. A factory that
+      occurs several times must only be used by one job, since factories
+      cache their graph. The first thread uses the given exploration,
+      all other threads use their own copy. The graphs are merged in the
+      original order afterwards, so the result does not depend on the
+      number of threads.
+    */
+    vector<LandmarkFactory *> distinct_factories;
     for (LandmarkFactory *lm_factory : lm_factories) {
-        lm_graphs.push_back(lm_factory->compute_lm_graph(task, exploration));
+        if (find(distinct_factories.begin(), distinct_factories.end(),
+                 lm_factory) == distinct_factories.end())
+            distinct_factories.push_back(lm_factory);
+    }
+    int num_jobs = distinct_factories.size();
+    int used_threads = min(num_threads, num_jobs);
+    vector<unique_ptr<Exploration>> exploration_copies;
+    if (used_threads > 1) {
+        // The initial state of the root task is computed lazily.
+        TaskProxy(*task).get_initial_state();
+        for (int thread_id = 1; thread_id < used_threads; ++thread_id)
+            exploration_copies.push_back(exploration.create_independent_copy());
+    }
+    vector<shared_ptr<LandmarkGraph>> distinct_graphs(num_jobs);
+    utils::run_in_parallel(
+        num_jobs, used_threads,
+        [&](int thread_id, int job_id) {
+            Exploration &thread_exploration = (thread_id == 0) ?
+                exploration : *exploration_copies[thread_id - 1];
+            distinct_graphs[job_id] =
+                distinct_factories[job_id]->compute_lm_graph(
+                    task, thread_exploration);
+        });
+    for (LandmarkFactory *lm_factory : lm_factories) {
+        int index = find(distinct_factories.begin(), distinct_factories.end(),
+                         lm_factory) - distinct_factories.begin();
+        lm_graphs.push_back(distinct_graphs[index]);
     }
 
     cout << "Adding simple landmarks" << endl;
@@ -121,6 +160,18 @@ bool LandmarkFactoryMerged::supports_conditional_effects() const {
     return true;
 }
 
+void LandmarkFactoryMerged::add_cache_key_options(vector<int> &options) const {
+    add_common_cache_key_options(LandmarkFactoryType::MERGED, options);
+    options.push_back(lm_factories.size());
+    for (const LandmarkFactory *lm_factory : lm_factories) {
+        vector<int> factory_options;
+        lm_factory->add_cache_key_options(factory_options);
+        options.push_back(factory_options.size());
+        options.insert(options.end(), factory_options.begin(),
+                       factory_options.end());
+    }
+}
+
 static LandmarkFactory *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Merged Landmarks",
@@ -136,7 +187,12 @@ static LandmarkFactory *_parse(OptionParser &parser) {
     parser.document_note(
         "Note",
         "Does not currently support conjunctive landmarks");
+    parser.document_note(
+        "Parallel computation",
+        "With num_threads > 1, the log output of the component factories "
+        "may be interleaved.");
     parser.add_list_option<LandmarkFactory *>("lm_factories");
+    utils::add_num_threads_option(parser);
     _add_options_to_parser(parser);
     Options opts = parser.parse();
 
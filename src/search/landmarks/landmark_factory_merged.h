@@ -12,6 +12,7 @@ class LandmarkNode;
 class LandmarkFactoryMerged : public LandmarkFactory {
     std::vector<std::shared_ptr<LandmarkGraph>> lm_graphs;
     std::vector<LandmarkFactory *> lm_factories;
+    const int num_threads;
 
     virtual void generate_landmarks(const std::shared_ptr<AbstractTask> &task, Exploration &exploration) override;
     LandmarkNode *get_matching_landmark(const LandmarkNode &lm) const;
@@ -19,6 +20,7 @@ public:
     explicit LandmarkFactoryMerged(const options::Options &opts);
 
     virtual bool supports_conditional_effects() const override;
+    virtual void add_cache_key_options(std::vector<int> &options) const override;
 };
 }
 
@@ -54,6 +54,10 @@ bool LandmarkFactoryRpgExhaust::supports_conditional_effects() const {
     return false;
 }
 
+void LandmarkFactoryRpgExhaust::add_cache_key_options(vector<int> &options) const {
+    add_common_cache_key_options(LandmarkFactoryType::RPG_EXHAUST, options);
+}
+
 static LandmarkFactory *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Exhaustive Landmarks",
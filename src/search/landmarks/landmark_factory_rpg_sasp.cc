@@ -599,6 +599,10 @@ bool LandmarkFactoryRpgSasp::supports_conditional_effects() const {
     return true;
 }
 
+void LandmarkFactoryRpgSasp::add_cache_key_options(vector<int> &options) const {
+    add_common_cache_key_options(LandmarkFactoryType::RPG_SASP, options);
+}
+
 static LandmarkFactory *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "RHW Landmarks",
@@ -59,6 +59,7 @@ public:
     explicit LandmarkFactoryRpgSasp(const options::Options &opts);
 
     virtual bool supports_conditional_effects() const override;
+    virtual void add_cache_key_options(std::vector<int> &options) const override;
 };
 }
 
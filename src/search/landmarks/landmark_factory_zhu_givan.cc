@@ -304,6 +304,10 @@ bool LandmarkFactoryZhuGivan::supports_conditional_effects() const {
     return true;
 }
 
+void LandmarkFactoryZhuGivan::add_cache_key_options(vector<int> &options) const {
+    add_common_cache_key_options(LandmarkFactoryType::ZHU_GIVAN, options);
+}
+
 static LandmarkFactory *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Zhu/Givan Landmarks",
@@ -4,6 +4,7 @@
 
 #include "../task_proxy.h"
 
+#include <algorithm>
 #include <cassert>
 #include <list>
 #include <map>
@@ -80,17 +81,16 @@ void LandmarkGraph::count_costs() {
     reached_cost = 0;
     needed_cost = 0;
 
-    set<LandmarkNode *>::iterator node_it;
-    for (node_it = nodes.begin(); node_it != nodes.end(); ++node_it) {
-        LandmarkNode &node = **node_it;
-
-        switch (node.status) {
+    int num_landmarks = statuses.size();
+    for (int id = 0; id < num_landmarks; ++id) {
+        int min_cost = get_min_cost(id);
+        switch (statuses[id]) {
         case lm_reached:
-            reached_cost += node.min_cost;
+            reached_cost += min_cost;
             break;
         case lm_needed_again:
-            reached_cost += node.min_cost;
-            needed_cost += node.min_cost;
+            reached_cost += min_cost;
+            needed_cost += min_cost;
             break;
         case lm_not_reached:
             break;
@@ -98,6 +98,59 @@ void LandmarkGraph::count_costs() {
     }
 }
 
+static vector<int> get_sorted_ids(
+    const unordered_map<LandmarkNode *, EdgeType> &neighbors,
+    EdgeType min_type) {
+    vector<int> ids;
+    for (const auto &neighbor : neighbors) {
+        if (neighbor.second >= min_type)
+            ids.push_back(neighbor.first->get_id());
+    }
+    sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void LandmarkGraph::freeze() {
+    int num_landmarks = ordered_nodes.size();
+    frozen_landmarks.clear();
+    frozen_landmarks.reserve(num_landmarks);
+    frozen_facts = CompressedLists<FactPair>();
+    frozen_parents = CompressedLists<int>();
+    frozen_greedy_necessary_children = CompressedLists<int>();
+    frozen_first_achievers = CompressedLists<int>();
+    frozen_possible_achievers = CompressedLists<int>();
+    for (const LandmarkNode *node : ordered_nodes) {
+        frozen_landmarks.push_back(
+            {node->min_cost, node->disjunctive, node->in_goal,
+             node->is_derived});
+        frozen_facts.push_back(node->facts);
+        frozen_parents.push_back(
+            get_sorted_ids(node->parents, EdgeType::obedient_reasonable));
+        frozen_greedy_necessary_children.push_back(
+            get_sorted_ids(node->children, EdgeType::greedy_necessary));
+        frozen_first_achievers.push_back(node->first_achievers);
+        frozen_possible_achievers.push_back(node->possible_achievers);
+    }
+
+    int num_facts = 0;
+    fact_offsets.clear();
+    for (const vector<vector<int>> &achievers_by_value : operators_eff_lookup) {
+        fact_offsets.push_back(num_facts);
+        num_facts += achievers_by_value.size();
+    }
+    fact_to_landmark_id.assign(num_facts, -1);
+    // Simple landmarks take precedence, as in get_landmark().
+    for (const auto *lms_to_nodes : {&disj_lms_to_nodes, &simple_lms_to_nodes}) {
+        for (const auto &entry : *lms_to_nodes) {
+            const FactPair &fact = entry.first;
+            fact_to_landmark_id[fact_offsets[fact.var] + fact.value] =
+                entry.second->get_id();
+        }
+    }
+
+    statuses.assign(num_landmarks, lm_not_reached);
+}
+
 bool LandmarkGraph::simple_landmark_exists(const FactPair &lm) const {
     auto it = simple_lms_to_nodes.find(lm);
     assert(it == simple_lms_to_nodes.end() || !it->second->disjunctive);
@@ -35,8 +35,7 @@ class LandmarkNode {
 public:
     LandmarkNode(std::vector<FactPair> &facts, bool disj, bool conj = false)
         : id(-1), facts(facts), disjunctive(disj), conjunctive(conj), in_goal(false),
-          min_cost(1), shared_cost(0.0), status(lm_not_reached),
-          is_derived(false) {
+          min_cost(1), shared_cost(0.0), is_derived(false) {
     }
 
     std::vector<FactPair> facts;
@@ -48,7 +47,6 @@ public:
     int min_cost; // minimal cost of achieving operators
     double shared_cost;
 
-    landmark_status status;
     bool is_derived;
 
     std::unordered_set<FactPair> forward_orders;
@@ -103,10 +101,6 @@ public:
             return true;
         }
     }
-
-    int get_status() const {
-        return status;
-    }
 };
 
 struct LandmarkNodeComparer {
@@ -125,10 +119,67 @@ struct LandmarkNodeComparer {
     }
 };
 
+/*
+  A contiguous range of values in the flat representation of a landmark
+  graph. It stays valid as long as the graph.
+*/
+template<typename T>
+class ConstRange {
+    const T *first;
+    const T *last;
+public:
+    ConstRange(const T *first, const T *last)
+        : first(first), last(last) {
+    }
+
+    const T *begin() const {
+        return first;
+    }
+
+    const T *end() const {
+        return last;
+    }
+
+    std::size_t size() const {
+        return last - first;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+};
 
-using LandmarkSet = std::unordered_set<const LandmarkNode *>;
+// Lists of values stored back to back in one vector (CSR format).
+template<typename T>
+class CompressedLists {
+    std::vector<int> offsets;
+    std::vector<T> values;
+public:
+    CompressedLists()
+        : offsets(1, 0) {
+    }
+
+    template<typename Container>
+    void push_back(const Container &list) {
+        values.insert(values.end(), list.begin(), list.end());
+        offsets.push_back(values.size());
+    }
+
+    ConstRange<T> operator[](int index) const {
+        return ConstRange<T>(values.data() + offsets[index],
+                             values.data() + offsets[index + 1]);
+    }
+};
 
 class LandmarkGraph {
+    // Per-landmark data of the flat representation, see freeze().
+    struct FrozenLandmark {
+        int min_cost;
+        bool disjunctive;
+        bool in_goal;
+        bool is_derived;
+    };
+
 public:
     // ------------------------------------------------------------------------------
     // methods needed only by non-landmarkgraph-factories
@@ -139,6 +190,69 @@ public:
     int get_reached_cost() const {return reached_cost; }
     LandmarkNode *get_landmark(const FactPair &fact) const;
 
+    /*
+      Store the finished graph in flat arrays indexed by landmark ID,
+      which the following methods use. The per-state computations of
+      the heuristics only use these methods, so they work on contiguous
+      memory instead of following pointers between nodes. Lists of IDs
+      are sorted. LandmarkFactory::compute_lm_graph calls this after the
+      last change to the graph.
+    */
+    void freeze();
+
+    ConstRange<int> get_parents(int id) const {
+        return frozen_parents[id];
+    }
+
+    // Children ordered after the landmark by greedy-necessary or stronger orderings.
+    ConstRange<int> get_greedy_necessary_children(int id) const {
+        return frozen_greedy_necessary_children[id];
+    }
+
+    ConstRange<int> get_first_achievers(int id) const {
+        return frozen_first_achievers[id];
+    }
+
+    ConstRange<int> get_possible_achievers(int id) const {
+        return frozen_possible_achievers[id];
+    }
+
+    ConstRange<FactPair> get_facts(int id) const {
+        return frozen_facts[id];
+    }
+
+    int get_min_cost(int id) const {
+        return frozen_landmarks[id].min_cost;
+    }
+
+    bool is_disjunctive(int id) const {
+        return frozen_landmarks[id].disjunctive;
+    }
+
+    bool is_goal(int id) const {
+        return frozen_landmarks[id].in_goal;
+    }
+
+    bool is_derived(int id) const {
+        return frozen_landmarks[id].is_derived;
+    }
+
+    // Return the ID of the simple or disjunctive landmark containing fact, or -1.
+    int get_landmark_id(const FactPair &fact) const {
+        return fact_to_landmark_id[fact_offsets[fact.var] + fact.value];
+    }
+
+    template<typename StateType>
+    bool is_true_in_state(int id, const StateType &state) const;
+
+    landmark_status get_status(int id) const {
+        return statuses[id];
+    }
+
+    void set_status(int id, landmark_status status) {
+        statuses[id] = status;
+    }
+
     // ------------------------------------------------------------------------------
     // methods needed by both landmarkgraph-factories and non-landmarkgraph-factories
     inline const std::set<LandmarkNode *> &get_nodes() const {
@@ -194,6 +308,8 @@ public:
     void dump_node(const VariablesProxy &variables, const LandmarkNode *node_p) const;
     void dump(const VariablesProxy &variables) const;
 private:
+    friend class LandmarkGraphCache;
+
     void generate_operators_lookups(const TaskProxy &task_proxy);
     int landmarks_count;
     int conj_lms;
@@ -205,7 +321,45 @@ private:
     std::set<LandmarkNode *> nodes;
     std::vector<LandmarkNode *> ordered_nodes;
     std::vector<std::vector<std::vector<int>>> operators_eff_lookup;
+
+    // Flat representation, see freeze().
+    std::vector<FrozenLandmark> frozen_landmarks;
+    CompressedLists<FactPair> frozen_facts;
+    CompressedLists<int> frozen_parents;
+    CompressedLists<int> frozen_greedy_necessary_children;
+    CompressedLists<int> frozen_first_achievers;
+    CompressedLists<int> frozen_possible_achievers;
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_to_landmark_id;
+    std::vector<landmark_status> statuses;
 };
+
+inline int get_fact_value(const GlobalState &state, int var) {
+    return state[var];
+}
+
+inline int get_fact_value(const State &state, int var) {
+    return state[var].get_value();
+}
+
+template<typename StateType>
+bool LandmarkGraph::is_true_in_state(int id, const StateType &state) const {
+    if (is_disjunctive(id)) {
+        for (const FactPair &fact : get_facts(id)) {
+            if (get_fact_value(state, fact.var) == fact.value) {
+                return true;
+            }
+        }
+        return false;
+    } else { // conjunctive or simple
+        for (const FactPair &fact : get_facts(id)) {
+            if (get_fact_value(state, fact.var) != fact.value) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
 }
 
 #endif
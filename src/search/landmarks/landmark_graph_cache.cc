@@ -0,0 +1,369 @@
+#include "landmark_graph_cache.h"
+
+#include "landmark_graph.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/system.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace landmarks {
+// Change the version whenever the file format or the key changes.
+static const uint64_t FILE_MAGIC = 0x3230304d474c4446ULL; // "FDLMG002"
+
+/*
+  A file consists of the header, the key_size words of the key and the
+  num_values ints describing the graph.
+*/
+struct FileHeader {
+    uint64_t magic;
+    uint64_t key_hash;
+    uint64_t key_size;
+    uint64_t num_values;
+};
+
+// Separates lists in the key. Task values are never this large.
+static const uint64_t SEPARATOR = numeric_limits<uint64_t>::max();
+
+static atomic<int> num_temporary_files(0);
+static atomic<bool> reported_write_error(false);
+
+static uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+class KeyBuilder {
+    LandmarkGraphCacheKey key;
+public:
+    KeyBuilder() {
+        key.hash = FILE_MAGIC;
+    }
+
+    void add(uint64_t value) {
+        key.words.push_back(value);
+        key.hash = mix(key.hash ^ mix(value + 0x9e3779b97f4a7c15ULL));
+    }
+
+    void add(const FactProxy &fact) {
+        add(fact.get_variable().get_id());
+        add(fact.get_value());
+    }
+
+    LandmarkGraphCacheKey get_key() {
+        return move(key);
+    }
+};
+
+static void add_operator(KeyBuilder &builder, const OperatorProxy &op) {
+    builder.add(op.get_cost());
+    for (FactProxy pre : op.get_preconditions())
+        builder.add(pre);
+    builder.add(SEPARATOR);
+    for (EffectProxy effect : op.get_effects()) {
+        for (FactProxy condition : effect.get_conditions())
+            builder.add(condition);
+        builder.add(SEPARATOR);
+        builder.add(effect.get_fact());
+    }
+    builder.add(SEPARATOR);
+}
+
+LandmarkGraphCacheKey compute_landmark_graph_cache_key(
+    const TaskProxy &task_proxy, const vector<int> &factory_options) {
+    KeyBuilder builder;
+    builder.add(factory_options.size());
+    for (int value : factory_options)
+        builder.add(value);
+
+    VariablesProxy variables = task_proxy.get_variables();
+    builder.add(variables.size());
+    for (VariableProxy var : variables) {
+        builder.add(var.get_domain_size());
+        if (var.is_derived()) {
+            builder.add(var.get_axiom_layer());
+            builder.add(var.get_default_axiom_value());
+        } else {
+            builder.add(SEPARATOR);
+        }
+    }
+
+    // h^m landmarks and reasonable orders depend on the mutexes.
+    for (VariableProxy var1 : variables) {
+        for (int value1 = 0; value1 < var1.get_domain_size(); ++value1) {
+            FactProxy fact1 = var1.get_fact(value1);
+            for (size_t var2_id = var1.get_id() + 1;
+                 var2_id < variables.size(); ++var2_id) {
+                VariableProxy var2 = variables[var2_id];
+                for (int value2 = 0; value2 < var2.get_domain_size(); ++value2) {
+                    if (fact1.is_mutex(var2.get_fact(value2))) {
+                        builder.add(fact1);
+                        builder.add(var2.get_fact(value2));
+                    }
+                }
+            }
+        }
+    }
+    builder.add(SEPARATOR);
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    builder.add(operators.size());
+    for (OperatorProxy op : operators)
+        add_operator(builder, op);
+    AxiomsProxy axioms = task_proxy.get_axioms();
+    builder.add(axioms.size());
+    for (OperatorProxy axiom : axioms)
+        add_operator(builder, axiom);
+
+    State initial_state = task_proxy.get_initial_state();
+    for (int value : initial_state.get_values())
+        builder.add(value);
+    for (FactProxy goal : task_proxy.get_goals())
+        builder.add(goal);
+    return builder.get_key();
+}
+
+/*
+  Read values from a file and check that they lie in the given bounds.
+  After the first error, all further reads fail.
+*/
+class ValueReader {
+    const vector<int> &values;
+    size_t pos;
+    bool valid;
+public:
+    explicit ValueReader(const vector<int> &values)
+        : values(values),
+          pos(0),
+          valid(true) {
+    }
+
+    int read(int min_value, int max_value) {
+        if (!valid || pos == values.size() ||
+            values[pos] < min_value || values[pos] > max_value) {
+            valid = false;
+            return min_value;
+        }
+        return values[pos++];
+    }
+
+    FactPair read_fact(const VariablesProxy &variables) {
+        int var = read(0, variables.size() - 1);
+        if (!valid)
+            return FactPair::no_fact;
+        int value = read(0, variables[var].get_domain_size() - 1);
+        return FactPair(var, value);
+    }
+
+    bool is_valid() const {
+        return valid;
+    }
+
+    bool is_at_end() const {
+        return pos == values.size();
+    }
+};
+
+enum NodeFlags {
+    DISJUNCTIVE = 1,
+    CONJUNCTIVE = 2,
+    IN_GOAL = 4,
+    IS_DERIVED = 8
+};
+
+static const int MAX_INT = numeric_limits<int>::max();
+
+LandmarkGraphCache::LandmarkGraphCache(const string &directory)
+    : directory(directory) {
+}
+
+string LandmarkGraphCache::get_path(const LandmarkGraphCacheKey &key) const {
+    ostringstream path;
+    path << directory << "/" << hex << setw(16) << setfill('0') << key.hash
+         << ".lmg";
+    return path.str();
+}
+
+shared_ptr<LandmarkGraph> LandmarkGraphCache::load(
+    const TaskProxy &task_proxy, const LandmarkGraphCacheKey &key) const {
+    ifstream file(get_path(key), ios::binary);
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        header.magic != FILE_MAGIC || header.key_hash != key.hash ||
+        header.key_size != key.words.size() ||
+        header.num_values > static_cast<uint64_t>(MAX_INT))
+        return nullptr;
+    /*
+      Different keys can have the same hash, so we compare the complete
+      key before reading the graph.
+    */
+    vector<uint64_t> key_words(key.words.size());
+    if (!file.read(reinterpret_cast<char *>(key_words.data()),
+                   key_words.size() * sizeof(uint64_t)) ||
+        key_words != key.words)
+        return nullptr;
+    vector<int> values(header.num_values);
+    if (!file.read(reinterpret_cast<char *>(values.data()),
+                   values.size() * sizeof(int)) ||
+        file.peek() != char_traits<char>::eof())
+        return nullptr;
+
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_values = values.size();
+    int num_operators = task_proxy.get_operators().size();
+    int num_axioms = task_proxy.get_axioms().size();
+    ValueReader reader(values);
+
+    int landmarks_cost = reader.read(0, MAX_INT);
+    int num_nodes = reader.read(0, num_values);
+    // Nodes are owned by the graph only once the whole file is valid.
+    vector<unique_ptr<LandmarkNode>> nodes;
+    nodes.reserve(num_nodes);
+    for (int id = 0; id < num_nodes && reader.is_valid(); ++id) {
+        int num_facts = reader.read(1, num_values);
+        vector<FactPair> facts;
+        for (int i = 0; i < num_facts && reader.is_valid(); ++i)
+            facts.push_back(reader.read_fact(variables));
+        int flags = reader.read(
+            0, DISJUNCTIVE | CONJUNCTIVE | IN_GOAL | IS_DERIVED);
+        nodes.emplace_back(new LandmarkNode(
+            facts, flags & DISJUNCTIVE, flags & CONJUNCTIVE));
+        LandmarkNode &node = *nodes.back();
+        node.in_goal = flags & IN_GOAL;
+        node.is_derived = flags & IS_DERIVED;
+        node.min_cost = reader.read(0, MAX_INT);
+        for (set<int> *achievers :
+             {&node.first_achievers, &node.possible_achievers}) {
+            int num_achievers = reader.read(0, num_values);
+            for (int i = 0; i < num_achievers && reader.is_valid(); ++i)
+                achievers->insert(reader.read(-num_axioms, num_operators - 1));
+        }
+    }
+    for (int id = 0; id < num_nodes && reader.is_valid(); ++id) {
+        int num_children = reader.read(0, num_nodes);
+        for (int i = 0; i < num_children && reader.is_valid(); ++i) {
+            int child_id = reader.read(0, num_nodes - 1);
+            EdgeType type = static_cast<EdgeType>(reader.read(
+                static_cast<int>(EdgeType::obedient_reasonable),
+                static_cast<int>(EdgeType::necessary)));
+            if (reader.is_valid()) {
+                nodes[id]->children.emplace(nodes[child_id].get(), type);
+                nodes[child_id]->parents.emplace(nodes[id].get(), type);
+            }
+        }
+    }
+    auto lm_graph = make_shared<LandmarkGraph>(task_proxy);
+    for (unordered_map<FactPair, LandmarkNode *> *lms_to_nodes :
+         {&lm_graph->simple_lms_to_nodes, &lm_graph->disj_lms_to_nodes}) {
+        int num_entries = reader.read(0, num_values);
+        for (int i = 0; i < num_entries && reader.is_valid(); ++i) {
+            FactPair fact = reader.read_fact(variables);
+            int id = reader.read(0, num_nodes - 1);
+            if (reader.is_valid())
+                lms_to_nodes->emplace(fact, nodes[id].get());
+        }
+    }
+    if (!reader.is_valid() || !reader.is_at_end())
+        return nullptr;
+
+    for (unique_ptr<LandmarkNode> &node : nodes) {
+        if (node->conjunctive)
+            ++lm_graph->conj_lms;
+        lm_graph->nodes.insert(node.release());
+    }
+    lm_graph->landmarks_count = num_nodes;
+    lm_graph->set_landmark_cost(landmarks_cost);
+    lm_graph->set_landmark_ids();
+    return lm_graph;
+}
+
+void LandmarkGraphCache::store(
+    const LandmarkGraphCacheKey &key, const LandmarkGraph &lm_graph) const {
+    vector<int> values;
+    values.push_back(lm_graph.cost_of_landmarks());
+    int num_nodes = lm_graph.number_of_landmarks();
+    values.push_back(num_nodes);
+    auto add_fact = [&values](const FactPair &fact) {
+        values.push_back(fact.var);
+        values.push_back(fact.value);
+    };
+    for (int id = 0; id < num_nodes; ++id) {
+        const LandmarkNode &node = *lm_graph.get_lm_for_index(id);
+        values.push_back(node.facts.size());
+        for (const FactPair &fact : node.facts)
+            add_fact(fact);
+        values.push_back((node.disjunctive ? DISJUNCTIVE : 0) |
+                         (node.conjunctive ? CONJUNCTIVE : 0) |
+                         (node.in_goal ? IN_GOAL : 0) |
+                         (node.is_derived ? IS_DERIVED : 0));
+        values.push_back(node.min_cost);
+        for (const set<int> *achievers :
+             {&node.first_achievers, &node.possible_achievers}) {
+            values.push_back(achievers->size());
+            values.insert(values.end(), achievers->begin(), achievers->end());
+        }
+    }
+    for (int id = 0; id < num_nodes; ++id) {
+        const LandmarkNode &node = *lm_graph.get_lm_for_index(id);
+        values.push_back(node.children.size());
+        for (const auto &child : node.children) {
+            values.push_back(child.first->get_id());
+            values.push_back(static_cast<int>(child.second));
+        }
+    }
+    for (const unordered_map<FactPair, LandmarkNode *> *lms_to_nodes :
+         {&lm_graph.simple_lms_to_nodes, &lm_graph.disj_lms_to_nodes}) {
+        values.push_back(lms_to_nodes->size());
+        for (const auto &entry : *lms_to_nodes) {
+            add_fact(entry.first);
+            values.push_back(entry.second->get_id());
+        }
+    }
+
+    FileHeader header;
+    header.magic = FILE_MAGIC;
+    header.key_hash = key.hash;
+    header.key_size = key.words.size();
+    header.num_values = values.size();
+
+    string path = get_path(key);
+    ostringstream temporary_path;
+    temporary_path << path << ".tmp." << utils::get_process_id() << "."
+                   << num_temporary_files++;
+    bool success;
+    {
+        ofstream file(temporary_path.str(), ios::binary);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(key.words.data()),
+                   key.words.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char *>(values.data()),
+                   values.size() * sizeof(int));
+        file.close();
+        success = static_cast<bool>(file);
+    }
+    if (success)
+        success = rename(temporary_path.str().c_str(), path.c_str()) == 0;
+    if (!success) {
+        remove(temporary_path.str().c_str());
+        if (!reported_write_error.exchange(true)) {
+            cerr << "Warning: could not write landmark graph cache file "
+                 << path << endl;
+        }
+    }
+}
+}
@@ -0,0 +1,63 @@
+#ifndef LANDMARKS_LANDMARK_GRAPH_CACHE_H
+#define LANDMARKS_LANDMARK_GRAPH_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TaskProxy;
+
+namespace landmarks {
+class LandmarkGraph;
+
+/*
+  On-disk cache of landmark graphs, shared by planner runs.
+
+  Every graph is stored in its own file "<hash>.lmg" in the cache
+  directory. The key of a graph describes the task and the options of
+  the landmark factory (see compute_landmark_graph_cache_key), so
+  repeated runs of the same configuration on the same task load the
+  finished graph instead of generating it. The hash of the key only
+  selects the file name. Each file also stores the full key, and a file
+  whose key differs from the requested one is treated like a missing
+  file.
+
+  As for the PDB cache, files are written under a temporary name and
+  then renamed, the cache never deletes files, and invalid files are
+  ignored and overwritten.
+*/
+struct LandmarkGraphCacheKey {
+    std::vector<std::uint64_t> words;
+    std::uint64_t hash;
+};
+
+class LandmarkGraphCache {
+    std::string directory;
+
+    std::string get_path(const LandmarkGraphCacheKey &key) const;
+public:
+    explicit LandmarkGraphCache(const std::string &directory);
+
+    /*
+      Return nullptr if there is no valid file for key. task_proxy is the
+      task of the landmark graph, i.e., the task passed to the
+      LandmarkGraph constructor.
+    */
+    std::shared_ptr<LandmarkGraph> load(
+        const TaskProxy &task_proxy, const LandmarkGraphCacheKey &key) const;
+    void store(
+        const LandmarkGraphCacheKey &key, const LandmarkGraph &lm_graph) const;
+};
+
+/*
+  The key consists of the options of the factory (see
+  LandmarkFactory::add_cache_key_options) and the variables, operators,
+  axioms, mutexes, initial state and goal of the task. The costs used
+  for the landmark graph are determined by the task and the options.
+*/
+extern LandmarkGraphCacheKey compute_landmark_graph_cache_key(
+    const TaskProxy &task_proxy, const std::vector<int> &factory_options);
+}
+
+#endif
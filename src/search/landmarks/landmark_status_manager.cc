@@ -2,22 +2,31 @@
 
 #include "landmark_graph.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace landmarks {
+/*
+  Bitsets of states that have not been reached yet have all bits set.
+  Intersecting with such a bitset has no effect, so we don't have to
+  distinguish between new and old states when updating the landmarks.
+*/
 LandmarkStatusManager::LandmarkStatusManager(LandmarkGraph &graph)
-    : lm_graph(graph),
+    : reached_lms(graph.number_of_landmarks(), true),
+      old_reached(BitsetView::compute_num_blocks(graph.number_of_landmarks())),
+      lm_graph(graph),
       do_intersection(true) {
 }
 
-vector<bool> &LandmarkStatusManager::get_reached_landmarks(const GlobalState &state) {
+BitsetView LandmarkStatusManager::get_reached_landmarks(const GlobalState &state) {
     return reached_lms[state];
 }
 
 void LandmarkStatusManager::set_landmarks_for_initial_state(
     const GlobalState &initial_state) {
-    vector<bool> &reached = get_reached_landmarks(initial_state);
-    reached.resize(lm_graph.number_of_landmarks());
+    BitsetView reached = get_reached_landmarks(initial_state);
+    reached.reset();
 
     int inserted = 0;
     int num_goal_lms = 0;
@@ -40,13 +49,13 @@ void LandmarkStatusManager::set_landmarks_for_initial_state(
                 }
             }
             if (lm_true) {
-                reached[node_p->get_id()] = true;
+                reached.set(node_p->get_id());
                 ++inserted;
             }
         } else {
             for (const FactPair &fact : node_p->facts) {
                 if (initial_state[fact.var] == fact.value) {
-                    reached[node_p->get_id()] = true;
+                    reached.set(node_p->get_id());
                     ++inserted;
                     break;
                 }
@@ -61,39 +70,52 @@ void LandmarkStatusManager::set_landmarks_for_initial_state(
 bool LandmarkStatusManager::update_reached_lms(const GlobalState &parent_global_state,
                                                const GlobalOperator &,
                                                const GlobalState &global_state) {
-    vector<bool> &parent_reached = get_reached_landmarks(parent_global_state);
-    vector<bool> &reached = get_reached_landmarks(global_state);
+    using Block = BitsetView::Block;
+    BitsetView parent_reached = get_reached_landmarks(parent_global_state);
+    BitsetView reached = get_reached_landmarks(global_state);
 
-    if (&parent_reached == &reached) {
+    if (parent_reached.get_blocks() == reached.get_blocks()) {
         assert(global_state.get_id() == parent_global_state.get_id());
         // This can happen, e.g., in Satellite-01.
         return false;
     }
 
-    bool intersect = (do_intersection && !reached.empty());
-    vector<bool> old_reached;
-    if (intersect) {
-        // Save old reached landmarks for this state.
-        // Swapping is faster than old_reached = reached, and we assign
-        // a new value to reached next anyway.
-        old_reached.swap(reached);
-    }
-
-    reached = parent_reached;
-
     int num_landmarks = lm_graph.number_of_landmarks();
-    assert(static_cast<int>(reached.size()) == num_landmarks);
-    assert(static_cast<int>(parent_reached.size()) == num_landmarks);
-    assert(!intersect || static_cast<int>(old_reached.size()) == num_landmarks);
-
-    for (int id = 0; id < num_landmarks; ++id) {
-        if (intersect && !old_reached[id]) {
-            reached[id] = false;
-        } else if (!reached[id]) {
-            LandmarkNode *node = lm_graph.get_lm_for_index(id);
-            if (node->is_true_in_state(global_state)) {
-                if (landmark_is_leaf(*node, reached)) {
-                    reached[id] = true;
+    int num_blocks = reached.get_num_blocks();
+    assert(reached.size() == num_landmarks);
+    assert(parent_reached.size() == num_landmarks);
+    assert(static_cast<int>(old_reached.size()) == num_blocks);
+
+    if (do_intersection) {
+        const Block *blocks = reached.get_blocks();
+        copy(blocks, blocks + num_blocks, old_reached.begin());
+    }
+    reached.assign(parent_reached);
+
+    /*
+      Only landmarks that are not reached in the parent or that are
+      removed by the intersection can change their status, so we skip
+      all blocks without such landmarks. Within a block, we handle the
+      landmarks in order of their IDs, since landmark_is_leaf looks at
+      the partially updated bitset.
+    */
+    const Block *parent_blocks = parent_reached.get_blocks();
+    for (int block = 0; block < num_blocks; ++block) {
+        Block candidates = ~parent_blocks[block];
+        if (do_intersection)
+            candidates |= ~old_reached[block];
+        for (int id = block * BitsetView::bits_per_block;
+             candidates && id < num_landmarks; ++id, candidates >>= 1) {
+            if (!(candidates & 1))
+                continue;
+            if (do_intersection && !(old_reached[block] & BitsetView::bit_mask(id))) {
+                reached.reset(id);
+            } else {
+                assert(!reached.test(id));
+                if (lm_graph.is_true_in_state(id, global_state)) {
+                    if (landmark_is_leaf(id, reached)) {
+                        reached.set(id);
+                    }
                 }
             }
         }
@@ -103,30 +125,29 @@ bool LandmarkStatusManager::update_reached_lms(const GlobalState &parent_global_
 }
 
 bool LandmarkStatusManager::update_lm_status(const GlobalState &global_state) {
-    vector<bool> &reached = get_reached_landmarks(global_state);
+    BitsetView reached = get_reached_landmarks(global_state);
 
-    const set<LandmarkNode *> &nodes = lm_graph.get_nodes();
+    int num_landmarks = lm_graph.number_of_landmarks();
     // initialize all nodes to not reached and not effect of unused ALM
-    for (LandmarkNode *node : nodes) {
-        node->status = lm_not_reached;
-        if (reached[node->get_id()]) {
-            node->status = lm_reached;
-        }
+    for (int id = 0; id < num_landmarks; ++id) {
+        lm_graph.set_status(id, reached.test(id) ? lm_reached : lm_not_reached);
     }
 
     bool dead_end_found = false;
 
     // mark reached and find needed again landmarks
-    for (LandmarkNode *node : nodes) {
-        if (node->status == lm_reached) {
-            if (!node->is_true_in_state(global_state)) {
-                if (node->is_goal()) {
-                    node->status = lm_needed_again;
+    for (int id = 0; id < num_landmarks; ++id) {
+        landmark_status status = lm_graph.get_status(id);
+        if (status == lm_reached) {
+            if (!lm_graph.is_true_in_state(id, global_state)) {
+                if (lm_graph.is_goal(id)) {
+                    status = lm_needed_again;
                 } else {
-                    if (check_lost_landmark_children_needed_again(*node)) {
-                        node->status = lm_needed_again;
+                    if (check_lost_landmark_children_needed_again(id)) {
+                        status = lm_needed_again;
                     }
                 }
+                lm_graph.set_status(id, status);
             }
         }
 
@@ -139,13 +160,13 @@ bool LandmarkStatusManager::update_lm_status(const GlobalState &global_state) {
         // A (possibly) more effective option would be to test reachability of the landmark
         // from the current state.
 
-        if (!node->is_derived) {
-            if ((node->status == lm_not_reached) &&
-                (node->first_achievers.size() == 0)) {
+        if (!lm_graph.is_derived(id)) {
+            if ((status == lm_not_reached) &&
+                lm_graph.get_first_achievers(id).empty()) {
                 dead_end_found = true;
             }
-            if ((node->status == lm_needed_again) &&
-                (node->possible_achievers.size() == 0)) {
+            if ((status == lm_needed_again) &&
+                lm_graph.get_possible_achievers(id).empty()) {
                 dead_end_found = true;
             }
         }
@@ -155,25 +176,21 @@ bool LandmarkStatusManager::update_lm_status(const GlobalState &global_state) {
 }
 
 
-bool LandmarkStatusManager::check_lost_landmark_children_needed_again(const LandmarkNode &node) const {
-    for (const auto &child : node.children) {
-        LandmarkNode *child_node = child.first;
-        if (child.second >= EdgeType::greedy_necessary && child_node->status == lm_not_reached)
+bool LandmarkStatusManager::check_lost_landmark_children_needed_again(int lm_id) const {
+    for (int child_id : lm_graph.get_greedy_necessary_children(lm_id)) {
+        if (lm_graph.get_status(child_id) == lm_not_reached)
             return true;
     }
     return false;
 }
 
-bool LandmarkStatusManager::landmark_is_leaf(const LandmarkNode &node,
-                                             const vector<bool> &reached) const {
+bool LandmarkStatusManager::landmark_is_leaf(int lm_id,
+                                             const BitsetView &reached) const {
     //Note: this is the same as !check_node_orders_disobeyed
-    for (const auto &parent : node.parents) {
-        LandmarkNode *parent_node = parent.first;
-        if (true) // Note: no condition on edge type here
-            if (!reached[parent_node->get_id()]) {
-                return false;
-            }
-
+    for (int parent_id : lm_graph.get_parents(lm_id)) {
+        if (!reached.test(parent_id)) {
+            return false;
+        }
     }
     return true;
 }
@@ -1,24 +1,27 @@
 #ifndef LANDMARKS_LANDMARK_STATUS_MANAGER_H
 #define LANDMARKS_LANDMARK_STATUS_MANAGER_H
 
-#include "../per_state_information.h"
+#include "../per_state_bitset.h"
+
+#include <vector>
 
 namespace landmarks {
 class LandmarkGraph;
-class LandmarkNode;
 
 class LandmarkStatusManager {
-    PerStateInformation<std::vector<bool>> reached_lms;
+    PerStateBitset reached_lms;
+    // Reused buffer for the reached landmarks before an update.
+    std::vector<BitsetView::Block> old_reached;
 
     LandmarkGraph &lm_graph;
     const bool do_intersection;
 
-    bool landmark_is_leaf(const LandmarkNode &node, const std::vector<bool> &reached) const;
-    bool check_lost_landmark_children_needed_again(const LandmarkNode &node) const;
+    bool landmark_is_leaf(int lm_id, const BitsetView &reached) const;
+    bool check_lost_landmark_children_needed_again(int lm_id) const;
 public:
     explicit LandmarkStatusManager(LandmarkGraph &graph);
 
-    std::vector<bool> &get_reached_landmarks(const GlobalState &state);
+    BitsetView get_reached_landmarks(const GlobalState &state);
 
     bool update_lm_status(const GlobalState &state);
 
@@ -5,6 +5,9 @@
 
 #include "../priority_queue.h"
 
+#include "../utils/parallel.h"
+
+#include <algorithm>
 #include <cassert>
 #include <deque>
 
@@ -12,6 +15,7 @@ using namespace std;
 
 namespace merge_and_shrink {
 const int Distances::DISTANCE_UNKNOWN;
+static const int MIN_STATES_FOR_PARALLEL_SEARCHES = 1000;
 
 Distances::Distances(const TransitionSystem &transition_system)
     : transition_system(transition_system) {
@@ -50,14 +54,56 @@ bool Distances::is_unit_cost() const {
     return true;
 }
 
+/*
+  Transitions of a transition system as adjacency lists in flat arrays:
+  the neighbors of state s and the costs of the corresponding
+  transitions are at positions offsets[s], ..., offsets[s + 1] - 1 of
+  neighbors and costs. This needs two passes over the transitions, but
+  only three allocations instead of one per state.
+*/
+struct Graph {
+    vector<int> offsets;
+    vector<int> neighbors;
+    vector<int> costs;
+
+    Graph(const TransitionSystem &transition_system, bool backward,
+          bool with_costs) {
+        int num_states = transition_system.get_size();
+        offsets.assign(num_states + 1, 0);
+        for (const GroupAndTransitions &gat : transition_system) {
+            for (const Transition &transition : gat.transitions) {
+                int state = backward ? transition.target : transition.src;
+                ++offsets[state + 1];
+            }
+        }
+        for (int state = 0; state < num_states; ++state)
+            offsets[state + 1] += offsets[state];
+
+        vector<int> next_position(offsets.begin(), offsets.end() - 1);
+        neighbors.resize(offsets.back());
+        if (with_costs)
+            costs.resize(offsets.back());
+        for (const GroupAndTransitions &gat : transition_system) {
+            int cost = gat.label_group.get_cost();
+            for (const Transition &transition : gat.transitions) {
+                int state = backward ? transition.target : transition.src;
+                int neighbor = backward ? transition.src : transition.target;
+                int pos = next_position[state]++;
+                neighbors[pos] = neighbor;
+                if (with_costs)
+                    costs[pos] = cost;
+            }
+        }
+    }
+};
+
 static void breadth_first_search(
-    const vector<vector<int>> &graph, deque<int> &queue,
-    vector<int> &distances) {
+    const Graph &graph, deque<int> &queue, vector<int> &distances) {
     while (!queue.empty()) {
         int state = queue.front();
         queue.pop_front();
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            int successor = graph[state][i];
+        for (int i = graph.offsets[state]; i < graph.offsets[state + 1]; ++i) {
+            int successor = graph.neighbors[i];
             if (distances[successor] > distances[state] + 1) {
                 distances[successor] = distances[state] + 1;
                 queue.push_back(successor);
@@ -67,33 +113,19 @@ static void breadth_first_search(
 }
 
 void Distances::compute_init_distances_unit_cost() {
-    vector<vector<int>> forward_graph(get_num_states());
-    for (const GroupAndTransitions &gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(transition.target);
-        }
-    }
+    Graph forward_graph(transition_system, false, false);
 
     deque<int> queue;
-    // TODO: This is an oddly inefficient initialization! Fix it.
-    for (int state = 0; state < get_num_states(); ++state) {
-        if (state == transition_system.get_init_state()) {
-            init_distances[state] = 0;
-            queue.push_back(state);
-        }
+    int init_state = transition_system.get_init_state();
+    if (init_state != PRUNED_STATE) {
+        init_distances[init_state] = 0;
+        queue.push_back(init_state);
     }
     breadth_first_search(forward_graph, queue, init_distances);
 }
 
 void Distances::compute_goal_distances_unit_cost() {
-    vector<vector<int>> backward_graph(get_num_states());
-    for (const GroupAndTransitions &gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(transition.src);
-        }
-    }
+    Graph backward_graph(transition_system, true, false);
 
     deque<int> queue;
     for (int state = 0; state < get_num_states(); ++state) {
@@ -106,9 +138,7 @@ void Distances::compute_goal_distances_unit_cost() {
 }
 
 static void dijkstra_search(
-    const vector<vector<pair<int, int>>> &graph,
-    AdaptiveQueue<int> &queue,
-    vector<int> &distances) {
+    const Graph &graph, AdaptiveQueue<int> &queue, vector<int> &distances) {
     while (!queue.empty()) {
         pair<int, int> top_pair = queue.pop();
         int distance = top_pair.first;
@@ -117,10 +147,9 @@ static void dijkstra_search(
         assert(state_distance <= distance);
         if (state_distance < distance)
             continue;
-        for (size_t i = 0; i < graph[state].size(); ++i) {
-            const pair<int, int> &transition = graph[state][i];
-            int successor = transition.first;
-            int cost = transition.second;
+        for (int i = graph.offsets[state]; i < graph.offsets[state + 1]; ++i) {
+            int successor = graph.neighbors[i];
+            int cost = graph.costs[i];
             int successor_cost = state_distance + cost;
             if (distances[successor] > successor_cost) {
                 distances[successor] = successor_cost;
@@ -131,44 +160,20 @@ static void dijkstra_search(
 }
 
 void Distances::compute_init_distances_general_cost() {
-    vector<vector<pair<int, int>>> forward_graph(get_num_states());
-    for (const GroupAndTransitions &gat : transition_system) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        int cost = label_group.get_cost();
-        for (const Transition &transition : transitions) {
-            forward_graph[transition.src].push_back(
-                make_pair(transition.target, cost));
-        }
-    }
+    Graph forward_graph(transition_system, false, true);
 
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_goal_distances_general_cost.
     AdaptiveQueue<int> queue;
-    // TODO: This is an oddly inefficient initialization! Fix it.
-    for (int state = 0; state < get_num_states(); ++state) {
-        if (state == transition_system.get_init_state()) {
-            init_distances[state] = 0;
-            queue.push(0, state);
-        }
+    int init_state = transition_system.get_init_state();
+    if (init_state != PRUNED_STATE) {
+        init_distances[init_state] = 0;
+        queue.push(0, init_state);
     }
     dijkstra_search(forward_graph, queue, init_distances);
 }
 
 void Distances::compute_goal_distances_general_cost() {
-    vector<vector<pair<int, int>>> backward_graph(get_num_states());
-    for (const GroupAndTransitions &gat : transition_system) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        int cost = label_group.get_cost();
-        for (const Transition &transition : transitions) {
-            backward_graph[transition.target].push_back(
-                make_pair(transition.src, cost));
-        }
-    }
+    Graph backward_graph(transition_system, true, true);
 
-    // TODO: Reuse the same queue for multiple computations to save speed?
-    //       Also see compute_init_distances_general_cost.
     AdaptiveQueue<int> queue;
     for (int state = 0; state < get_num_states(); ++state) {
         if (transition_system.is_goal_state(state)) {
@@ -190,7 +195,7 @@ bool Distances::are_distances_computed() const {
     return true;
 }
 
-vector<bool> Distances::compute_distances(Verbosity verbosity) {
+vector<bool> Distances::compute_distances(Verbosity verbosity, int num_threads) {
     /*
       This method does the following:
       - Computes the distances of abstract states from the abstract
@@ -220,19 +225,37 @@ vector<bool> Distances::compute_distances(Verbosity verbosity) {
 
     init_distances.resize(num_states, INF);
     goal_distances.resize(num_states, INF);
-    if (is_unit_cost()) {
-        if (verbosity >= Verbosity::VERBOSE) {
+    bool unit_cost = is_unit_cost();
+    if (verbosity >= Verbosity::VERBOSE) {
+        if (unit_cost) {
             cout << "computing distances using unit-cost algorithm" << endl;
-        }
-        compute_init_distances_unit_cost();
-        compute_goal_distances_unit_cost();
-    } else {
-        if (verbosity >= Verbosity::VERBOSE) {
+        } else {
             cout << "computing distances using general-cost algorithm" << endl;
         }
-        compute_init_distances_general_cost();
-        compute_goal_distances_general_cost();
     }
+    /*
+      The forward and the backward search only read the transition
+      system and write to different vectors, so they can run
+      concurrently. For small transition systems, starting a thread
+      costs more than it saves.
+    */
+    if (num_states < MIN_STATES_FOR_PARALLEL_SEARCHES)
+        num_threads = 1;
+    utils::run_in_parallel(
+        2, min(num_threads, 2),
+        [this, unit_cost](int, int job_id) {
+            if (job_id == 0) {
+                if (unit_cost)
+                    compute_init_distances_unit_cost();
+                else
+                    compute_init_distances_general_cost();
+            } else {
+                if (unit_cost)
+                    compute_goal_distances_unit_cost();
+                else
+                    compute_goal_distances_general_cost();
+            }
+        });
 
     max_f = 0;
     max_g = 0;
@@ -270,7 +293,7 @@ vector<bool> Distances::compute_distances(Verbosity verbosity) {
 
 void Distances::apply_abstraction(
     const StateEquivalenceRelation &state_equivalence_relation,
-    Verbosity verbosity) {
+    Verbosity verbosity, int num_threads) {
     assert(are_distances_computed());
     assert(state_equivalence_relation.size() < init_distances.size());
     assert(state_equivalence_relation.size() < goal_distances.size());
@@ -314,7 +337,7 @@ void Distances::apply_abstraction(
                  << "simplification was not f-preserving!" << endl;
         }
         clear_distances();
-        compute_distances(verbosity);
+        compute_distances(verbosity, num_threads);
     } else {
         init_distances = move(new_init_distances);
         goal_distances = move(new_goal_distances);
@@ -64,7 +64,12 @@ public:
     ~Distances();
 
     bool are_distances_computed() const;
-    std::vector<bool> compute_distances(Verbosity verbosity);
+    /*
+      With num_threads > 1, the distances from the initial state and to
+      the goal states are computed concurrently.
+    */
+    std::vector<bool> compute_distances(
+        Verbosity verbosity, int num_threads = 1);
 
     /*
       Update distances according to the given abstraction. If the abstraction
@@ -77,7 +82,7 @@ public:
     */
     void apply_abstraction(
         const StateEquivalenceRelation &state_equivalence_relation,
-        Verbosity verbosity);
+        Verbosity verbosity, int num_threads = 1);
 
     int get_max_f() const { // used by shrink_fh
         return max_f;
@@ -5,8 +5,11 @@
 #include "merge_and_shrink_representation.h"
 #include "transition_system.h"
 
+#include "../utils/collections.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 
+#include <atomic>
 #include <cassert>
 
 using namespace std;
@@ -38,20 +41,55 @@ FactoredTransitionSystem::FactoredTransitionSystem(
     vector<unique_ptr<MergeAndShrinkRepresentation>> &&mas_representations,
     vector<unique_ptr<Distances>> &&distances,
     Verbosity verbosity,
-    bool finalize_if_unsolvable)
+    bool finalize_if_unsolvable,
+    int num_threads)
     : labels(move(labels)),
       transition_systems(move(transition_systems)),
       mas_representations(move(mas_representations)),
       distances(move(distances)),
       unsolvable_index(-1),
-      num_active_entries(this->transition_systems.size()) {
-    for (size_t i = 0; i < this->transition_systems.size(); ++i) {
-        compute_distances_and_prune(i, verbosity);
+      num_active_entries(this->transition_systems.size()),
+      num_threads(num_threads) {
+    /*
+      The distances of the atomic transition systems are independent of
+      each other, so we compute them in parallel before pruning the
+      transition systems one after the other. We stay on one thread in
+      verbose mode to keep the output of the transition systems apart.
+
+      If finalize_if_unsolvable is set, we stop as soon as we find an
+      atomic transition system whose initial state is pruned. Since jobs
+      are started in increasing order of their indices, the distances of
+      all transition systems before it are computed when we prune them
+      below, and the pruning loop stops at the first unsolvable one.
+    */
+    int num_atomic_systems = this->transition_systems.size();
+    vector<vector<bool>> prunable_states(num_atomic_systems);
+    atomic<bool> found_unsolvable(false);
+    utils::run_in_parallel(
+        num_atomic_systems,
+        verbosity >= Verbosity::VERBOSE ? 1 : num_threads,
+        [&](int, int index) {
+            prunable_states[index] =
+                this->distances[index]->compute_distances(verbosity);
+            int init_state = this->transition_systems[index]->get_init_state();
+            if (finalize_if_unsolvable &&
+                (init_state == PRUNED_STATE || prunable_states[index][init_state])) {
+                found_unsolvable = true;
+            }
+        },
+        [&]() {
+            return found_unsolvable.load();
+        });
+    for (int i = 0; i < num_atomic_systems; ++i) {
+        discard_states(i, prunable_states[i], verbosity);
+        assert(is_component_valid(i));
+        utils::release_vector_memory(prunable_states[i]);
         if (finalize_if_unsolvable && !this->transition_systems[i]->is_solvable()) {
             unsolvable_index = i;
             break;
         }
     }
+    assert(!found_unsolvable || unsolvable_index != -1);
 }
 
 FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&other)
@@ -60,7 +98,8 @@ FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&ot
       mas_representations(move(other.mas_representations)),
       distances(move(other.distances)),
       unsolvable_index(move(other.unsolvable_index)),
-      num_active_entries(move(other.num_active_entries)) {
+      num_active_entries(move(other.num_active_entries)),
+      num_threads(move(other.num_threads)) {
     /*
       This is just a default move constructor. Unfortunately Visual
       Studio does not support "= default" for move construction or
@@ -116,7 +155,7 @@ void FactoredTransitionSystem::compute_distances_and_prune(
     assert(is_index_valid(index));
     discard_states(
         index,
-        distances[index]->compute_distances(verbosity),
+        distances[index]->compute_distances(verbosity, num_threads),
         verbosity);
     assert(is_component_valid(index));
 }
@@ -159,7 +198,7 @@ bool FactoredTransitionSystem::apply_abstraction(
         state_equivalence_relation, abstraction_mapping, verbosity);
     if (shrunk) {
         distances[index]->apply_abstraction(
-            state_equivalence_relation, verbosity);
+            state_equivalence_relation, verbosity, num_threads);
         mas_representations[index]->apply_abstraction_to_lookup_table(
             abstraction_mapping);
     }
@@ -48,6 +48,8 @@ class FactoredTransitionSystem {
     std::vector<std::unique_ptr<Distances>> distances;
     int unsolvable_index; // -1 if solvable, index of an unsolvable entry otw.
     int num_active_entries;
+    // Maximal number of threads used for computations on the factors.
+    int num_threads;
 
     void compute_distances_and_prune(
         int index,
@@ -66,7 +68,8 @@ public:
         std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> &&mas_representations,
         std::vector<std::unique_ptr<Distances>> &&distances,
         Verbosity verbosity,
-        bool finalize_if_unsolvable);
+        bool finalize_if_unsolvable,
+        int num_threads = 1);
     FactoredTransitionSystem(FactoredTransitionSystem &&other);
     ~FactoredTransitionSystem();
 
@@ -121,6 +124,11 @@ public:
         return *labels;
     }
 
+    // Used by merge scoring functions that evaluate candidates in parallel.
+    int get_num_threads() const {
+        return num_threads;
+    }
+
     // The following methods are used for iterating over the FTS
     FTSConstIterator begin() const {
         return FTSConstIterator(*this, false);
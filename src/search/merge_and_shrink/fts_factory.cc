@@ -10,6 +10,7 @@
 
 #include "../task_proxy.h"
 
+#include "../utils/collections.h"
 #include "../utils/memory.h"
 
 #include <algorithm>
@@ -83,7 +84,8 @@ public:
       Note: create() may only be called once. We don't worry about
       misuse because the class is only used internally in this file.
     */
-    FactoredTransitionSystem create(Verbosity verbosity, bool finalize_if_unsolvable);
+    FactoredTransitionSystem create(
+        Verbosity verbosity, bool finalize_if_unsolvable, int num_threads);
 };
 
 
@@ -343,11 +345,33 @@ vector<unique_ptr<TransitionSystem>> FTSFactory::create_transition_systems() {
     const bool compute_label_equivalence_relation = true;
     for (int var_no = 0; var_no < num_variables; ++var_no) {
         TransitionSystemData &ts_data = transition_system_data_by_var[var_no];
+        /*
+          Store the transitions in one table ordered by label. Every label
+          initially forms its own group whose id is the label number.
+        */
+        int num_groups = ts_data.label_equivalence_relation->get_size();
+        int num_transitions = 0;
+        for (int label_no = 0; label_no < num_groups; ++label_no)
+            num_transitions += ts_data.transitions_by_label[label_no].size();
+        vector<Transition> transitions;
+        transitions.reserve(num_transitions);
+        vector<int> group_offsets;
+        group_offsets.reserve(num_groups + 1);
+        group_offsets.push_back(0);
+        for (int label_no = 0; label_no < num_groups; ++label_no) {
+            vector<Transition> &label_transitions =
+                ts_data.transitions_by_label[label_no];
+            transitions.insert(transitions.end(), label_transitions.begin(),
+                               label_transitions.end());
+            utils::release_vector_memory(label_transitions);
+            group_offsets.push_back(transitions.size());
+        }
         result.push_back(utils::make_unique_ptr<TransitionSystem>(
                              ts_data.num_variables,
                              move(ts_data.incorporated_variables),
                              move(ts_data.label_equivalence_relation),
-                             move(ts_data.transitions_by_label),
+                             move(transitions),
+                             move(group_offsets),
                              ts_data.num_states,
                              move(ts_data.goal_states),
                              ts_data.init_state,
@@ -392,7 +416,7 @@ vector<unique_ptr<Distances>> FTSFactory::create_distances(
 }
 
 FactoredTransitionSystem FTSFactory::create(
-    Verbosity verbosity, bool finalize_if_unsolvable) {
+    Verbosity verbosity, bool finalize_if_unsolvable, int num_threads) {
     if (verbosity >= Verbosity::NORMAL) {
         cout << "Building atomic transition systems... " << endl;
     }
@@ -414,13 +438,16 @@ FactoredTransitionSystem FTSFactory::create(
         move(mas_representations),
         move(distances),
         verbosity,
-        finalize_if_unsolvable);
+        finalize_if_unsolvable,
+        num_threads);
 }
 
 FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
     Verbosity verbosity,
-    bool finalize_if_unsolvable) {
-    return FTSFactory(task_proxy).create(verbosity, finalize_if_unsolvable);
+    bool finalize_if_unsolvable,
+    int num_threads) {
+    return FTSFactory(task_proxy).create(
+        verbosity, finalize_if_unsolvable, num_threads);
 }
 }
@@ -13,10 +13,12 @@
 
 #include "../utils/collections.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -138,6 +140,23 @@ EquivalenceRelation *LabelReduction::compute_combinable_equivalence_relation(
     return relation;
 }
 
+vector<unique_ptr<EquivalenceRelation>>
+LabelReduction::compute_combinable_equivalence_relations(
+    const vector<int> &ts_indices,
+    const FactoredTransitionSystem &fts) const {
+    int num_relations = ts_indices.size();
+    vector<unique_ptr<EquivalenceRelation>> relations(num_relations);
+    utils::run_in_parallel(
+        num_relations, fts.get_num_threads(),
+        [&](int, int i) {
+            if (fts.is_active(ts_indices[i])) {
+                relations[i] = unique_ptr<EquivalenceRelation>(
+                    compute_combinable_equivalence_relation(ts_indices[i], fts));
+            }
+        });
+    return relations;
+}
+
 bool LabelReduction::reduce(
     pair<int, int> next_merge,
     FactoredTransitionSystem &fts,
@@ -146,6 +165,16 @@ bool LabelReduction::reduce(
     assert(reduce_before_shrinking() || reduce_before_merging());
     int num_transition_systems = fts.get_size();
 
+    /*
+      Computing the combinable relation of a transition system only reads
+      the factored transition system, and only a successful reduction
+      changes it. We therefore compute the relations of the next
+      transition systems in the iteration order in parallel, as if no
+      reduction happened in between. Once a reduction is applied, the
+      remaining precomputed relations are outdated and discarded. This
+      gives the same reductions as computing the relations one by one,
+      independently of the number of threads.
+    */
     if (lr_method == TWO_TRANSITION_SYSTEMS) {
         /* Note:
            We compute the combinable relation for labels for the two transition systems
@@ -158,30 +187,35 @@ bool LabelReduction::reduce(
         assert(fts.is_active(next_merge.second));
 
         bool reduced = false;
-        EquivalenceRelation *relation = compute_combinable_equivalence_relation(
-            next_merge.first,
-            fts);
+        vector<int> ts_indices = {next_merge.first};
+        if (fts.get_num_threads() > 1) {
+            ts_indices.push_back(next_merge.second);
+        }
+        vector<unique_ptr<EquivalenceRelation>> relations =
+            compute_combinable_equivalence_relations(ts_indices, fts);
         vector<pair<int, vector<int>>> label_mapping;
-        compute_label_mapping(relation, fts, label_mapping, verbosity);
+        compute_label_mapping(relations[0].get(), fts, label_mapping, verbosity);
+        relations[0] = nullptr;
         if (!label_mapping.empty()) {
             fts.apply_label_reduction(label_mapping,
                                       next_merge.first);
             reduced = true;
+            relations.resize(1);
         }
-        delete relation;
-        relation = 0;
         utils::release_vector_memory(label_mapping);
 
-        relation = compute_combinable_equivalence_relation(
-            next_merge.second,
-            fts);
-        compute_label_mapping(relation, fts, label_mapping, verbosity);
+        if (relations.size() == 1) {
+            relations.push_back(unique_ptr<EquivalenceRelation>(
+                compute_combinable_equivalence_relation(
+                    next_merge.second,
+                    fts)));
+        }
+        compute_label_mapping(relations[1].get(), fts, label_mapping, verbosity);
         if (!label_mapping.empty()) {
             fts.apply_label_reduction(label_mapping,
                                       next_merge.second);
             reduced = true;
         }
-        delete relation;
         return reduced;
     }
 
@@ -193,6 +227,15 @@ bool LabelReduction::reduce(
         ++tso_index;
         assert(utils::in_bounds(tso_index, transition_system_order));
     }
+    auto get_next_tso_index = [&](size_t index) {
+        do {
+            ++index;
+            if (index == transition_system_order.size()) {
+                index = 0;
+            }
+        } while (transition_system_order[index] >= num_transition_systems);
+        return index;
+    };
 
     int max_iterations;
     if (lr_method == ALL_TRANSITION_SYSTEMS) {
@@ -204,19 +247,38 @@ bool LabelReduction::reduce(
     }
 
     int num_unsuccessful_iterations = 0;
+    int num_threads = fts.get_num_threads();
+    vector<unique_ptr<EquivalenceRelation>> relations;
+    size_t next_relation = 0;
 
     bool reduced = false;
     for (int i = 0; i < max_iterations; ++i) {
         int ts_index = transition_system_order[tso_index];
 
+        if (next_relation == relations.size()) {
+            // Do not compute relations beyond the point where we stop.
+            int num_relations = min({
+                num_threads, max_iterations - i,
+                max(1, num_transition_systems - 1 - num_unsuccessful_iterations)});
+            vector<int> ts_indices;
+            ts_indices.reserve(num_relations);
+            size_t index = tso_index;
+            for (int j = 0; j < num_relations; ++j) {
+                ts_indices.push_back(transition_system_order[index]);
+                index = get_next_tso_index(index);
+            }
+            relations = compute_combinable_equivalence_relations(
+                ts_indices, fts);
+            next_relation = 0;
+        }
+
         vector<pair<int, vector<int>>> label_mapping;
         if (fts.is_active(ts_index)) {
-            EquivalenceRelation *relation =
-                compute_combinable_equivalence_relation(ts_index,
-                                                        fts);
-            compute_label_mapping(relation, fts, label_mapping, verbosity);
-            delete relation;
+            compute_label_mapping(
+                relations[next_relation].get(), fts, label_mapping, verbosity);
         }
+        relations[next_relation] = nullptr;
+        ++next_relation;
 
         if (label_mapping.empty()) {
             // Even if the transition system has been removed, we need to count
@@ -226,20 +288,13 @@ bool LabelReduction::reduce(
             reduced = true;
             num_unsuccessful_iterations = 0;
             fts.apply_label_reduction(label_mapping, ts_index);
+            relations.clear();
+            next_relation = 0;
         }
         if (num_unsuccessful_iterations == num_transition_systems - 1)
             break;
 
-        ++tso_index;
-        if (tso_index == transition_system_order.size()) {
-            tso_index = 0;
-        }
-        while (transition_system_order[tso_index] >= num_transition_systems) {
-            ++tso_index;
-            if (tso_index == transition_system_order.size()) {
-                tso_index = 0;
-            }
-        }
+        tso_index = get_next_tso_index(tso_index);
     }
     return reduced;
 }
@@ -69,6 +69,14 @@ class LabelReduction {
     EquivalenceRelation *compute_combinable_equivalence_relation(
         int ts_index,
         const FactoredTransitionSystem &fts) const;
+    /*
+      Compute the combinable relations of the given transition systems
+      in parallel. Inactive transition systems get no relation.
+    */
+    std::vector<std::unique_ptr<EquivalenceRelation>>
+    compute_combinable_equivalence_relations(
+        const std::vector<int> &ts_indices,
+        const FactoredTransitionSystem &fts) const;
 public:
     explicit LabelReduction(const options::Options &options);
     void initialize(const TaskProxy &task_proxy);
@@ -20,6 +20,7 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 #include "../utils/timer.h"
 
@@ -46,6 +47,7 @@ MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
       max_states_before_merge(opts.get<int>("max_states_before_merge")),
       shrink_threshold_before_merge(opts.get<int>("threshold_before_merge")),
       verbosity(static_cast<Verbosity>(opts.get_enum("verbosity"))),
+      num_threads(utils::parse_num_threads_from_options(opts)),
       starting_peak_memory(-1),
       mas_representation(nullptr) {
     assert(max_states_before_merge > 0);
@@ -97,6 +99,9 @@ void MergeAndShrinkHeuristic::dump_options() const {
          << shrink_threshold_before_merge << endl;
     cout << endl;
 
+    cout << "Number of threads: " << num_threads << endl;
+    cout << endl;
+
     shrink_strategy->dump_options();
     cout << endl;
 
@@ -199,7 +204,8 @@ void MergeAndShrinkHeuristic::build(const utils::Timer &timer) {
         create_factored_transition_system(
             task_proxy,
             verbosity,
-            finalize_if_unsolvable);
+            finalize_if_unsolvable,
+            num_threads);
     print_time(timer, "after computation of atomic transition systems");
     cout << endl;
 
@@ -283,8 +289,12 @@ void MergeAndShrinkHeuristic::build(const utils::Timer &timer) {
 
     pair<unique_ptr<MergeAndShrinkRepresentation>, unique_ptr<Distances>>
     final_entry = fts.get_final_entry();
-    mas_representation = move(final_entry.first);
-    mas_representation->set_distances(*final_entry.second);
+    final_entry.first->set_distances(*final_entry.second);
+    mas_representation = utils::make_unique_ptr<CompiledMergeAndShrinkRepresentation>(
+        *final_entry.first);
+    if (verbosity >= Verbosity::NORMAL) {
+        mas_representation->dump_statistics();
+    }
     shrink_strategy = nullptr;
     label_reduction = nullptr;
 }
@@ -465,6 +475,7 @@ static Heuristic *_parse(OptionParser &parser) {
         OptionParser::NONE);
 
     MergeAndShrinkHeuristic::add_shrink_limit_options_to_parser(parser);
+    utils::add_num_threads_option(parser);
     Heuristic::add_options_to_parser(parser);
 
     vector<string> verbosity_levels;
@@ -10,9 +10,9 @@ class Timer;
 }
 
 namespace merge_and_shrink {
+class CompiledMergeAndShrinkRepresentation;
 class FactoredTransitionSystem;
 class LabelReduction;
-class MergeAndShrinkRepresentation;
 class MergeStrategyFactory;
 class ShrinkStrategy;
 class TransitionSystem;
@@ -35,9 +35,13 @@ class MergeAndShrinkHeuristic : public Heuristic {
     const int shrink_threshold_before_merge;
 
     const Verbosity verbosity;
+    const int num_threads;
     long starting_peak_memory;
-    // The final merge-and-shrink representation, storing goal distances.
-    std::unique_ptr<MergeAndShrinkRepresentation> mas_representation;
+    /*
+      The final merge-and-shrink representation, storing goal distances,
+      compiled into flat tables for fast evaluation.
+    */
+    std::unique_ptr<CompiledMergeAndShrinkRepresentation> mas_representation;
 
     std::pair<bool, bool> shrink_before_merge(
         FactoredTransitionSystem &fts, int index1, int index2);
@@ -6,6 +6,7 @@
 #include "../task_proxy.h"
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <numeric>
 
@@ -65,6 +66,24 @@ void MergeAndShrinkRepresentationLeaf::dump() const {
     cout << endl;
 }
 
+int MergeAndShrinkRepresentationLeaf::get_num_assignments(int max_size) const {
+    int num_values = lookup_table.size();
+    return num_values <= max_size ? num_values : -1;
+}
+
+void MergeAndShrinkRepresentationLeaf::compute_table(
+    vector<int> &variables, vector<int> &strides, vector<int> &table) const {
+    assert(variables.empty() && strides.empty() && table.empty());
+    variables.push_back(var_id);
+    strides.push_back(1);
+    table = lookup_table;
+}
+
+int MergeAndShrinkRepresentationLeaf::compile(
+    CompiledMergeAndShrinkRepresentation &compiled) const {
+    return compiled.add_lookup({var_id}, {1}, lookup_table);
+}
+
 
 MergeAndShrinkRepresentationMerge::MergeAndShrinkRepresentationMerge(
     unique_ptr<MergeAndShrinkRepresentation> left_child_,
@@ -131,4 +150,129 @@ void MergeAndShrinkRepresentationMerge::dump() const {
     cout << "dump right child:" << endl;
     right_child->dump();
 }
+
+int MergeAndShrinkRepresentationMerge::get_num_assignments(int max_size) const {
+    int left_size = left_child->get_num_assignments(max_size);
+    int right_size = right_child->get_num_assignments(max_size);
+    if (left_size == -1 || right_size == -1 || left_size > max_size / right_size)
+        return -1;
+    return left_size * right_size;
+}
+
+void MergeAndShrinkRepresentationMerge::compute_table(
+    vector<int> &variables, vector<int> &strides, vector<int> &table) const {
+    assert(variables.empty() && strides.empty() && table.empty());
+    vector<int> left_table;
+    left_child->compute_table(variables, strides, left_table);
+    vector<int> right_variables;
+    vector<int> right_strides;
+    vector<int> right_table;
+    right_child->compute_table(right_variables, right_strides, right_table);
+    for (int &stride : strides)
+        stride *= right_table.size();
+    variables.insert(variables.end(), right_variables.begin(), right_variables.end());
+    strides.insert(strides.end(), right_strides.begin(), right_strides.end());
+
+    table.reserve(left_table.size() * right_table.size());
+    for (int state1 : left_table) {
+        for (int state2 : right_table) {
+            if (state1 == PRUNED_STATE || state2 == PRUNED_STATE)
+                table.push_back(PRUNED_STATE);
+            else
+                table.push_back(lookup_table[state1][state2]);
+        }
+    }
+}
+
+int MergeAndShrinkRepresentationMerge::compile(
+    CompiledMergeAndShrinkRepresentation &compiled) const {
+    if (get_num_assignments(CompiledMergeAndShrinkRepresentation::MAX_TABLE_SIZE) != -1) {
+        vector<int> variables;
+        vector<int> strides;
+        vector<int> table;
+        compute_table(variables, strides, table);
+        return compiled.add_lookup(variables, strides, table);
+    }
+    int left_slot = left_child->compile(compiled);
+    int right_slot = right_child->compile(compiled);
+    return compiled.add_merge(left_slot, right_slot, lookup_table);
+}
+
+
+CompiledMergeAndShrinkRepresentation::CompiledMergeAndShrinkRepresentation(
+    const MergeAndShrinkRepresentation &representation)
+    : root_slot(-1) {
+    assert(PRUNED_STATE == -1);
+    root_slot = representation.compile(*this);
+    slot_values.resize(lookups.size() + merges.size());
+}
+
+int CompiledMergeAndShrinkRepresentation::add_slot() {
+    return lookups.size() + merges.size();
+}
+
+int CompiledMergeAndShrinkRepresentation::add_lookup(
+    const vector<int> &lookup_variables, const vector<int> &lookup_strides,
+    const vector<int> &table) {
+    assert(lookup_variables.size() == lookup_strides.size());
+    Lookup lookup;
+    lookup.slot = add_slot();
+    lookup.first_variable = variables.size();
+    lookup.num_variables = lookup_variables.size();
+    lookup.table_offset = tables.size();
+    variables.insert(variables.end(), lookup_variables.begin(), lookup_variables.end());
+    strides.insert(strides.end(), lookup_strides.begin(), lookup_strides.end());
+    tables.insert(tables.end(), table.begin(), table.end());
+    lookups.push_back(lookup);
+    return lookup.slot;
+}
+
+int CompiledMergeAndShrinkRepresentation::add_merge(
+    int left_slot, int right_slot, const vector<vector<int>> &table) {
+    assert(!table.empty());
+    Merge merge;
+    merge.slot = add_slot();
+    merge.left_slot = left_slot;
+    merge.right_slot = right_slot;
+    merge.num_columns = table[0].size() + 1;
+    merge.table_offset = tables.size();
+    /*
+      Pruned children have the value PRUNED_STATE = -1, so shifting all
+      indices by one maps them to the first row or column.
+    */
+    tables.insert(tables.end(), merge.num_columns, PRUNED_STATE);
+    for (const vector<int> &row : table) {
+        assert(static_cast<int>(row.size()) + 1 == merge.num_columns);
+        tables.push_back(PRUNED_STATE);
+        tables.insert(tables.end(), row.begin(), row.end());
+    }
+    merges.push_back(merge);
+    return merge.slot;
+}
+
+int CompiledMergeAndShrinkRepresentation::get_value(const State &state) const {
+    const vector<int> &values = state.get_values();
+    for (const Lookup &lookup : lookups) {
+        int index = lookup.table_offset;
+        const int *vars = &variables[lookup.first_variable];
+        const int *var_strides = &strides[lookup.first_variable];
+        for (int i = 0; i < lookup.num_variables; ++i)
+            index += values[vars[i]] * var_strides[i];
+        slot_values[lookup.slot] = tables[index];
+    }
+    for (const Merge &merge : merges) {
+        int row = slot_values[merge.left_slot] + 1;
+        int column = slot_values[merge.right_slot] + 1;
+        slot_values[merge.slot] =
+            tables[merge.table_offset + row * merge.num_columns + column];
+    }
+    return slot_values[root_slot];
+}
+
+void CompiledMergeAndShrinkRepresentation::dump_statistics() const {
+    cout << "Compiled merge-and-shrink representation: "
+         << lookups.size() << " lookups, "
+         << merges.size() << " merges, "
+         << tables.size() << " table entries" << endl;
+}
 }
@@ -7,6 +7,7 @@
 class State;
 
 namespace merge_and_shrink {
+class CompiledMergeAndShrinkRepresentation;
 class Distances;
 class MergeAndShrinkRepresentation {
 protected:
@@ -26,6 +27,29 @@ public:
     virtual void apply_abstraction_to_lookup_table(
         const std::vector<int> &abstraction_mapping) = 0;
     virtual void dump() const = 0;
+
+    /*
+      Return the number of assignments to the variables of this
+      representation, or -1 if it exceeds max_size.
+    */
+    virtual int get_num_assignments(int max_size) const = 0;
+
+    /*
+      Compute the values of this representation for all assignments to
+      its variables. All vectors must be empty. Afterwards, the value for
+      an assignment is stored in table at the sum of variable values
+      times the corresponding strides. The last variable has stride 1.
+    */
+    virtual void compute_table(
+        std::vector<int> &variables, std::vector<int> &strides,
+        std::vector<int> &table) const = 0;
+
+    /*
+      Add the instructions that compute the value of this representation
+      to the given compiled representation and return the slot that holds
+      the value.
+    */
+    virtual int compile(CompiledMergeAndShrinkRepresentation &compiled) const = 0;
 };
 
 
@@ -42,6 +66,12 @@ public:
         const std::vector<int> &abstraction_mapping) override;
     virtual int get_value(const State &state) const override;
     virtual void dump() const override;
+    virtual int get_num_assignments(int max_size) const override;
+    virtual void compute_table(
+        std::vector<int> &variables, std::vector<int> &strides,
+        std::vector<int> &table) const override;
+    virtual int compile(
+        CompiledMergeAndShrinkRepresentation &compiled) const override;
 };
 
 
@@ -60,6 +90,76 @@ public:
         const std::vector<int> &abstraction_mapping) override;
     virtual int get_value(const State &state) const override;
     virtual void dump() const override;
+    virtual int get_num_assignments(int max_size) const override;
+    virtual void compute_table(
+        std::vector<int> &variables, std::vector<int> &strides,
+        std::vector<int> &table) const override;
+    virtual int compile(
+        CompiledMergeAndShrinkRepresentation &compiled) const override;
+};
+
+
+/*
+  Flat version of a merge-and-shrink representation for fast evaluation.
+
+  Every subtree of the representation whose variables have at most
+  MAX_TABLE_SIZE assignments is collapsed into a single table indexed by
+  the values of its variables (a "lookup"). The remaining merge nodes
+  become instructions that look up the values of their two children in
+  their table (a "merge"). If the whole representation fits, evaluating
+  it is a single table lookup.
+
+  All tables are stored in one vector. The value of every lookup and merge
+  is stored in a slot. Merges are stored in the order in which they have
+  to be evaluated, and their tables have an extra first row and column
+  for pruned children, so evaluation needs neither recursion, nor virtual
+  calls, nor special cases for pruned states.
+
+  Evaluation uses a buffer for the slot values, so get_value is not
+  thread-safe.
+*/
+class CompiledMergeAndShrinkRepresentation {
+    struct Lookup {
+        int slot;
+        int first_variable;
+        int num_variables;
+        int table_offset;
+    };
+
+    struct Merge {
+        int slot;
+        int left_slot;
+        int right_slot;
+        // Number of columns of the table, including the one for pruned states.
+        int num_columns;
+        int table_offset;
+    };
+
+    std::vector<Lookup> lookups;
+    std::vector<Merge> merges;
+    // Variables and strides of all lookups.
+    std::vector<int> variables;
+    std::vector<int> strides;
+    std::vector<int> tables;
+    int root_slot;
+    mutable std::vector<int> slot_values;
+
+    int add_slot();
+public:
+    static const int MAX_TABLE_SIZE = 1 << 16;
+
+    explicit CompiledMergeAndShrinkRepresentation(
+        const MergeAndShrinkRepresentation &representation);
+
+    int add_lookup(
+        const std::vector<int> &lookup_variables,
+        const std::vector<int> &lookup_strides, const std::vector<int> &table);
+    int add_merge(
+        int left_slot, int right_slot, const std::vector<std::vector<int>> &table);
+
+    // Return the goal distance of the given state or PRUNED_STATE.
+    int get_value(const State &state) const;
+    void dump_statistics() const;
 };
 }
 
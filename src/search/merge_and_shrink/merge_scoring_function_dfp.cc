@@ -10,7 +10,9 @@
 #include "../options/plugin.h"
 
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -26,7 +28,7 @@ vector<int> MergeScoringFunctionDFP::compute_label_ranks(
 
     for (const GroupAndTransitions &gat : ts) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         // Relevant labels with no transitions have a rank of infinity.
         int label_rank = INF;
         bool group_relevant = false;
@@ -64,37 +66,57 @@ vector<double> MergeScoringFunctionDFP::compute_scores(
     FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
     int num_ts = fts.get_size();
-
-    vector<vector<int>> transition_system_label_ranks(num_ts);
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-
-    // Go over all pairs of transition systems and compute their weight.
+    int num_threads = fts.get_num_threads();
+
+    /*
+      Compute the label ranks of all transition systems occurring in a
+      candidate first. Both this and the weights of the candidates only
+      read the factored transition system, so we spread both over the
+      available threads.
+    */
+    vector<int> ts_indices;
+    vector<bool> is_candidate_ts(num_ts, false);
     for (pair<int, int> merge_candidate : merge_candidates) {
-        int ts_index1 = merge_candidate.first;
-        int ts_index2 = merge_candidate.second;
-
-        vector<int> &label_ranks1 = transition_system_label_ranks[ts_index1];
-        if (label_ranks1.empty()) {
-            label_ranks1 = compute_label_ranks(fts, ts_index1);
-        }
-        vector<int> &label_ranks2 = transition_system_label_ranks[ts_index2];
-        if (label_ranks2.empty()) {
-            label_ranks2 = compute_label_ranks(fts, ts_index2);
-        }
-        assert(label_ranks1.size() == label_ranks2.size());
-
-        // Compute the weight associated with this pair
-        int pair_weight = INF;
-        for (size_t i = 0; i < label_ranks1.size(); ++i) {
-            if (label_ranks1[i] != -1 && label_ranks2[i] != -1) {
-                // label is relevant in both transition_systems
-                int max_label_rank = max(label_ranks1[i], label_ranks2[i]);
-                pair_weight = min(pair_weight, max_label_rank);
+        for (int ts_index : {merge_candidate.first, merge_candidate.second}) {
+            if (!is_candidate_ts[ts_index]) {
+                is_candidate_ts[ts_index] = true;
+                ts_indices.push_back(ts_index);
             }
         }
-        scores.push_back(pair_weight);
     }
+    vector<vector<int>> transition_system_label_ranks(num_ts);
+    utils::run_in_parallel(
+        ts_indices.size(), num_threads,
+        [&](int, int job_id) {
+            int ts_index = ts_indices[job_id];
+            transition_system_label_ranks[ts_index] =
+                compute_label_ranks(fts, ts_index);
+        });
+
+    // Go over all pairs of transition systems and compute their weight.
+    vector<double> scores(merge_candidates.size());
+    utils::run_in_parallel(
+        merge_candidates.size(), num_threads,
+        [&](int, int candidate_id) {
+            const pair<int, int> &merge_candidate =
+                merge_candidates[candidate_id];
+            const vector<int> &label_ranks1 =
+                transition_system_label_ranks[merge_candidate.first];
+            const vector<int> &label_ranks2 =
+                transition_system_label_ranks[merge_candidate.second];
+            assert(label_ranks1.size() == label_ranks2.size());
+
+            // Compute the weight associated with this pair
+            int pair_weight = INF;
+            for (size_t i = 0; i < label_ranks1.size(); ++i) {
+                if (label_ranks1[i] != -1 && label_ranks2[i] != -1) {
+                    // label is relevant in both transition_systems
+                    int max_label_rank = max(label_ranks1[i], label_ranks2[i]);
+                    pair_weight = min(pair_weight, max_label_rank);
+                }
+            }
+            scores[candidate_id] = pair_weight;
+        });
     return scores;
 }
 
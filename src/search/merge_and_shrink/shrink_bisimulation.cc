@@ -10,10 +10,12 @@
 
 #include "../utils/collections.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
@@ -21,39 +23,49 @@
 using namespace std;
 
 namespace merge_and_shrink {
-/* A successor signature characterizes the behaviour of an abstract
-   state in so far as bisimulation cares about it. States with
-   identical successor signature are not distinguished by
-   bisimulation.
+/*
+  A successor signature characterizes the behaviour of an abstract state in
+  so far as bisimulation cares about it. States with identical successor
+  signature are not distinguished by bisimulation.
+
+  Each entry of a signature is a pair of (label group number, equivalence
+  class of successor), packed into one 64-bit number with the label group
+  in the high bits. The bisimulation algorithm requires that the entries are
+  sorted and uniquified. To compare signatures quickly, we additionally
+  compute a 64-bit hash of every signature. Signatures with different
+  hashes differ, and for equal hashes we compare the entries.
+*/
+using SignatureEntry = uint64_t;
+
+static SignatureEntry make_signature_entry(int label_group, int group) {
+    return (static_cast<uint64_t>(label_group) << 32) | static_cast<uint32_t>(group);
+}
 
-   Each entry in the vector is a pair of (label group id, equivalence class of
-   successor). The bisimulation algorithm requires that the vector is
-   sorted and uniquified. */
-using SuccessorSignature = vector<pair<int, int>>;
+static uint64_t hash_signature(
+    const SignatureEntry *begin, const SignatureEntry *end) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const SignatureEntry *entry = begin; entry != end; ++entry) {
+        hash = (hash ^ *entry) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
 
 /*
-  The following class encodes all we need to know about a state for
-  bisimulation: its h value, which equivalence class ("group") it currently
-  belongs to, its successor signature (see above), and what the original
-  state is.
+  The following class encodes all we need to know about a state for sorting
+  the states of one refinement round: its h value, which equivalence class
+  ("group") it currently belongs to, the hash of its successor signature
+  (see above), and its position in the list of states considered in this
+  round, which is ordered by state.
 */
-
 struct Signature {
     int h_and_goal; // -1 for goal states; h value for non-goal states
     int group;
-    SuccessorSignature succ_signature;
-    int state;
-
-    Signature(int h, bool is_goal, int group_,
-              const SuccessorSignature &succ_signature_,
-              int state_)
-        : group(group_), succ_signature(succ_signature_), state(state_) {
-        if (is_goal) {
-            assert(h == 0);
-            h_and_goal = -1;
-        } else {
-            h_and_goal = h;
-        }
+    uint64_t hash;
+    int pos;
+
+    Signature(int h_and_goal, int group, uint64_t hash, int pos)
+        : h_and_goal(h_and_goal), group(group), hash(hash), pos(pos) {
     }
 
     bool operator<(const Signature &other) const {
@@ -61,27 +73,91 @@ struct Signature {
             return h_and_goal < other.h_and_goal;
         if (group != other.group)
             return group < other.group;
-        if (succ_signature != other.succ_signature)
-            return succ_signature < other.succ_signature;
-        return state < other.state;
+        if (hash != other.hash)
+            return hash < other.hash;
+        return pos < other.pos;
     }
+};
 
-    void dump() const {
-        cout << "Signature(h_and_goal = " << h_and_goal
-             << ", group = " << group
-             << ", state = " << state
-             << ", succ_sig = [";
-        for (size_t i = 0; i < succ_signature.size(); ++i) {
-            if (i)
-                cout << ", ";
-            cout << "(" << succ_signature[i].first
-                 << "," << succ_signature[i].second
-                 << ")";
+/*
+  Call the given function for every transition relevant for bisimulation
+  (for greedy bisimulation, only those on optimal paths to the goal),
+  together with the number of its label group.
+*/
+template<typename Callback>
+static void for_each_relevant_transition(
+    const TransitionSystem &ts, const Distances &distances, bool greedy,
+    const Callback &callback) {
+    /*
+      Note that the final result of the bisimulation may depend on the
+      order in which transitions are considered below, because label groups
+      are numbered in this order.
+
+      If label groups were sorted (every group by increasing label numbers,
+      groups by smallest label number), then the following configuration
+      gives a different result on parcprinter-08-strips:p06.pddl:
+      astar(merge_and_shrink(
+            merge_strategy=merge_stateless(merge_selector=
+                score_based_filtering(scoring_functions=[goal_relevance,dfp,
+                                                         total_order])),
+            shrink_strategy=shrink_bisimulation(greedy=false),
+            label_reduction=exact(before_shrinking=true,before_merging=false),
+            max_states=50000,threshold_before_merge=1))
+
+      The same behavioral difference can be obtained even without modifying
+      the merge-and-shrink code, using the two revisions c66ee00a250a and
+      d2e317621f2c. Running the above config, adapted to the old syntax,
+      yields the same difference:
+      astar(merge_and_shrink(merge_strategy=merge_dfp,
+            shrink_strategy=shrink_bisimulation(greedy=false,max_states=50000,
+                                                threshold=1),
+            label_reduction=exact(before_shrinking=true,before_merging=false)))
+    */
+    int label_group_counter = 0;
+    for (const GroupAndTransitions &gat : ts) {
+        int cost = gat.label_group.get_cost();
+        for (const Transition &transition : gat.transitions) {
+            if (greedy) {
+                int src_h = distances.get_goal_distance(transition.src);
+                int target_h = distances.get_goal_distance(transition.target);
+                assert(target_h + cost >= src_h);
+                if (target_h + cost != src_h)
+                    continue;
+            }
+            callback(label_group_counter, transition);
         }
-        cout << "])" << endl;
+        ++label_group_counter;
+    }
+}
+
+/*
+  Successor signatures of the states considered in one refinement round.
+  The signature of the i-th state starts at position offsets[i] of entries
+  and has sizes[i] entries.
+*/
+struct SignatureTable {
+    vector<int> offsets;
+    vector<int> sizes;
+    vector<SignatureEntry> entries;
+    vector<uint64_t> hashes;
+
+    bool are_equal(int pos1, int pos2) const {
+        if (hashes[pos1] != hashes[pos2] || sizes[pos1] != sizes[pos2])
+            return false;
+        const SignatureEntry *begin1 = entries.data() + offsets[pos1];
+        return equal(begin1, begin1 + sizes[pos1], entries.data() + offsets[pos2]);
+    }
+
+    bool is_less(int pos1, int pos2) const {
+        const SignatureEntry *begin1 = entries.data() + offsets[pos1];
+        const SignatureEntry *begin2 = entries.data() + offsets[pos2];
+        return lexicographical_compare(
+            begin1, begin1 + sizes[pos1], begin2, begin2 + sizes[pos2]);
     }
 };
 
+// Number of states for which one job computes the signatures.
+static const int STATES_PER_JOB = 1024;
 
 ShrinkBisimulation::ShrinkBisimulation(const Options &opts)
     : ShrinkStrategy(),
@@ -127,98 +203,96 @@ int ShrinkBisimulation::initialize_groups(const FactoredTransitionSystem &fts,
     return num_groups;
 }
 
-void ShrinkBisimulation::compute_signatures(
-    const FactoredTransitionSystem &fts,
-    int index,
-    vector<Signature> &signatures,
-    const vector<int> &state_to_group) const {
-    assert(signatures.empty());
-    const TransitionSystem &ts = fts.get_ts(index);
-    const Distances &distances = fts.get_dist(index);
-
-    // Step 1: Compute bare state signatures (without transition information).
-    signatures.push_back(Signature(-2, false, -1, SuccessorSignature(), -1));
-    for (int state = 0; state < ts.get_size(); ++state) {
-        int h = distances.get_goal_distance(state);
-        assert(h >= 0 && h <= distances.get_max_h());
-        Signature signature(h, ts.is_goal_state(state),
-                            state_to_group[state], SuccessorSignature(),
-                            state);
-        signatures.push_back(signature);
+/*
+  Compute the successor signatures of the given states, which refer to the
+  groups given by state_to_group. state_to_pos maps every state to its
+  position in states or to -1, and num_successors contains the number of
+  relevant transitions of every state.
+
+  Collecting the entries needs a pass over all transitions. Sorting and
+  hashing the signatures, which takes most of the time, is split into jobs
+  that can run in parallel because every state has its own part of the
+  table.
+*/
+static void compute_signatures(
+    const TransitionSystem &ts,
+    const Distances &distances,
+    bool greedy,
+    const vector<int> &states,
+    const vector<int> &state_to_pos,
+    const vector<int> &num_successors,
+    const vector<int> &state_to_group,
+    int num_threads,
+    SignatureTable &table) {
+    int num_states = states.size();
+    table.offsets.resize(num_states);
+    table.sizes.resize(num_states);
+    table.hashes.resize(num_states);
+    int num_entries = 0;
+    for (int pos = 0; pos < num_states; ++pos) {
+        table.offsets[pos] = num_entries;
+        table.sizes[pos] = 0;
+        num_entries += num_successors[states[pos]];
     }
-    signatures.push_back(Signature(INF, false, -1, SuccessorSignature(), -1));
-
-    // Step 2: Add transition information.
-    int label_group_counter = 0;
-    /*
-      Note that the final result of the bisimulation may depend on the
-      order in which transitions are considered below.
-
-      If label groups were sorted (every group by increasing label numbers,
-      groups by smallest label number), then the following configuration
-      gives a different result on parcprinter-08-strips:p06.pddl:
-      astar(merge_and_shrink(
-            merge_strategy=merge_stateless(merge_selector=
-                score_based_filtering(scoring_functions=[goal_relevance,dfp,
-                                                         total_order])),
-            shrink_strategy=shrink_bisimulation(greedy=false),
-            label_reduction=exact(before_shrinking=true,before_merging=false),
-            max_states=50000,threshold_before_merge=1))
-
-      The same behavioral difference can be obtained even without modifying
-      the merge-and-shrink code, using the two revisions c66ee00a250a and
-      d2e317621f2c. Running the above config, adapted to the old syntax,
-      yields the same difference:
-      astar(merge_and_shrink(merge_strategy=merge_dfp,
-            shrink_strategy=shrink_bisimulation(greedy=false,max_states=50000,
-                                                threshold=1),
-            label_reduction=exact(before_shrinking=true,before_merging=false)))
-    */
-    for (const GroupAndTransitions &gat : ts) {
-        const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
-        for (const Transition &transition : transitions) {
-            assert(signatures[transition.src + 1].state == transition.src);
-            bool skip_transition = false;
-            if (greedy) {
-                int src_h = distances.get_goal_distance(transition.src);
-                int target_h = distances.get_goal_distance(transition.target);
-                int cost = label_group.get_cost();
-                assert(target_h + cost >= src_h);
-                skip_transition = (target_h + cost != src_h);
+    table.entries.resize(num_entries);
+
+    for_each_relevant_transition(
+        ts, distances, greedy,
+        [&](int label_group, const Transition &transition) {
+            int pos = state_to_pos[transition.src];
+            if (pos != -1) {
+                table.entries[table.offsets[pos] + table.sizes[pos]++] =
+                    make_signature_entry(
+                        label_group, state_to_group[transition.target]);
             }
-            if (!skip_transition) {
-                int target_group = state_to_group[transition.target];
-                signatures[transition.src + 1].succ_signature.push_back(
-                    make_pair(label_group_counter, target_group));
+        });
+
+    int num_jobs = (num_states + STATES_PER_JOB - 1) / STATES_PER_JOB;
+    utils::run_in_parallel(
+        num_jobs, num_threads,
+        [&](int, int job_id) {
+            int end_pos = min(num_states, (job_id + 1) * STATES_PER_JOB);
+            for (int pos = job_id * STATES_PER_JOB; pos < end_pos; ++pos) {
+                SignatureEntry *begin = table.entries.data() + table.offsets[pos];
+                SignatureEntry *end = begin + table.sizes[pos];
+                sort(begin, end);
+                end = unique(begin, end);
+                table.sizes[pos] = end - begin;
+                table.hashes[pos] = hash_signature(begin, end);
             }
-        }
-        ++label_group_counter;
-    }
+        });
+}
 
-    /* Step 3: Canonicalize the representation. The resulting
-       signatures must satisfy the following properties:
-
-       1. Signature::operator< defines a total order with the correct
-          sentinels at the start and end. The signatures vector is
-          sorted according to that order.
-       2. Goal states come before non-goal states, and low-h states come
-          before high-h states.
-       3. States that currently fall into the same group form contiguous
-          subsequences.
-       4. Two signatures compare equal according to Signature::operator<
-          iff we don't want to distinguish their states in the current
-          bisimulation round.
-     */
-
-    for (size_t i = 0; i < signatures.size(); ++i) {
-        SuccessorSignature &succ_sig = signatures[i].succ_signature;
-        ::sort(succ_sig.begin(), succ_sig.end());
-        succ_sig.erase(::unique(succ_sig.begin(), succ_sig.end()),
-                       succ_sig.end());
+/*
+  The given signatures are sorted. Make sure that signatures of the same
+  group with equal successor signatures are adjacent even if the hashes of
+  different successor signatures collide.
+*/
+static void resolve_hash_collisions(
+    vector<Signature> &signatures, const SignatureTable &table) {
+    int num_signatures = signatures.size();
+    int run_start = 0;
+    while (run_start < num_signatures) {
+        const Signature &first = signatures[run_start];
+        int run_end = run_start + 1;
+        bool collision = false;
+        while (run_end < num_signatures &&
+               signatures[run_end].h_and_goal == first.h_and_goal &&
+               signatures[run_end].group == first.group &&
+               signatures[run_end].hash == first.hash) {
+            if (!table.are_equal(first.pos, signatures[run_end].pos))
+                collision = true;
+            ++run_end;
+        }
+        if (collision) {
+            stable_sort(signatures.begin() + run_start,
+                        signatures.begin() + run_end,
+                        [&](const Signature &sig1, const Signature &sig2) {
+                            return table.is_less(sig1.pos, sig2.pos);
+                        });
+        }
+        run_start = run_end;
     }
-
-    ::sort(signatures.begin(), signatures.end());
 }
 
 bool ShrinkBisimulation::shrink(
@@ -231,59 +305,92 @@ bool ShrinkBisimulation::shrink(
     int num_states = ts.get_size();
 
     vector<int> state_to_group(num_states);
-    vector<Signature> signatures;
-    signatures.reserve(num_states + 2);
-
     int num_groups = initialize_groups(fts, index, state_to_group);
     // cout << "number of initial groups: " << num_groups << endl;
 
     // TODO: We currently violate this; see issue250
     // assert(num_groups <= target_size);
 
-    int max_h = distances.get_max_h();
-    assert(max_h >= 0 && max_h != INF);
+    vector<int> h_and_goal(num_states);
+    for (int state = 0; state < num_states; ++state) {
+        int h = distances.get_goal_distance(state);
+        assert(h >= 0 && h <= distances.get_max_h());
+        h_and_goal[state] = ts.is_goal_state(state) ? -1 : h;
+    }
+
+    vector<int> num_successors(num_states, 0);
+    for_each_relevant_transition(
+        ts, distances, greedy,
+        [&](int, const Transition &transition) {
+            ++num_successors[transition.src];
+        });
 
-    bool stable = false;
+    /*
+      We refine the groups in rounds. In every round, we split each group
+      into the sets of states with the same successor signature, where the
+      signatures refer to the groups at the start of the round. We process
+      the states in order of increasing h value (goal states first) so that
+      we can stop before exceeding the size limit.
+
+      The signatures of a group can only differ if the group of one of the
+      successors of its states changed in the previous round. We call such
+      groups dirty and only consider the states of dirty groups. In the
+      first round, all groups are dirty.
+    */
+    vector<bool> is_dirty(num_groups, true);
+    vector<int> states;
+    vector<int> state_to_pos(num_states);
+    vector<Signature> signatures;
+    SignatureTable table;
+    vector<bool> moved(num_states);
     bool stop_requested = false;
-    while (!stable && !stop_requested && num_groups < target_size) {
-        stable = true;
+    while (!stop_requested && num_groups < target_size) {
+        states.clear();
+        for (int state = 0; state < num_states; ++state) {
+            if (is_dirty[state_to_group[state]]) {
+                state_to_pos[state] = states.size();
+                states.push_back(state);
+            } else {
+                state_to_pos[state] = -1;
+            }
+        }
+        if (states.empty())
+            break;
 
+        compute_signatures(ts, distances, greedy, states, state_to_pos,
+                           num_successors, state_to_group,
+                           fts.get_num_threads(), table);
         signatures.clear();
-        compute_signatures(fts, index, signatures, state_to_group);
-
-        // Verify size of signatures and presence of sentinels.
-        assert(static_cast<int>(signatures.size()) == num_states + 2);
-        assert(signatures[0].h_and_goal == -2);
-        assert(signatures[num_states + 1].h_and_goal == INF);
-
-        int sig_start = 1; // Skip over initial sentinel.
-        while (true) {
-            int h_and_goal = signatures[sig_start].h_and_goal;
-            if (h_and_goal > max_h) {
-                // We have hit the end sentinel.
-                assert(h_and_goal == INF);
-                assert(sig_start + 1 == static_cast<int>(signatures.size()));
-                break;
-            }
+        for (size_t pos = 0; pos < states.size(); ++pos) {
+            int state = states[pos];
+            signatures.emplace_back(h_and_goal[state], state_to_group[state],
+                                    table.hashes[pos], pos);
+        }
+        sort(signatures.begin(), signatures.end());
+        resolve_hash_collisions(signatures, table);
+
+        moved.assign(num_states, false);
+        bool any_moved = false;
+        int num_signatures = signatures.size();
+        int sig_start = 0;
+        while (sig_start < num_signatures) {
+            int group_h_and_goal = signatures[sig_start].h_and_goal;
 
             // Compute the number of groups needed after splitting.
             int num_old_groups = 0;
             int num_new_groups = 0;
             int sig_end;
-            for (sig_end = sig_start; true; ++sig_end) {
-                if (signatures[sig_end].h_and_goal != h_and_goal)
-                    break;
-
-                const Signature &prev_sig = signatures[sig_end - 1];
+            for (sig_end = sig_start; sig_end < num_signatures; ++sig_end) {
                 const Signature &curr_sig = signatures[sig_end];
+                if (curr_sig.h_and_goal != group_h_and_goal)
+                    break;
 
-                if (sig_end == sig_start)
-                    assert(prev_sig.group != curr_sig.group);
-
-                if (prev_sig.group != curr_sig.group) {
+                if (sig_end == sig_start ||
+                    signatures[sig_end - 1].group != curr_sig.group) {
                     ++num_old_groups;
                     ++num_new_groups;
-                } else if (prev_sig.succ_signature != curr_sig.succ_signature) {
+                } else if (!table.are_equal(signatures[sig_end - 1].pos,
+                                            curr_sig.pos)) {
                     ++num_new_groups;
                 }
             }
@@ -299,24 +406,27 @@ bool ShrinkBisimulation::shrink(
                 break;
             } else if (num_new_groups != num_old_groups) {
                 // Split into new groups.
-                stable = false;
-
                 int new_group_no = -1;
                 for (int i = sig_start; i < sig_end; ++i) {
-                    const Signature &prev_sig = signatures[i - 1];
                     const Signature &curr_sig = signatures[i];
 
-                    if (prev_sig.group != curr_sig.group) {
+                    if (i == sig_start ||
+                        signatures[i - 1].group != curr_sig.group) {
                         // Start first group of a block; keep old group no.
                         new_group_no = curr_sig.group;
-                    } else if (prev_sig.succ_signature
-                               != curr_sig.succ_signature) {
+                    } else if (!table.are_equal(signatures[i - 1].pos,
+                                                curr_sig.pos)) {
                         new_group_no = num_groups++;
                         assert(num_groups <= target_size);
                     }
 
                     assert(new_group_no != -1);
-                    state_to_group[curr_sig.state] = new_group_no;
+                    int state = states[curr_sig.pos];
+                    if (state_to_group[state] != new_group_no) {
+                        state_to_group[state] = new_group_no;
+                        moved[state] = true;
+                        any_moved = true;
+                    }
                     if (num_groups == target_size)
                         break;
                 }
@@ -325,12 +435,27 @@ bool ShrinkBisimulation::shrink(
             }
             sig_start = sig_end;
         }
+
+        // The groups of all predecessors of moved states become dirty.
+        is_dirty.assign(num_groups, false);
+        if (any_moved) {
+            for_each_relevant_transition(
+                ts, distances, greedy,
+                [&](int, const Transition &transition) {
+                    if (moved[transition.target])
+                        is_dirty[state_to_group[transition.src]] = true;
+                });
+        }
     }
 
     /* Reduce memory pressure before generating the equivalence
        relation since this is one of the code parts relevant to peak
        memory. */
     utils::release_vector_memory(signatures);
+    utils::release_vector_memory(table.offsets);
+    utils::release_vector_memory(table.sizes);
+    utils::release_vector_memory(table.entries);
+    utils::release_vector_memory(table.hashes);
 
     // Generate final result.
     StateEquivalenceRelation equivalence_relation;
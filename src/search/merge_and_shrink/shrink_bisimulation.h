@@ -8,8 +8,6 @@ class Options;
 }
 
 namespace merge_and_shrink {
-struct Signature;
-
 class ShrinkBisimulation : public ShrinkStrategy {
     enum AtLimit {
         RETURN,
@@ -27,10 +25,6 @@ class ShrinkBisimulation : public ShrinkStrategy {
     int initialize_groups(const FactoredTransitionSystem &fts,
                           int index,
                           std::vector<int> &state_to_group) const;
-    void compute_signatures(const FactoredTransitionSystem &fts,
-                            int index,
-                            std::vector<Signature> &signatures,
-                            const std::vector<int> &state_to_group) const;
 protected:
     virtual void dump_strategy_specific_options() const override;
     virtual std::string name() const override;
@@ -5,6 +5,7 @@
 #include "labels.h"
 
 #include "../utils/collections.h"
+#include "../utils/language.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
 
@@ -12,7 +13,7 @@
 #include <cassert>
 #include <iostream>
 #include <iterator>
-#include <set>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -27,18 +28,95 @@ ostream &operator<<(ostream &os, const Transition &trans) {
     return os;
 }
 
-// Sorts the given set of transitions and removes duplicates.
-static void normalize_given_transitions(vector<Transition> &transitions) {
-    sort(transitions.begin(), transitions.end());
-    transitions.erase(unique(transitions.begin(), transitions.end()), transitions.end());
+/*
+  Ranges with fewer transitions than this are sorted with std::sort
+  because setting up the counting sort passes would dominate.
+*/
+static const int MIN_TRANSITIONS_FOR_RADIX_SORT = 64;
+
+/*
+  Stable counting sort of size transitions from "from" to "to" by the
+  given key, which must be a state of a transition system with num_states
+  states. counts is used as scratch space.
+*/
+template<typename KeyFunction>
+static void counting_sort_transitions(
+    const Transition *from, int size, Transition *to, int num_states,
+    vector<int> &counts, const KeyFunction &get_key) {
+    counts.assign(num_states + 1, 0);
+    for (int i = 0; i < size; ++i)
+        ++counts[get_key(from[i]) + 1];
+    for (int state = 0; state < num_states; ++state)
+        counts[state + 1] += counts[state];
+    for (int i = 0; i < size; ++i)
+        to[counts[get_key(from[i])]++] = from[i];
+}
+
+/*
+  Sort the given transitions of a transition system with num_states states
+  and remove duplicates. Returns the new end of the range. Large ranges
+  are sorted by an LSD radix sort with one digit per state component
+  (first by target, then stably by source), which takes linear time in
+  the number of transitions and states. buffer and counts are used as
+  scratch space and can be reused between calls.
+*/
+static Transition *normalize_transitions(
+    Transition *first, Transition *last, int num_states,
+    vector<Transition> &buffer, vector<int> &counts) {
+    int size = last - first;
+    if (size < MIN_TRANSITIONS_FOR_RADIX_SORT || size < num_states / 2) {
+        sort(first, last);
+    } else {
+        if (static_cast<int>(buffer.size()) < size)
+            buffer.resize(size, Transition(0, 0));
+        counting_sort_transitions(
+            first, size, buffer.data(), num_states, counts,
+            [](const Transition &t) {return t.target;});
+        counting_sort_transitions(
+            buffer.data(), size, first, num_states, counts,
+            [](const Transition &t) {return t.src;});
+    }
+    return unique(first, last);
+}
+
+/*
+  A label group of a product transition system together with the ids of
+  the groups of the two components whose transitions it combines.
+*/
+struct ProductGroup {
+    int group1_id;
+    int group2_id;
+    vector<int> labels;
+
+    ProductGroup(int group1_id, int group2_id, vector<int> &&labels)
+        : group1_id(group1_id), group2_id(group2_id), labels(move(labels)) {
+    }
+};
+
+/*
+  Split the given transitions, which must be sorted, into runs with the
+  same source state. Run i consists of the transitions at positions
+  runs[i], ..., runs[i + 1] - 1.
+*/
+static void compute_source_runs(
+    const TransitionRange &transitions, vector<int> &runs) {
+    runs.clear();
+    int num_transitions = transitions.size();
+    for (int i = 0; i < num_transitions; ++i) {
+        if (i == 0 || transitions[i].src != transitions[i - 1].src)
+            runs.push_back(i);
+    }
+    runs.push_back(num_transitions);
 }
 
 TSConstIterator::TSConstIterator(
     const LabelEquivalenceRelation &label_equivalence_relation,
-    const vector<vector<Transition>> &transitions_by_group_id,
+    const vector<Transition> &transitions,
+    const vector<int> &group_offsets,
     bool end)
     : label_equivalence_relation(label_equivalence_relation),
-      transitions_by_group_id(transitions_by_group_id),
+      transitions(transitions),
+      group_offsets(group_offsets),
       current_group_id((end ? label_equivalence_relation.get_size() : 0)) {
     next_valid_index();
 }
@@ -58,7 +136,9 @@ void TSConstIterator::operator++() {
 GroupAndTransitions TSConstIterator::operator*() const {
     return GroupAndTransitions(
         label_equivalence_relation.get_group(current_group_id),
-        transitions_by_group_id[current_group_id]);
+        TransitionRange(
+            transitions.data() + group_offsets[current_group_id],
+            transitions.data() + group_offsets[current_group_id + 1]));
 }
 
 
@@ -75,13 +155,19 @@ GroupAndTransitions TSConstIterator::operator*() const {
   transitions itself. Various experiments have shown that maintaining
   a graph representation permanently for the benefit of distance
   computation is not worth the overhead.
+
+  All operations that change the transitions keep every group sorted
+  and free of duplicates. Merging emits the product transitions of two
+  groups directly in sorted order, and applying an abstraction rewrites
+  the transition table in place and sorts each group with a radix sort.
 */
 
 TransitionSystem::TransitionSystem(
     int num_variables,
     vector<int> &&incorporated_variables,
     unique_ptr<LabelEquivalenceRelation> &&label_equivalence_relation,
-    vector<vector<Transition>> &&transitions_by_label,
+    vector<Transition> &&transitions,
+    vector<int> &&group_offsets,
     int num_states,
     vector<bool> &&goal_states,
     int init_state,
@@ -89,10 +175,14 @@ TransitionSystem::TransitionSystem(
     : num_variables(num_variables),
       incorporated_variables(move(incorporated_variables)),
       label_equivalence_relation(move(label_equivalence_relation)),
-      transitions_by_group_id(move(transitions_by_label)),
+      transitions(move(transitions)),
+      group_offsets(move(group_offsets)),
       num_states(num_states),
       goal_states(move(goal_states)),
       init_state(init_state) {
+    assert(static_cast<int>(this->group_offsets.size()) ==
+           this->label_equivalence_relation->get_size() + 1);
+    assert(this->group_offsets.back() == static_cast<int>(this->transitions.size()));
     if (compute_label_equivalence_relation) {
         compute_locally_equivalent_labels();
     }
@@ -123,7 +213,6 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         back_inserter(incorporated_variables));
     unique_ptr<LabelEquivalenceRelation> label_equivalence_relation =
         utils::make_unique_ptr<LabelEquivalenceRelation>(labels);
-    vector<vector<Transition>> transitions_by_group_id(labels.get_max_size());
 
     int ts1_size = ts1.get_size();
     int ts2_size = ts2.get_size();
@@ -150,12 +239,21 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
       (B) they are both dead in T (e.g., this includes the case where
           l is dead in T1 only and l' is dead in T2 only, so they are not
           locally equivalent in either of the components).
+
+      We first collect the new groups together with the groups of T1 and
+      T2 they stem from. This tells us the exact size of the transition
+      table before we compute the product transitions.
     */
-    int multiplier = ts2_size;
+    vector<ProductGroup> product_groups;
+    long long num_transitions = 0;
     vector<int> dead_labels;
-    for (const GroupAndTransitions &gat : ts1) {
-        const LabelGroup &group1 = gat.label_group;
-        const vector<Transition> &transitions1 = gat.transitions;
+    for (int group1_id = 0; group1_id < ts1.label_equivalence_relation->get_size();
+         ++group1_id) {
+        if (ts1.label_equivalence_relation->is_empty_group(group1_id))
+            continue;
+        const LabelGroup &group1 =
+            ts1.label_equivalence_relation->get_group(group1_id);
+        TransitionRange transitions1 = ts1.get_transitions_for_group_id(group1_id);
 
         // Distribute the labels of this group among the "buckets"
         // corresponding to the groups of ts2.
@@ -167,41 +265,65 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         // Now buckets contains all equivalence classes that are
         // refinements of group1.
 
-        // Now create the new groups together with their transitions.
-        for (const auto &bucket : buckets) {
-            const vector<Transition> &transitions2 =
-                ts2.get_transitions_for_group_id(bucket.first);
-
-            // Create the new transitions for this bucket
-            vector<Transition> new_transitions;
-            if (transitions1.size() && transitions2.size()
-                && transitions1.size() > new_transitions.max_size() / transitions2.size())
-                utils::exit_with(ExitCode::OUT_OF_MEMORY);
-            new_transitions.reserve(transitions1.size() * transitions2.size());
-            for (const Transition &transition1 : transitions1) {
-                int src1 = transition1.src;
-                int target1 = transition1.target;
-                for (const Transition &transition2 : transitions2) {
-                    int src2 = transition2.src;
-                    int target2 = transition2.target;
-                    int src = src1 * multiplier + src2;
-                    int target = target1 * multiplier + target2;
-                    new_transitions.push_back(Transition(src, target));
-                }
-            }
-
-            // Create a new group if the transitions are not empty
-            const vector<int> &new_labels = bucket.second;
-            if (new_transitions.empty()) {
+        for (auto &bucket : buckets) {
+            long long num_product_transitions =
+                static_cast<long long>(transitions1.size()) *
+                ts2.get_transitions_for_group_id(bucket.first).size();
+            vector<int> &new_labels = bucket.second;
+            if (num_product_transitions == 0) {
                 dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
             } else {
-                sort(new_transitions.begin(), new_transitions.end());
-                int new_index = label_equivalence_relation->add_label_group(new_labels);
-                transitions_by_group_id[new_index] = move(new_transitions);
+                num_transitions += num_product_transitions;
+                if (num_transitions > numeric_limits<int>::max())
+                    utils::exit_with(ExitCode::OUT_OF_MEMORY);
+                product_groups.emplace_back(
+                    group1_id, bucket.first, move(new_labels));
             }
         }
     }
 
+    vector<Transition> transitions;
+    transitions.reserve(num_transitions);
+    vector<int> group_offsets;
+    group_offsets.reserve(labels.get_max_size() + 1);
+    group_offsets.push_back(0);
+    vector<int> runs1;
+    vector<int> runs2;
+    for (const ProductGroup &product_group : product_groups) {
+        TransitionRange transitions1 =
+            ts1.get_transitions_for_group_id(product_group.group1_id);
+        TransitionRange transitions2 =
+            ts2.get_transitions_for_group_id(product_group.group2_id);
+        /*
+          Both ranges are sorted and unique. We split them into runs of
+          transitions with the same source state. Combining the runs in
+          lexicographic order of their sources and the transitions within
+          two runs in lexicographic order of their targets generates the
+          product transitions sorted and unique, so no sorting is needed.
+        */
+        compute_source_runs(transitions1, runs1);
+        compute_source_runs(transitions2, runs2);
+        for (size_t run1 = 0; run1 + 1 < runs1.size(); ++run1) {
+            for (size_t run2 = 0; run2 + 1 < runs2.size(); ++run2) {
+                for (int i = runs1[run1]; i < runs1[run1 + 1]; ++i) {
+                    const Transition &transition1 = transitions1[i];
+                    for (int j = runs2[run2]; j < runs2[run2 + 1]; ++j) {
+                        const Transition &transition2 = transitions2[j];
+                        transitions.emplace_back(
+                            transition1.src * ts2_size + transition2.src,
+                            transition1.target * ts2_size + transition2.target);
+                    }
+                }
+            }
+        }
+        int new_group_id =
+            label_equivalence_relation->add_label_group(product_group.labels);
+        assert(new_group_id + 1 == static_cast<int>(group_offsets.size()));
+        utils::unused_variable(new_group_id);
+        group_offsets.push_back(transitions.size());
+    }
+    assert(static_cast<long long>(transitions.size()) == num_transitions);
+
     /*
       We collect all dead labels separately, because the bucket refining
       does not work in cases where there are at least two dead labels l1
@@ -212,13 +334,15 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
     if (!dead_labels.empty()) {
         // Dead labels have empty transitions
         label_equivalence_relation->add_label_group(dead_labels);
+        group_offsets.push_back(transitions.size());
     }
 
     return utils::make_unique_ptr<TransitionSystem>(
         num_variables,
         move(incorporated_variables),
         move(label_equivalence_relation),
-        move(transitions_by_group_id),
+        move(transitions),
+        move(group_offsets),
         num_states,
         move(goal_states),
         init_state,
@@ -231,24 +355,45 @@ void TransitionSystem::compute_locally_equivalent_labels() {
       Compare every group of labels and their transitions to all others and
       merge two groups whenever the transitions are the same.
     */
+    bool merged_groups = false;
     for (int group_id1 = 0; group_id1 < label_equivalence_relation->get_size();
          ++group_id1) {
         if (!label_equivalence_relation->is_empty_group(group_id1)) {
-            const vector<Transition> &transitions1 = transitions_by_group_id[group_id1];
+            TransitionRange transitions1 = get_transitions_for_group_id(group_id1);
             for (int group_id2 = group_id1 + 1;
                  group_id2 < label_equivalence_relation->get_size(); ++group_id2) {
                 if (!label_equivalence_relation->is_empty_group(group_id2)) {
-                    vector<Transition> &transitions2 = transitions_by_group_id[group_id2];
-                    if ((transitions1.empty() && transitions2.empty())
-                        || transitions1 == transitions2) {
+                    TransitionRange transitions2 = get_transitions_for_group_id(group_id2);
+                    if (transitions1.size() == transitions2.size() &&
+                        equal(transitions1.begin(), transitions1.end(),
+                              transitions2.begin())) {
                         label_equivalence_relation->move_group_into_group(
                             group_id2, group_id1);
-                        utils::release_vector_memory(transitions2);
+                        merged_groups = true;
                     }
                 }
             }
         }
     }
+    if (merged_groups)
+        remove_transitions_of_empty_groups();
+}
+
+void TransitionSystem::remove_transitions_of_empty_groups() {
+    int num_groups = group_offsets.size() - 1;
+    int new_end = 0;
+    for (int group_id = 0; group_id < num_groups; ++group_id) {
+        int old_begin = group_offsets[group_id];
+        int old_end = group_offsets[group_id + 1];
+        group_offsets[group_id] = new_end;
+        if (!label_equivalence_relation->is_empty_group(group_id)) {
+            copy(transitions.begin() + old_begin, transitions.begin() + old_end,
+                 transitions.begin() + new_end);
+            new_end += old_end - old_begin;
+        }
+    }
+    group_offsets[num_groups] = new_end;
+    transitions.erase(transitions.begin() + new_end, transitions.end());
 }
 
 bool TransitionSystem::apply_abstraction(
@@ -288,33 +433,42 @@ bool TransitionSystem::apply_abstraction(
 
     goal_states = move(new_goal_states);
 
-    // Update all transitions.
-    for (vector<Transition> &transitions : transitions_by_group_id) {
-        if (!transitions.empty()) {
-            vector<Transition> new_transitions;
-            /*
-              We reserve more memory than necessary here, but this is better
-              than potentially resizing the vector several times when inserting
-              transitions one after the other. See issue604-v6.
-
-              An alternative could be to not use a new vector, but to modify
-              the existing transitions inplace, and to remove all empty
-              positions in the end. This would be more ugly, though.
-            */
-            new_transitions.reserve(transitions.size());
-            for (size_t i = 0; i < transitions.size(); ++i) {
-                const Transition &transition = transitions[i];
-                int src = abstraction_mapping[transition.src];
-                int target = abstraction_mapping[transition.target];
-                if (src != PRUNED_STATE && target != PRUNED_STATE)
-                    new_transitions.push_back(Transition(src, target));
-            }
-            normalize_given_transitions(new_transitions);
-            transitions = move(new_transitions);
+    /*
+      Update all transitions. We rewrite the transition table in place,
+      which is safe because we never write a mapped transition to a
+      position after the transition that is read next.
+    */
+    vector<Transition> buffer;
+    vector<int> counts;
+    int num_groups = label_equivalence_relation->get_size();
+    int new_end = 0;
+    for (int group_id = 0; group_id < num_groups; ++group_id) {
+        int old_begin = group_offsets[group_id];
+        int old_end = group_offsets[group_id + 1];
+        int new_begin = new_end;
+        group_offsets[group_id] = new_begin;
+        for (int i = old_begin; i < old_end; ++i) {
+            const Transition &transition = transitions[i];
+            int src = abstraction_mapping[transition.src];
+            int target = abstraction_mapping[transition.target];
+            if (src != PRUNED_STATE && target != PRUNED_STATE)
+                transitions[new_end++] = Transition(src, target);
         }
+        Transition *first = transitions.data() + new_begin;
+        new_end = normalize_transitions(
+            first, first + (new_end - new_begin), new_num_states,
+            buffer, counts) - transitions.data();
     }
+    group_offsets[num_groups] = new_end;
+    transitions.erase(transitions.begin() + new_end, transitions.end());
 
     compute_locally_equivalent_labels();
+    /*
+      Release the memory of the transitions removed by the abstraction if
+      this is worth the temporary copy.
+    */
+    if (transitions.size() < transitions.capacity() / 2)
+        transitions.shrink_to_fit();
 
     num_states = new_num_states;
     init_state = abstraction_mapping[init_state];
@@ -365,24 +519,33 @@ void TransitionSystem::apply_label_reduction(
           updating label_equivalence_relation, because after updating it,
           we cannot find out the group id of reduced labels anymore.
         */
-        unordered_map<int, vector<Transition>> new_label_to_transitions;
+        vector<vector<Transition>> new_label_transitions;
+        new_label_transitions.reserve(label_mapping.size());
+        size_t num_new_transitions = 0;
         unordered_set<int> affected_group_ids;
+        vector<Transition> buffer;
+        vector<int> counts;
         for (const pair<int, vector<int>> &mapping: label_mapping) {
-            int new_label_no = mapping.first;
             const vector<int> &old_label_nos = mapping.second;
             assert(old_label_nos.size() >= 2);
             unordered_set<int> seen_group_ids;
-            set<Transition> new_label_transitions;
+            vector<Transition> new_transitions;
             for (int old_label_no : old_label_nos) {
                 int group_id = label_equivalence_relation->get_group_id(old_label_no);
                 if (seen_group_ids.insert(group_id).second) {
                     affected_group_ids.insert(group_id);
-                    const vector<Transition> &transitions = transitions_by_group_id[group_id];
-                    new_label_transitions.insert(transitions.begin(), transitions.end());
+                    TransitionRange transitions = get_transitions_for_group_id(group_id);
+                    new_transitions.insert(
+                        new_transitions.end(), transitions.begin(), transitions.end());
                 }
             }
-            new_label_to_transitions[new_label_no] =
-                vector<Transition>(new_label_transitions.begin(), new_label_transitions.end());
+            Transition *first = new_transitions.data();
+            Transition *last = normalize_transitions(
+                first, first + new_transitions.size(), num_states, buffer, counts);
+            new_transitions.erase(new_transitions.begin() + (last - first),
+                                  new_transitions.end());
+            num_new_transitions += new_transitions.size();
+            new_label_transitions.push_back(move(new_transitions));
         }
 
         /*
@@ -392,23 +555,36 @@ void TransitionSystem::apply_label_reduction(
            because only after updating label_equivalence_relation, we know the
            group id of the new labels and which old groups became empty.
         */
+        int num_old_groups = label_equivalence_relation->get_size();
         label_equivalence_relation->apply_label_mapping(label_mapping, &affected_group_ids);
 
-        // Go over the new transitions and add them at the correct position.
-        for (auto &label_and_transitions : new_label_to_transitions) {
-            int new_label_no = label_and_transitions.first;
-            vector<Transition> &transitions = label_and_transitions.second;
-            int new_group_id = label_equivalence_relation->get_group_id(new_label_no);
-            transitions_by_group_id[new_group_id] = move(transitions);
-        }
+        // Remove the transitions of old groups that became empty.
+        remove_transitions_of_empty_groups();
 
-        // Go over all affected group ids and remove their transitions if the
-        // group is empty.
-        for (int group_id : affected_group_ids) {
-            if (label_equivalence_relation->is_empty_group(group_id)) {
-                utils::release_vector_memory(transitions_by_group_id[group_id]);
-            }
+        /*
+          Every new label forms a new group. These groups are appended in the
+          order of the label mapping, so we append their transitions to the
+          end of the transition table in the same order. We copy the table
+          into a vector of the exact new size because it usually lost most of
+          its transitions to the new groups, and otherwise the unused capacity
+          would be kept until the next merge.
+        */
+        assert(label_equivalence_relation->get_size() ==
+               num_old_groups + static_cast<int>(label_mapping.size()));
+        utils::unused_variable(num_old_groups);
+        vector<Transition> new_table;
+        new_table.reserve(transitions.size() + num_new_transitions);
+        new_table.insert(new_table.end(), transitions.begin(), transitions.end());
+        for (size_t i = 0; i < label_mapping.size(); ++i) {
+            assert(label_equivalence_relation->get_group_id(label_mapping[i].first) ==
+                   num_old_groups + static_cast<int>(i));
+            vector<Transition> &new_transitions = new_label_transitions[i];
+            new_table.insert(
+                new_table.end(), new_transitions.begin(), new_transitions.end());
+            utils::release_vector_memory(new_transitions);
+            group_offsets.push_back(new_table.size());
         }
+        transitions.swap(new_table);
 
         compute_locally_equivalent_labels();
     }
@@ -424,8 +600,11 @@ string TransitionSystem::tag() const {
 
 bool TransitionSystem::are_transitions_sorted_unique() const {
     for (const GroupAndTransitions &gat : *this) {
-        if (!utils::is_sorted_unique(gat.transitions))
-            return false;
+        const TransitionRange &transitions = gat.transitions;
+        for (size_t i = 1; i < transitions.size(); ++i) {
+            if (transitions[i - 1] >= transitions[i])
+                return false;
+        }
     }
     return true;
 }
@@ -470,7 +649,7 @@ void TransitionSystem::dump_dot_graph() const {
     }
     for (const GroupAndTransitions &gat : *this) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         for (const Transition &transition : transitions) {
             int src = transition.src;
             int target = transition.target;
@@ -501,7 +680,7 @@ void TransitionSystem::dump_labels_and_transitions() const {
         }
         cout << endl;
         cout << "transitions: ";
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         for (size_t i = 0; i < transitions.size(); ++i) {
             int src = transitions[i].src;
             int target = transitions[i].target;
@@ -3,6 +3,7 @@
 
 #include "types.h"
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -36,11 +37,44 @@ struct Transition {
     }
 };
 
+/*
+  A contiguous range of transitions in the transition table of a transition
+  system. It stays valid until the transition system is modified.
+*/
+class TransitionRange {
+    const Transition *first;
+    const Transition *last;
+public:
+    TransitionRange(const Transition *first, const Transition *last)
+        : first(first), last(last) {
+    }
+
+    const Transition *begin() const {
+        return first;
+    }
+
+    const Transition *end() const {
+        return last;
+    }
+
+    std::size_t size() const {
+        return last - first;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+
+    const Transition &operator[](std::size_t index) const {
+        return first[index];
+    }
+};
+
 struct GroupAndTransitions {
     const LabelGroup &label_group;
-    const std::vector<Transition> &transitions;
+    TransitionRange transitions;
     GroupAndTransitions(const LabelGroup &label_group,
-                        const std::vector<Transition> &transitions)
+                        const TransitionRange &transitions)
         : label_group(label_group),
           transitions(transitions) {
     }
@@ -54,14 +88,16 @@ class TSConstIterator {
       easily exchanged.
     */
     const LabelEquivalenceRelation &label_equivalence_relation;
-    const std::vector<std::vector<Transition>> &transitions_by_group_id;
+    const std::vector<Transition> &transitions;
+    const std::vector<int> &group_offsets;
     // current_group_id is the actual iterator
     int current_group_id;
 
     void next_valid_index();
 public:
     TSConstIterator(const LabelEquivalenceRelation &label_equivalence_relation,
-                    const std::vector<std::vector<Transition>> &transitions_by_group_id,
+                    const std::vector<Transition> &transitions,
+                    const std::vector<int> &group_offsets,
                     bool end);
     void operator++();
     GroupAndTransitions operator*() const;
@@ -99,17 +135,18 @@ private:
     std::unique_ptr<LabelEquivalenceRelation> label_equivalence_relation;
 
     /*
-      The transitions of a label group are indexed via its id. The id of a
-      group does not change, and hence its transitions are never moved.
-
-      We tested different alternatives to store the transitions, but they all
-      performed worse: storing a vector transitions in the label group increases
-      memory usage and runtime; storing the transitions more compactly and
-      incrementally increasing the size of transitions_of_groups whenever a
-      new label group is added also increases runtime. See also issue492 and
-      issue521.
+      The transitions of all label groups are stored in one table, ordered
+      by group id. The transitions of the group with id g are at positions
+      group_offsets[g], ..., group_offsets[g + 1] - 1, so group_offsets has
+      one more entry than there are groups. Groups without transitions
+      (including empty groups) have empty ranges.
+
+      Compared to storing one vector of transitions per group, this saves
+      the per-group allocations and their unused capacity, and it allows
+      applying abstractions in place.
     */
-    std::vector<std::vector<Transition>> transitions_by_group_id;
+    std::vector<Transition> transitions;
+    std::vector<int> group_offsets;
 
     int num_states;
     std::vector<bool> goal_states;
@@ -121,8 +158,16 @@ private:
     */
     void compute_locally_equivalent_labels();
 
-    const std::vector<Transition> &get_transitions_for_group_id(int group_id) const {
-        return transitions_by_group_id[group_id];
+    /*
+      Remove the transitions of all empty label groups from the transition
+      table, keeping the order of the remaining transitions.
+    */
+    void remove_transitions_of_empty_groups();
+
+    TransitionRange get_transitions_for_group_id(int group_id) const {
+        return TransitionRange(
+            transitions.data() + group_offsets[group_id],
+            transitions.data() + group_offsets[group_id + 1]);
     }
 
     // Statistics and output
@@ -133,7 +178,8 @@ public:
         int num_variables,
         std::vector<int> &&incorporated_variables,
         std::unique_ptr<LabelEquivalenceRelation> &&label_equivalence_relation,
-        std::vector<std::vector<Transition>> &&transitions_by_label,
+        std::vector<Transition> &&transitions,
+        std::vector<int> &&group_offsets,
         int num_states,
         std::vector<bool> &&goal_states,
         int init_state,
@@ -174,13 +220,15 @@ public:
 
     TSConstIterator begin() const {
         return TSConstIterator(*label_equivalence_relation,
-                               transitions_by_group_id,
+                               transitions,
+                               group_offsets,
                                false);
     }
 
     TSConstIterator end() const {
         return TSConstIterator(*label_equivalence_relation,
-                               transitions_by_group_id,
+                               transitions,
+                               group_offsets,
                                true);
     }
 
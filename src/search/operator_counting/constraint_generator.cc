@@ -2,6 +2,8 @@
 
 #include "../plugin.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace operator_counting {
@@ -9,6 +11,10 @@ void ConstraintGenerator::initialize_constraints(
     const shared_ptr<AbstractTask>, vector<lp::LPConstraint> &, double) {
 }
 
+void ConstraintGenerator::mark_relevant_variables(vector<bool> &relevant) const {
+    fill(relevant.begin(), relevant.end(), true);
+}
+
 static PluginTypePlugin<ConstraintGenerator> _type_plugin(
     "ConstraintGenerator",
     // TODO: Replace empty string by synopsis for the wiki page.
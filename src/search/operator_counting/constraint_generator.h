@@ -49,6 +49,14 @@ public:
     */
     virtual bool update_constraints(const State &state,
                                     lp::LPSolver &lp_solver) = 0;
+
+    /*
+      Set relevant[var] to true for all variables whose value in the
+      evaluated state influences the constraints or the dead-end test.
+      The heuristic reuses LP results for states that agree on all
+      relevant variables. The default marks all variables.
+    */
+    virtual void mark_relevant_variables(std::vector<bool> &relevant) const;
 };
 }
 
@@ -8,6 +8,7 @@
 #include "../utils/markup.h"
 
 #include <cmath>
+#include <iostream>
 
 using namespace std;
 
@@ -16,7 +17,9 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
     : Heuristic(opts),
       constraint_generators(
           opts.get_list<shared_ptr<ConstraintGenerator>>("constraint_generators")),
-      lp_solver(lp::LPSolverType(opts.get_enum("lpsolver"))) {
+      lp_solver(lp::LPSolverType(opts.get_enum("lpsolver"))),
+      num_lp_solves(0),
+      num_cache_hits(0) {
     vector<lp::LPVariable> variables;
     double infinity = lp_solver.get_infinity();
     for (OperatorProxy op : task_proxy.get_operators()) {
@@ -28,6 +31,30 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
         generator->initialize_constraints(task, constraints, infinity);
     }
     lp_solver.load_problem(lp::LPObjectiveSense::MINIMIZE, variables, constraints);
+
+    int num_variables = task_proxy.get_variables().size();
+    vector<bool> relevant(num_variables, false);
+    for (auto generator : constraint_generators) {
+        generator->mark_relevant_variables(relevant);
+    }
+    for (int var = 0; var < num_variables; ++var) {
+        if (relevant[var])
+            relevant_variables.push_back(var);
+    }
+    cout << "Variables relevant for the operator-counting LP: "
+         << relevant_variables.size() << "/" << num_variables << endl;
+    /*
+      States are evaluated at most once by the search, so caching by the
+      full state would only cost memory.
+    */
+    if (static_cast<int>(relevant_variables.size()) == num_variables)
+        relevant_variables.clear();
+    relevant_values.resize(relevant_variables.size());
+
+    update_timer.stop();
+    update_timer.reset();
+    solve_timer.stop();
+    solve_timer.reset();
 }
 
 OperatorCountingHeuristic::~OperatorCountingHeuristic() {
@@ -39,16 +66,41 @@ int OperatorCountingHeuristic::compute_heuristic(const GlobalState &global_state
 }
 
 int OperatorCountingHeuristic::compute_heuristic(const State &state) {
+    if (relevant_variables.empty())
+        return compute_lp_value(state);
+
+    for (size_t i = 0; i < relevant_variables.size(); ++i) {
+        relevant_values[i] = state[relevant_variables[i]].get_value();
+    }
+    auto it = cached_h_values.find(relevant_values);
+    if (it != cached_h_values.end()) {
+        ++num_cache_hits;
+        return it->second;
+    }
+    int result = compute_lp_value(state);
+    if (static_cast<int>(cached_h_values.size()) == MAX_CACHED_H_VALUES)
+        cached_h_values.clear();
+    cached_h_values.emplace(relevant_values, result);
+    return result;
+}
+
+int OperatorCountingHeuristic::compute_lp_value(const State &state) {
     assert(!lp_solver.has_temporary_constraints());
+    update_timer.resume();
     for (auto generator : constraint_generators) {
         bool dead_end = generator->update_constraints(state, lp_solver);
         if (dead_end) {
             lp_solver.clear_temporary_constraints();
+            update_timer.stop();
             return DEAD_END;
         }
     }
+    update_timer.stop();
     int result;
+    solve_timer.resume();
     lp_solver.solve();
+    solve_timer.stop();
+    ++num_lp_solves;
     if (lp_solver.has_optimal_solution()) {
         double epsilon = 0.01;
         double objective_value = lp_solver.get_objective_value();
@@ -60,6 +112,20 @@ int OperatorCountingHeuristic::compute_heuristic(const State &state) {
     return result;
 }
 
+void OperatorCountingHeuristic::print_statistics() const {
+    Heuristic::print_statistics();
+    cout << "LPs of " << get_description() << ":" << endl;
+    lp_solver.print_statistics();
+    cout << "LP solves: " << num_lp_solves << endl;
+    cout << "LP cache hits: " << num_cache_hits << endl;
+    cout << "LP constraint update time: " << update_timer << endl;
+    cout << "LP solve time: " << solve_timer << endl;
+    if (num_lp_solves > 0) {
+        cout << "Average LP solve time: "
+             << solve_timer() / num_lp_solves << "s" << endl;
+    }
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Operator counting heuristic",
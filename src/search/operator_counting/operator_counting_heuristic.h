@@ -5,7 +5,11 @@
 
 #include "../lp/lp_solver.h"
 
+#include "../utils/hash.h"
+#include "../utils/timer.h"
+
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace options {
@@ -15,15 +19,41 @@ class Options;
 namespace operator_counting {
 class ConstraintGenerator;
 
+/*
+  The LP is loaded once. For each state, the constraint generators only
+  push the bounds that differ from the previously evaluated state, and
+  the solver warm-starts from the basis of the previous LP.
+
+  If the constraints depend on a proper subset of the variables,
+  heuristic values are cached by the values of these relevant
+  variables. The cache is cleared when it reaches MAX_CACHED_H_VALUES
+  entries.
+*/
 class OperatorCountingHeuristic : public Heuristic {
+    static const int MAX_CACHED_H_VALUES = 100000;
+
     std::vector<std::shared_ptr<ConstraintGenerator>> constraint_generators;
     lp::LPSolver lp_solver;
+
+    // Empty if all variables are relevant.
+    std::vector<int> relevant_variables;
+    std::vector<int> relevant_values;
+    std::unordered_map<std::vector<int>, int> cached_h_values;
+
+    long long num_lp_solves;
+    long long num_cache_hits;
+    utils::Timer update_timer;
+    utils::Timer solve_timer;
+
+    int compute_lp_value(const State &state);
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
     int compute_heuristic(const State &state);
 public:
     explicit OperatorCountingHeuristic(const options::Options &opts);
     ~OperatorCountingHeuristic();
+
+    virtual void print_statistics() const override;
 };
 }
 
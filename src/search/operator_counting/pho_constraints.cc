@@ -49,6 +49,7 @@ void PhOConstraints::initialize_constraints(
             }
         }
     }
+    last_h_values.assign(pdbs->size(), -1);
 }
 
 bool PhOConstraints::update_constraints(const State &state,
@@ -60,11 +61,22 @@ bool PhOConstraints::update_constraints(const State &state,
         if (h == numeric_limits<int>::max()) {
             return true;
         }
-        lp_solver.set_constraint_lower_bound(constraint_id, h);
+        if (h != last_h_values[i]) {
+            lp_solver.set_constraint_lower_bound(constraint_id, h);
+            last_h_values[i] = h;
+        }
     }
     return false;
 }
 
+void PhOConstraints::mark_relevant_variables(vector<bool> &relevant) const {
+    for (const shared_ptr<pdbs::PatternDatabase> &pdb : *pdbs) {
+        for (int var : pdb->get_pattern()) {
+            relevant[var] = true;
+        }
+    }
+}
+
 static shared_ptr<ConstraintGenerator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Posthoc optimization constraints",
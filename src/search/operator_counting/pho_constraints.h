@@ -6,6 +6,7 @@
 #include "../pdbs/types.h"
 
 #include <memory>
+#include <vector>
 
 namespace options {
 class Options;
@@ -21,6 +22,8 @@ class PhOConstraints : public ConstraintGenerator {
 
     int constraint_offset;
     std::shared_ptr<pdbs::PDBCollection> pdbs;
+    // Lower bounds set in the previously evaluated state (-1 before).
+    std::vector<int> last_h_values;
 public:
     explicit PhOConstraints(const options::Options &opts);
     ~PhOConstraints() = default;
@@ -31,6 +34,8 @@ public:
         double infinity) override;
     virtual bool update_constraints(
         const State &state, lp::LPSolver &lp_solver) override;
+    virtual void mark_relevant_variables(
+        std::vector<bool> &relevant) const override;
 };
 }
 
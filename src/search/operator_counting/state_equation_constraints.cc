@@ -84,36 +84,63 @@ void StateEquationConstraints::initialize_constraints(
     for (FactProxy goal : task_proxy.get_goals()) {
         goal_state[goal.get_variable().get_id()] = goal.get_value();
     }
+    last_state_values.assign(variables.size(), -1);
+}
+
+void StateEquationConstraints::set_lower_bound(
+    lp::LPSolver &lp_solver, int var, int value, int state_value) const {
+    const Proposition &prop = propositions[var][value];
+    if (prop.constraint_index >= 0) {
+        double lower_bound = 0;
+        /* If we consider the current value of var, there must be an
+           additional consumer. */
+        if (state_value == value) {
+            --lower_bound;
+        }
+        /* If we consider the goal value of var, there must be an
+           additional producer. */
+        if (goal_state[var] == value) {
+            ++lower_bound;
+        }
+        lp_solver.set_constraint_lower_bound(prop.constraint_index, lower_bound);
+    }
 }
 
 bool StateEquationConstraints::update_constraints(const State &state,
                                                   lp::LPSolver &lp_solver) {
     // Compute the bounds for the rows in the LP.
     for (size_t var = 0; var < propositions.size(); ++var) {
-        int num_values = propositions[var].size();
-        for (int value = 0; value < num_values; ++value) {
-            const Proposition &prop = propositions[var][value];
-            // Set row bounds.
-            if (prop.constraint_index >= 0) {
-                double lower_bound = 0;
-                /* If we consider the current value of var, there must be an
-                   additional consumer. */
-                if (state[var].get_value() == value) {
-                    --lower_bound;
-                }
-                /* If we consider the goal value of var, there must be an
-                   additional producer. */
-                if (goal_state[var] == value) {
-                    ++lower_bound;
-                }
-                lp_solver.set_constraint_lower_bound(
-                    prop.constraint_index, lower_bound);
+        int state_value = state[var].get_value();
+        int last_value = last_state_values[var];
+        if (state_value == last_value)
+            continue;
+        if (last_value == -1) {
+            int num_values = propositions[var].size();
+            for (int value = 0; value < num_values; ++value) {
+                set_lower_bound(lp_solver, var, value, state_value);
             }
+        } else {
+            // Only the bounds of the old and the new value change.
+            set_lower_bound(lp_solver, var, last_value, state_value);
+            set_lower_bound(lp_solver, var, state_value, state_value);
         }
+        last_state_values[var] = state_value;
     }
     return false;
 }
 
+void StateEquationConstraints::mark_relevant_variables(
+    vector<bool> &relevant) const {
+    for (size_t var = 0; var < propositions.size(); ++var) {
+        for (const Proposition &prop : propositions[var]) {
+            if (prop.constraint_index >= 0) {
+                relevant[var] = true;
+                break;
+            }
+        }
+    }
+}
+
 static shared_ptr<ConstraintGenerator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "State equation constraints",
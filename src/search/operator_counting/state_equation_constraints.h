@@ -29,14 +29,22 @@ class StateEquationConstraints : public ConstraintGenerator {
     std::vector<std::vector<Proposition>> propositions;
     // Map goal variables to their goal value and other variables to max int.
     std::vector<int> goal_state;
+    /*
+      Values of the previously evaluated state (-1 before the first
+      state). Only rows of variables whose value changed are updated.
+    */
+    std::vector<int> last_state_values;
 
     void build_propositions(const TaskProxy &task_proxy);
     void add_constraints(std::vector<lp::LPConstraint> &constraints, double infinity);
+    void set_lower_bound(lp::LPSolver &lp_solver, int var, int value,
+                         int state_value) const;
 public:
     virtual void initialize_constraints(const std::shared_ptr<AbstractTask> task,
                                         std::vector<lp::LPConstraint> &constraints,
                                         double infinity);
     virtual bool update_constraints(const State &state, lp::LPSolver &lp_solver);
+    virtual void mark_relevant_variables(std::vector<bool> &relevant) const override;
 };
 }
 
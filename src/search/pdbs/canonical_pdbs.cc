@@ -3,40 +3,76 @@
 #include "dominance_pruning.h"
 #include "pattern_database.h"
 
+#include "../task_proxy.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <unordered_map>
 
 using namespace std;
 
 namespace pdbs {
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pattern_databases,
-    const shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets_,
-    bool dominance_pruning)
-    : max_additive_subsets(max_additive_subsets_) {
+    const shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets,
+    bool dominance_pruning) {
     assert(max_additive_subsets);
     if (dominance_pruning) {
-        max_additive_subsets = prune_dominated_subsets(
-            *pattern_databases, *max_additive_subsets);
+        compile(*prune_dominated_subsets(
+                    *pattern_databases, *max_additive_subsets));
+    } else {
+        compile(*max_additive_subsets);
     }
 }
 
-int CanonicalPDBs::get_value(const State &state) const {
+void CanonicalPDBs::compile(const MaxAdditivePDBSubsets &max_additive_subsets) {
     // If we have an empty collection, then max_additive_subsets = { \emptyset }.
-    assert(!max_additive_subsets->empty());
-    int max_h = 0;
-    for (const auto &subset : *max_additive_subsets) {
-        int subset_h = 0;
+    assert(!max_additive_subsets.empty());
+    unordered_map<const PatternDatabase *, int> pdb_ids;
+    pattern_offsets.push_back(0);
+    subset_offsets.push_back(0);
+    for (const PDBCollection &subset : max_additive_subsets) {
         for (const shared_ptr<PatternDatabase> &pdb : subset) {
-            /* Experiments showed that it is faster to recompute the
-               h values than to cache them in an unordered_map. */
-            int h = pdb->get_value(state);
-            if (h == numeric_limits<int>::max())
-                return numeric_limits<int>::max();
-            subset_h += h;
+            auto result = pdb_ids.insert(make_pair(pdb.get(), pdbs.size()));
+            if (result.second) {
+                pdbs.push_back(pdb);
+                distances.push_back(pdb->get_distances());
+                const Pattern &pattern = pdb->get_pattern();
+                const vector<size_t> &multipliers = pdb->get_hash_multipliers();
+                pattern_variables.insert(
+                    pattern_variables.end(), pattern.begin(), pattern.end());
+                hash_multipliers.insert(
+                    hash_multipliers.end(), multipliers.begin(), multipliers.end());
+                pattern_offsets.push_back(pattern_variables.size());
+            }
+            subset_pdb_ids.push_back(result.first->second);
         }
+        subset_offsets.push_back(subset_pdb_ids.size());
+    }
+    pdb_values.resize(pdbs.size());
+}
+
+int CanonicalPDBs::get_value(const State &state) const {
+    const vector<int> &values = state.get_values();
+    int num_pdbs = pdbs.size();
+    for (int pdb_id = 0; pdb_id < num_pdbs; ++pdb_id) {
+        size_t index = 0;
+        for (int i = pattern_offsets[pdb_id]; i < pattern_offsets[pdb_id + 1]; ++i)
+            index += hash_multipliers[i] * values[pattern_variables[i]];
+        int h = distances[pdb_id][index];
+        if (h == numeric_limits<int>::max())
+            return numeric_limits<int>::max();
+        pdb_values[pdb_id] = h;
+    }
+
+    int max_h = 0;
+    int num_subsets = subset_offsets.size() - 1;
+    for (int subset_id = 0; subset_id < num_subsets; ++subset_id) {
+        int subset_h = 0;
+        for (int i = subset_offsets[subset_id]; i < subset_offsets[subset_id + 1]; ++i)
+            subset_h += pdb_values[subset_pdb_ids[i]];
         max_h = max(max_h, subset_h);
     }
     return max_h;
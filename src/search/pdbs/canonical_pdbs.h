@@ -1,16 +1,50 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "packed_distances.h"
 #include "types.h"
 
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 class State;
 
 namespace pdbs {
+/*
+  Evaluates the canonical heuristic for a collection of PDBs and its
+  maximal additive subsets.
+
+  The subsets (after dominance pruning) are compiled into a flat
+  evaluation plan when the object is created. Evaluating a state then
+  takes three passes over contiguous arrays: compute the index of the
+  state in each PDB, look up the distances, and take the maximum over
+  the sums of the subsets, which are stored as lists of PDB ids. Every
+  PDB is queried exactly once per state, and PDBs that occur in no
+  subset are not queried at all.
+
+  get_value uses internal scratch memory, so a CanonicalPDBs object
+  must not be evaluated by several threads at once.
+*/
 class CanonicalPDBs {
-    std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
+    // PDBs occurring in at least one subset.
+    PDBCollection pdbs;
+    std::vector<PackedDistances> distances;
+
+    /* The pattern of PDB i and its hash multipliers are at positions
+       pattern_offsets[i], ..., pattern_offsets[i + 1] - 1. */
+    std::vector<int> pattern_offsets;
+    std::vector<int> pattern_variables;
+    std::vector<std::size_t> hash_multipliers;
+
+    /* The PDB ids of subset i are at positions
+       subset_offsets[i], ..., subset_offsets[i + 1] - 1. */
+    std::vector<int> subset_offsets;
+    std::vector<int> subset_pdb_ids;
+
+    mutable std::vector<int> pdb_values;
 
+    void compile(const MaxAdditivePDBSubsets &max_additive_subsets);
 public:
     CanonicalPDBs(const std::shared_ptr<PDBCollection> &pattern_databases,
                   const std::shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets,
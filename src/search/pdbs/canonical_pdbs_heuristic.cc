@@ -1,6 +1,8 @@
 #include "canonical_pdbs_heuristic.h"
 
 #include "pattern_generator.h"
+#include "pdb_cache.h"
+#include "pdb_construction.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
@@ -21,6 +23,8 @@ CanonicalPDBs get_canonical_pdbs_from_options(
     utils::Timer timer;
     PatternCollectionInformation pattern_collection_info =
         pattern_generator->generate(task);
+    pattern_collection_info.set_construction_settings(
+        get_pdb_construction_settings_from_options(opts));
     shared_ptr<PDBCollection> pdbs = pattern_collection_info.get_pdbs();
     shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets =
         pattern_collection_info.get_max_additive_subsets();
@@ -49,6 +53,10 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &state) const {
     }
 }
 
+void CanonicalPDBsHeuristic::print_statistics() const {
+    print_pdb_cache_statistics();
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Canonical PDB",
@@ -76,6 +84,7 @@ static Heuristic *_parse(OptionParser &parser) {
         "the heuristic value because there are dominating patterns in the "
         "collection.",
         "true");
+    add_pdb_construction_options_to_parser(parser);
 
     Heuristic::add_options_to_parser(parser);
 
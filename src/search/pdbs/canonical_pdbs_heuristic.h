@@ -21,6 +21,8 @@ protected:
 public:
     explicit CanonicalPDBsHeuristic(const options::Options &opts);
     virtual ~CanonicalPDBsHeuristic() = default;
+
+    virtual void print_statistics() const override;
 };
 }
 
@@ -1,8 +1,9 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
+#include "pdb_construction.h"
 
+#include "../utils/memory.h"
 #include "../utils/timer.h"
 
 #include <iostream>
@@ -12,47 +13,51 @@ using namespace std;
 
 namespace pdbs {
 IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
-    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns)
+    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns,
+    const PDBConstructionSettings &settings)
     : task_proxy(task_proxy),
+      construction_settings(settings),
       patterns(make_shared<PatternCollection>(intitial_patterns.begin(),
                                               intitial_patterns.end())),
       pattern_databases(make_shared<PDBCollection>()),
       max_additive_subsets(nullptr),
       size(0) {
     utils::Timer timer;
-    pattern_databases->reserve(patterns->size());
-    for (const Pattern &pattern : *patterns)
-        add_pdb_for_pattern(pattern);
+    *pattern_databases = build_pdbs(
+        task_proxy, *patterns, construction_settings);
+    for (const shared_ptr<PatternDatabase> &pdb : *pattern_databases)
+        size += pdb->get_size();
     are_additive = compute_additive_vars(task_proxy);
     recompute_max_additive_subsets();
     cout << "PDB collection construction time: " << timer << endl;
 }
 
-void IncrementalCanonicalPDBs::add_pdb_for_pattern(const Pattern &pattern) {
-    pattern_databases->push_back(make_shared<PatternDatabase>(task_proxy, pattern));
-    size += pattern_databases->back()->get_size();
+void IncrementalCanonicalPDBs::add_pattern(const Pattern &pattern) {
+    add_pdb(build_pdbs(task_proxy, {pattern}, construction_settings).front());
 }
 
-void IncrementalCanonicalPDBs::add_pattern(const Pattern &pattern) {
-    patterns->push_back(pattern);
-    add_pdb_for_pattern(pattern);
+void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
+    patterns->push_back(pdb->get_pattern());
+    pattern_databases->push_back(pdb);
+    size += pdb->get_size();
     recompute_max_additive_subsets();
 }
 
 void IncrementalCanonicalPDBs::recompute_max_additive_subsets() {
     max_additive_subsets = compute_max_additive_subsets(*pattern_databases,
                                                         are_additive);
+    canonical_pdbs = utils::make_unique_ptr<CanonicalPDBs>(
+        pattern_databases, max_additive_subsets, false);
 }
 
 MaxAdditivePDBSubsets IncrementalCanonicalPDBs::get_max_additive_subsets(
-    const Pattern &new_pattern) {
+    const Pattern &new_pattern) const {
     return pdbs::compute_max_additive_subsets_with_pattern(
         *max_additive_subsets, new_pattern, are_additive);
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(pattern_databases, max_additive_subsets, false);
-    return canonical_pdbs.get_value(state);
+    return canonical_pdbs->get_value(state);
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
@@ -1,8 +1,10 @@
 #ifndef PDBS_INCREMENTAL_CANONICAL_PDBS_H
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
+#include "canonical_pdbs.h"
 #include "max_additive_pdb_sets.h"
 #include "pattern_collection_information.h"
+#include "pdb_construction.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -12,10 +14,13 @@
 namespace pdbs {
 class IncrementalCanonicalPDBs {
     TaskProxy task_proxy;
+    PDBConstructionSettings construction_settings;
 
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
+    // Evaluates the current collection; rebuilt with max_additive_subsets.
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
@@ -23,21 +28,24 @@ class IncrementalCanonicalPDBs {
     // The sum of all abstract state sizes of all pdbs in the collection.
     int size;
 
-    // Adds a PDB for pattern but does not recompute max_additive_subsets.
-    void add_pdb_for_pattern(const Pattern &pattern);
-
     void recompute_max_additive_subsets();
 public:
     IncrementalCanonicalPDBs(const TaskProxy &task_proxy,
-                             const PatternCollection &intitial_patterns);
+                             const PatternCollection &intitial_patterns,
+                             const PDBConstructionSettings &settings =
+                                 PDBConstructionSettings());
     virtual ~IncrementalCanonicalPDBs() = default;
 
     // Adds a new pattern to the collection and recomputes max_additive_subsets.
     void add_pattern(const Pattern &pattern);
 
+    // Like add_pattern, but reuses an already built PDB for the pattern.
+    void add_pdb(const std::shared_ptr<PatternDatabase> &pdb);
+
     /* Returns a set of subsets that would be additive to the new pattern.
        Detailed documentation in max_additive_pdb_sets.h */
-    MaxAdditivePDBSubsets get_max_additive_subsets(const Pattern &new_pattern);
+    MaxAdditivePDBSubsets get_max_additive_subsets(
+        const Pattern &new_pattern) const;
 
     int get_value(const State &state) const;
 
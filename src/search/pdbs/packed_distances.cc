@@ -0,0 +1,79 @@
+#include "packed_distances.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace pdbs {
+static const int LOG_BITS_PER_WORD = 6;
+
+static int compute_log_bits(const vector<int> &distances) {
+    // We need one value more than the largest finite distance for dead ends.
+    uint64_t max_value = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max())
+            max_value = max(max_value, static_cast<uint64_t>(distance));
+    }
+    ++max_value;
+    int log_bits = 0;
+    while (max_value >> (1 << log_bits))
+        ++log_bits;
+    assert(log_bits <= 5);
+    return log_bits;
+}
+
+PackedDistances::PackedDistances()
+    : words(nullptr),
+      num_entries(0) {
+    set_log_bits(0);
+}
+
+PackedDistances::PackedDistances(const vector<int> &distances)
+    : words(nullptr),
+      num_entries(distances.size()) {
+    set_log_bits(compute_log_bits(distances));
+    shared_ptr<vector<uint64_t>> owned_words =
+        make_shared<vector<uint64_t>>(get_num_words(), 0);
+    for (size_t index = 0; index < num_entries; ++index) {
+        int distance = distances[index];
+        uint64_t value = distance == numeric_limits<int>::max() ?
+            value_mask : static_cast<uint64_t>(distance);
+        assert(value <= value_mask);
+        int shift = static_cast<int>(index & entry_mask) << log_bits;
+        (*owned_words)[index >> log_entries] |= value << shift;
+    }
+    words = owned_words->data();
+    storage = owned_words;
+}
+
+PackedDistances::PackedDistances(
+    const shared_ptr<const void> &storage, const uint64_t *words,
+    size_t num_entries, int bits_per_entry)
+    : storage(storage),
+      words(words),
+      num_entries(num_entries) {
+    assert(is_valid_bits_per_entry(bits_per_entry));
+    int log_bits = 0;
+    while ((1 << log_bits) < bits_per_entry)
+        ++log_bits;
+    set_log_bits(log_bits);
+}
+
+void PackedDistances::set_log_bits(int log_bits_) {
+    log_bits = log_bits_;
+    log_entries = LOG_BITS_PER_WORD - log_bits;
+    entry_mask = (uint64_t(1) << log_entries) - 1;
+    value_mask = (uint64_t(1) << (1 << log_bits)) - 1;
+}
+
+size_t PackedDistances::get_num_words(
+    size_t num_entries, int bits_per_entry) {
+    size_t entries_per_word = (1 << LOG_BITS_PER_WORD) / bits_per_entry;
+    return (num_entries + entries_per_word - 1) / entries_per_word;
+}
+
+bool PackedDistances::is_valid_bits_per_entry(int bits_per_entry) {
+    return bits_per_entry >= 1 && bits_per_entry <= 32 &&
+           (bits_per_entry & (bits_per_entry - 1)) == 0;
+}
+}
@@ -0,0 +1,88 @@
+#ifndef PDBS_PACKED_DISTANCES_H
+#define PDBS_PACKED_DISTANCES_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace pdbs {
+/*
+  Read-only table of the distances of a pattern database, stored with
+  the smallest number of bits per entry that can represent all finite
+  distances plus one extra value for dead ends. The number of bits is
+  a power of two (1, 2, ..., 32), so entries never straddle words and
+  lookups only need shifts and masks.
+
+  For example, a PDB with distances up to 14 uses 4 bits per entry and
+  thus needs an eighth of the memory of a vector<int>.
+
+  The words are either owned by the table or live in memory owned by
+  someone else, e.g., a memory-mapped file of the PDB cache. In both
+  cases, the table keeps the storage alive, so tables can be copied
+  cheaply.
+*/
+class PackedDistances {
+    std::shared_ptr<const void> storage;
+    const std::uint64_t *words;
+    std::size_t num_entries;
+    // Every entry has 2^log_bits bits, every word holds 2^log_entries entries.
+    int log_bits;
+    int log_entries;
+    std::uint64_t entry_mask;
+    // All bits of an entry set. This value represents dead ends.
+    std::uint64_t value_mask;
+
+    void set_log_bits(int log_bits);
+public:
+    PackedDistances();
+    // Dead ends in distances are represented by numeric_limits<int>::max().
+    explicit PackedDistances(const std::vector<int> &distances);
+    /*
+      Use words packed by another table (see get_words) that are kept
+      alive by storage.
+    */
+    PackedDistances(const std::shared_ptr<const void> &storage,
+                    const std::uint64_t *words, std::size_t num_entries,
+                    int bits_per_entry);
+    ~PackedDistances() = default;
+
+    int operator[](std::size_t index) const {
+        assert(index < num_entries);
+        std::uint64_t word = words[index >> log_entries];
+        int shift = static_cast<int>(index & entry_mask) << log_bits;
+        std::uint64_t value = (word >> shift) & value_mask;
+        return value == value_mask ? std::numeric_limits<int>::max()
+               : static_cast<int>(value);
+    }
+
+    std::size_t size() const {
+        return num_entries;
+    }
+
+    int get_bits_per_entry() const {
+        return 1 << log_bits;
+    }
+
+    const std::uint64_t *get_words() const {
+        return words;
+    }
+
+    std::size_t get_num_words() const {
+        return get_num_words(num_entries, get_bits_per_entry());
+    }
+
+    // Return the number of bytes used for the table.
+    std::size_t get_memory_usage() const {
+        return get_num_words() * sizeof(std::uint64_t);
+    }
+
+    static std::size_t get_num_words(
+        std::size_t num_entries, int bits_per_entry);
+    static bool is_valid_bits_per_entry(int bits_per_entry);
+};
+}
+
+#endif
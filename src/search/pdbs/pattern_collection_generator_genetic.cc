@@ -1,7 +1,7 @@
 #include "pattern_collection_generator_genetic.h"
 
+#include "pattern_database.h"
 #include "validation.h"
-#include "zero_one_pdbs.h"
 
 #include "../causal_graph.h"
 #include "../globals.h"
@@ -29,7 +29,13 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_collections(opts.get<int>("num_collections")),
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
-      disjoint_patterns(opts.get<bool>("disjoint")) {
+      construction_settings(get_pdb_construction_settings_from_options(opts)),
+      disjoint_patterns(opts.get<bool>("disjoint")),
+      max_memo_bytes(static_cast<size_t>(opts.get<int>("max_memo_memory")) *
+                     1024 * 1024),
+      memo_bytes(0),
+      num_memo_hits(0),
+      num_memo_misses(0) {
 }
 
 void PatternCollectionGeneratorGenetic::select(
@@ -156,6 +162,114 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
     return false;
 }
 
+/*
+  Approximate memory used by a memo entry: the key data plus the list
+  node, the hash table node and its bucket.
+*/
+static size_t get_memo_entry_bytes(const vector<int> &key) {
+    return key.size() * sizeof(int) + sizeof(pair<vector<int>, double>) +
+           8 * sizeof(void *);
+}
+
+const double *PatternCollectionGeneratorGenetic::lookup_mean_finite_h(
+    const MemoKey &key) {
+    auto it = memo_index.find(key);
+    if (it == memo_index.end()) {
+        ++num_memo_misses;
+        return nullptr;
+    }
+    ++num_memo_hits;
+    // Move the entry to the front.
+    memo_entries.splice(memo_entries.begin(), memo_entries, it->second);
+    return &it->second->second;
+}
+
+void PatternCollectionGeneratorGenetic::store_mean_finite_h(
+    const MemoKey &key, double mean_finite_h) {
+    size_t entry_bytes = get_memo_entry_bytes(key);
+    if (entry_bytes > max_memo_bytes || memo_index.count(key))
+        return;
+    while (memo_bytes + entry_bytes > max_memo_bytes) {
+        const MemoKey &evicted_key = memo_entries.back().first;
+        memo_bytes -= get_memo_entry_bytes(evicted_key);
+        memo_index.erase(evicted_key);
+        memo_entries.pop_back();
+    }
+    memo_entries.emplace_front(key, mean_finite_h);
+    memo_index[key] = memo_entries.begin();
+    memo_bytes += entry_bytes;
+}
+
+double PatternCollectionGeneratorGenetic::compute_fitness(
+    const PatternCollection &patterns) {
+    TaskProxy task_proxy(*task);
+    const CausalGraph &cg = task_proxy.get_causal_graph();
+    int num_variables = task_proxy.get_variables().size();
+    OperatorsProxy operators = task_proxy.get_operators();
+
+    vector<double> mean_finite_h_values(patterns.size());
+    vector<MemoKey> keys(patterns.size());
+    vector<bool> in_earlier_pattern(num_variables, false);
+    vector<int> remaining_operator_costs;
+    remaining_operator_costs.reserve(operators.size());
+    for (OperatorProxy op : operators)
+        remaining_operator_costs.push_back(op.get_cost());
+
+    // Patterns that are not memoized, with their operator costs.
+    vector<int> missing;
+    PatternCollection missing_patterns;
+    vector<vector<int>> missing_operator_costs;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        const Pattern &pattern = patterns[i];
+        MemoKey &key = keys[i];
+        key = pattern;
+        key.push_back(-1);
+        vector<int> context;
+        for (int var : pattern) {
+            if (in_earlier_pattern[var])
+                context.push_back(var);
+            for (int neighbor : cg.get_eff_to_eff(var)) {
+                if (in_earlier_pattern[neighbor])
+                    context.push_back(neighbor);
+            }
+        }
+        sort(context.begin(), context.end());
+        context.erase(unique(context.begin(), context.end()), context.end());
+        key.insert(key.end(), context.begin(), context.end());
+
+        const double *mean_finite_h = lookup_mean_finite_h(key);
+        if (mean_finite_h) {
+            mean_finite_h_values[i] = *mean_finite_h;
+        } else {
+            missing.push_back(i);
+            missing_patterns.push_back(pattern);
+            missing_operator_costs.push_back(remaining_operator_costs);
+        }
+
+        // Same cost partitioning as in ZeroOnePDBs.
+        for (OperatorProxy op : operators) {
+            if (is_operator_relevant(pattern, op))
+                remaining_operator_costs[op.get_id()] = 0;
+        }
+        for (int var : pattern)
+            in_earlier_pattern[var] = true;
+    }
+
+    PDBCollection pdbs = build_pdbs(
+        task_proxy, missing_patterns, construction_settings,
+        missing_operator_costs);
+    for (size_t j = 0; j < missing.size(); ++j) {
+        int i = missing[j];
+        mean_finite_h_values[i] = pdbs[j]->compute_mean_finite_h();
+        store_mean_finite_h(keys[i], mean_finite_h_values[i]);
+    }
+
+    double fitness = 0;
+    for (double mean_finite_h : mean_finite_h_values)
+        fitness += mean_finite_h;
+    return fitness;
+}
+
 void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
     for (const auto &collection : pattern_collections) {
@@ -193,8 +307,7 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
         } else {
             /* Generate the pattern collection heuristic and get its fitness
                value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
+            fitness = compute_fitness(*pattern_collection);
             // Update the best heuristic found so far.
             if (fitness > best_fitness) {
                 best_fitness = fitness;
@@ -277,6 +390,10 @@ PatternCollectionInformation PatternCollectionGeneratorGenetic::generate(
     utils::Timer timer;
     genetic_algorithm(task);
     cout << "Pattern generation (Edelkamp) time: " << timer << endl;
+    cout << "Pattern generation (Edelkamp) memoized PDBs: "
+         << num_memo_hits << " hits, " << num_memo_misses << " misses, "
+         << memo_entries.size() << " entries (about " << memo_bytes
+         << " bytes)" << endl;
     assert(best_patterns);
     TaskProxy task_proxy(*task);
     return PatternCollectionInformation(task_proxy, best_patterns);
@@ -364,6 +481,16 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "consider a pattern collection invalid (giving it very low "
         "fitness) if its patterns are not disjoint",
         "false");
+    parser.add_option<int>(
+        "max_memo_memory",
+        "maximal memory in MiB for remembering PDB evaluations across "
+        "episodes. PDBs that were already evaluated in the context of an "
+        "earlier pattern collection are not built again. The memory of "
+        "the remembered evaluations is estimated from the size of their "
+        "keys. Set to 0 to disable.",
+        "64",
+        Bounds("0", "infinity"));
+    add_pdb_construction_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -2,9 +2,16 @@
 #define PDBS_PATTERN_COLLECTION_GENERATOR_GENETIC_H
 
 #include "pattern_generator.h"
+#include "pdb_construction.h"
 #include "types.h"
 
+#include "../utils/hash.h"
+
+#include <cstddef>
+#include <list>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class AbstractTask;
@@ -26,6 +33,7 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     const int num_collections;
     const int num_episodes;
     const double mutation_probability;
+    const PDBConstructionSettings construction_settings;
 
     std::shared_ptr<AbstractTask> task;
     /* Specifies whether patterns in each pattern collection need to be disjoint
@@ -38,6 +46,43 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
     std::shared_ptr<PatternCollection> best_patterns;
     double best_fitness;
 
+    /*
+      Mean finite h-values of PDBs built in earlier evaluations. With the
+      zero-one cost partitioning, the PDB of a pattern P depends on P and
+      on which of its relevant operators were already used by the patterns
+      before P. These are exactly the relevant operators that affect a
+      variable U of an earlier pattern, and such a U is either in P or
+      shares an operator effect with a variable of P. The key of an entry
+      is therefore P, followed by -1, followed by the variables of earlier
+      patterns that are in P or adjacent to P via eff->eff arcs.
+
+      Keys grow with the pattern sizes and the number of variables, so
+      the memo is limited by the approximate number of bytes of its
+      entries (see get_memo_entry_bytes) rather than by their number.
+      When the limit is reached, the least recently used entries are
+      evicted first. memo_entries is ordered from most to least recently
+      used.
+    */
+    using MemoKey = std::vector<int>;
+    using MemoEntries = std::list<std::pair<MemoKey, double>>;
+    const std::size_t max_memo_bytes;
+    std::size_t memo_bytes;
+    MemoEntries memo_entries;
+    std::unordered_map<MemoKey, MemoEntries::iterator> memo_index;
+    int num_memo_hits;
+    int num_memo_misses;
+
+    // Return the memoized value for key or nullptr.
+    const double *lookup_mean_finite_h(const MemoKey &key);
+    void store_mean_finite_h(const MemoKey &key, double mean_finite_h);
+
+    /*
+      Return the same value as ZeroOnePDBs::compute_approx_mean_finite_h
+      for the given patterns, but only build the PDBs whose mean finite
+      h-values are not memoized. Missing PDBs are built in parallel.
+    */
+    double compute_fitness(const PatternCollection &patterns);
+
     /*
       The fitness values (from evaluate) are used as probabilities. Then
       num_collections many pattern collections are chosen from the vector of all
@@ -71,8 +116,8 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
       only causally relevant variables remain in the patterns. Then the zero one
       partitioning pattern collection heuristic is constructed and its fitness
       ( = summed up mean h-values (dead ends are ignored) of all PDBs in the
-      collection) computed. The overall best heuristic is eventually updated and
-      saved for further episodes.
+      collection) computed (see compute_fitness). The overall best heuristic
+      is eventually updated and saved for further episodes.
     */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const Pattern &pattern) const;
@@ -3,6 +3,7 @@
 #include "canonical_pdbs_heuristic.h"
 #include "incremental_canonical_pdbs.h"
 #include "pattern_database.h"
+#include "pdb_construction.h"
 #include "validation.h"
 
 #include "../causal_graph.h"
@@ -16,26 +17,128 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <exception>
 #include <iostream>
 #include <limits>
+#include <unordered_map>
 
 using namespace std;
 
 namespace pdbs {
 struct HillClimbingTimeout : public exception {};
 
+// Markers for candidates without a count in find_best_improving_pdb.
+static const int NOT_EVALUATED = -1;
+static const int PRUNED = -2;
+
+/*
+  Heuristic values of the sample states under the current pattern
+  collection. They do not change while the candidates of one iteration
+  are evaluated, so we compute them once per iteration instead of once
+  for every candidate and sample.
+*/
+class SampleValues {
+    int num_pdbs;
+    unordered_map<const PatternDatabase *, int> pdb_ids;
+    // pdb_values[sample_id * num_pdbs + pdb_id]
+    vector<int> pdb_values;
+    vector<int> collection_values;
+public:
+    SampleValues(const IncrementalCanonicalPDBs &current_pdbs,
+                 const vector<State> &samples);
+
+    // Translate PDB subsets of the current collection to lists of PDB ids.
+    vector<vector<int>> get_pdb_ids(
+        const MaxAdditivePDBSubsets &max_additive_subsets) const;
+
+    /*
+      Return true iff the h-value of the new pattern (from pdb) plus the
+      h-value of one of the given maximal additive subsets of the current
+      collection is greater than the h-value of the current collection.
+    */
+    bool is_heuristic_improved(
+        const PatternDatabase &pdb, const State &sample, int sample_id,
+        const vector<vector<int>> &max_additive_subsets) const;
+};
+
+SampleValues::SampleValues(const IncrementalCanonicalPDBs &current_pdbs,
+                           const vector<State> &samples) {
+    const PDBCollection &pdbs = *current_pdbs.get_pattern_databases();
+    num_pdbs = pdbs.size();
+    for (int pdb_id = 0; pdb_id < num_pdbs; ++pdb_id)
+        pdb_ids[pdbs[pdb_id].get()] = pdb_id;
+    pdb_values.reserve(samples.size() * num_pdbs);
+    collection_values.reserve(samples.size());
+    for (const State &sample : samples) {
+        for (const shared_ptr<PatternDatabase> &pdb : pdbs)
+            pdb_values.push_back(pdb->get_value(sample));
+        collection_values.push_back(current_pdbs.get_value(sample));
+    }
+}
+
+vector<vector<int>> SampleValues::get_pdb_ids(
+    const MaxAdditivePDBSubsets &max_additive_subsets) const {
+    vector<vector<int>> result;
+    result.reserve(max_additive_subsets.size());
+    for (const PDBCollection &subset : max_additive_subsets) {
+        result.emplace_back();
+        result.back().reserve(subset.size());
+        for (const shared_ptr<PatternDatabase> &pdb : subset)
+            result.back().push_back(pdb_ids.at(pdb.get()));
+    }
+    return result;
+}
+
+bool SampleValues::is_heuristic_improved(
+    const PatternDatabase &pdb, const State &sample, int sample_id,
+    const vector<vector<int>> &max_additive_subsets) const {
+    // h_pattern: h-value of the new pattern
+    int h_pattern = pdb.get_value(sample);
+
+    if (h_pattern == numeric_limits<int>::max()) {
+        return true;
+    }
+
+    // h_collection: h-value of the current collection heuristic
+    int h_collection = collection_values[sample_id];
+    if (h_collection == numeric_limits<int>::max())
+        return false;
+
+    const int *sample_pdb_values = &pdb_values[sample_id * num_pdbs];
+    for (const vector<int> &subset : max_additive_subsets) {
+        int h_subset = 0;
+        for (int pdb_id : subset) {
+            int h = sample_pdb_values[pdb_id];
+            if (h == numeric_limits<int>::max())
+                return false;
+            h_subset += h;
+        }
+        if (h_pattern + h_subset > h_collection) {
+            /*
+              return true if a max additive subset is found for
+              which the condition is met
+            */
+            return true;
+        }
+    }
+    return false;
+}
+
 PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(const Options &opts)
     : pdb_max_size(opts.get<int>("pdb_max_size")),
       collection_max_size(opts.get<int>("collection_max_size")),
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
+      construction_settings(get_pdb_construction_settings_from_options(opts)),
       num_rejected(0),
+      num_pruned(0),
       hill_climbing_timer(0) {
 }
 
@@ -80,16 +183,22 @@ size_t PatternCollectionGeneratorHillclimbing::generate_pdbs_for_candidates(
       candidates before and thus already a PDB has been created an inserted into
       candidate_pdbs.
     */
-    size_t max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (const Pattern &new_candidate : new_candidates) {
-        if (generated_patterns.count(new_candidate) == 0) {
-            candidate_pdbs.push_back(
-                make_shared<PatternDatabase>(task_proxy, new_candidate));
-            max_pdb_size = max(max_pdb_size,
-                               candidate_pdbs.back()->get_size());
-            generated_patterns.insert(new_candidate);
+        if (generated_patterns.insert(new_candidate).second) {
+            new_patterns.push_back(new_candidate);
         }
     }
+    PDBCollection new_pdbs = build_pdbs(
+        task_proxy, new_patterns, construction_settings, vector<vector<int>>(),
+        hill_climbing_timer);
+    size_t max_pdb_size = 0;
+    for (const shared_ptr<PatternDatabase> &pdb : new_pdbs) {
+        if (!pdb)
+            throw HillClimbingTimeout();
+        candidate_pdbs.push_back(pdb);
+        max_pdb_size = max(max_pdb_size, pdb->get_size());
+    }
     return max_pdb_size;
 }
 
@@ -113,7 +222,7 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
 }
 
 pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
-    vector<State> &samples, PDBCollection &candidate_pdbs) {
+    const vector<State> &samples, PDBCollection &candidate_pdbs) {
     /*
       TODO: The original implementation by Haslum et al. uses A* to compute
       h values for the sample states only instead of generating all PDBs.
@@ -121,47 +230,83 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
       We require that a pattern must have an improvement of at least one in
       order to be taken into account.
     */
-    int improvement = 0;
-    int best_pdb_index = -1;
+    SampleValues sample_values(*current_pdbs, samples);
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
+    /*
+      If a candidate's size added to the current collection's size exceeds
+      the maximum collection size, then forget the pdb. Candidates that are
+      too large or have already been added to the canonical heuristic are
+      nullptr.
+    */
+    vector<int> candidates;
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
+        if (!pdb)
             continue;
-        }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
         int combined_size = current_pdbs->get_size() + pdb->get_size();
         if (combined_size > collection_max_size) {
             candidate_pdbs[i] = nullptr;
             continue;
         }
+        candidates.push_back(i);
+    }
+
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        MaxAdditivePDBSubsets max_additive_subsets =
-            current_pdbs->get_max_additive_subsets(pdb->get_pattern());
-        for (State &sample : samples) {
-            if (is_heuristic_improved(*pdb, sample, max_additive_subsets))
-                ++count;
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    const int num_candidates = candidates.size();
+    const int num_sample_states = samples.size();
+    vector<int> counts(num_candidates, NOT_EVALUATED);
+    atomic<int> best_count(0);
+    utils::run_in_parallel(
+        num_candidates, construction_settings.num_threads,
+        [&](int, int job_id) {
+            const PatternDatabase &pdb = *candidate_pdbs[candidates[job_id]];
+            vector<vector<int>> subsets = sample_values.get_pdb_ids(
+                current_pdbs->get_max_additive_subsets(pdb.get_pattern()));
+            int count = 0;
+            for (int sample_id = 0; sample_id < num_sample_states; ++sample_id) {
+                /*
+                  Only a candidate with a count of at least best_count can
+                  be chosen. Since best_count only grows, we can stop as
+                  soon as the remaining samples cannot close the gap.
+                */
+                int num_remaining_samples = num_sample_states - sample_id;
+                if (count + num_remaining_samples < best_count.load()) {
+                    count = PRUNED;
+                    break;
+                }
+                if (sample_values.is_heuristic_improved(
+                        pdb, samples[sample_id], sample_id, subsets))
+                    ++count;
+            }
+            int current_best = best_count.load();
+            while (count > current_best &&
+                   !best_count.compare_exchange_weak(current_best, count)) {
+            }
+            counts[job_id] = count;
+        },
+        [this]() {
+            return hill_climbing_timer->is_expired();
+        });
+
+    int improvement = 0;
+    int best_pdb_index = -1;
+    for (int job_id = 0; job_id < num_candidates; ++job_id) {
+        int count = counts[job_id];
+        if (count == NOT_EVALUATED)
+            throw HillClimbingTimeout();
+        if (count == PRUNED) {
+            ++num_pruned;
+            continue;
         }
+        int i = candidates[job_id];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -175,48 +320,17 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     return make_pair(improvement, best_pdb_index);
 }
 
-bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample,
-    const MaxAdditivePDBSubsets &max_additive_subsets) {
-    // h_pattern: h-value of the new pattern
-    int h_pattern = pdb.get_value(sample);
-
-    if (h_pattern == numeric_limits<int>::max()) {
-        return true;
-    }
-
-    // h_collection: h-value of the current collection heuristic
-    int h_collection = current_pdbs->get_value(sample);
-    if (h_collection == numeric_limits<int>::max())
-        return false;
-
-    for (const auto &subset : max_additive_subsets) {
-        int h_subset = 0;
-        for (const shared_ptr<PatternDatabase> &additive_pdb : subset) {
-            /* Experiments showed that it is faster to recompute the
-               h values than to cache them in an unordered_map. */
-            int h = additive_pdb->get_value(sample);
-            if (h == numeric_limits<int>::max())
-                return false;
-            h_subset += h;
-        }
-        if (h_pattern + h_subset > h_collection) {
-            /*
-              return true if a max additive subset is found for
-              which the condition is met
-            */
-            return true;
-        }
-    }
-    return false;
-}
-
 void PatternCollectionGeneratorHillclimbing::hill_climbing(
     const TaskProxy &task_proxy,
     const SuccessorGenerator &successor_generator,
     double average_operator_cost,
     PatternCollection &initial_candidate_patterns) {
-    hill_climbing_timer = new utils::CountdownTimer(max_time);
+    /*
+      Candidates are evaluated on several threads, so we limit the wall-clock
+      time. Otherwise, the limit would depend on the number of threads.
+    */
+    hill_climbing_timer = new utils::CountdownTimer(
+        max_time, utils::TimerType::WALL_CLOCK_TIME);
     // Candidate patterns generated so far (used to avoid duplicates).
     set<Pattern> generated_patterns;
     /* Set of new pattern candidates from the last call to
@@ -268,7 +382,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
             cout << "found a better pattern with improvement " << improvement
                  << endl;
             cout << "pattern: " << best_pattern << endl;
-            current_pdbs->add_pattern(best_pattern);
+            current_pdbs->add_pdb(best_pdb);
 
             /* Clear current new_candidates and get successors for next
                iteration. */
@@ -291,6 +405,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     cout << "iPDB: size = " << current_pdbs->get_size() << endl;
     cout << "iPDB: generated = " << generated_patterns.size() << endl;
     cout << "iPDB: rejected = " << num_rejected << endl;
+    cout << "iPDB: pruned evaluations = " << num_pruned << endl;
     cout << "iPDB: maximum pdb size = " << max_pdb_size << endl;
     cout << "iPDB: hill climbing time: " << *hill_climbing_timer << endl;
 
@@ -314,7 +429,7 @@ PatternCollectionInformation PatternCollectionGeneratorHillclimbing::generate(
         initial_pattern_collection.emplace_back(1, goal_var_id);
     }
     current_pdbs = utils::make_unique_ptr<IncrementalCanonicalPDBs>(
-        task_proxy, initial_pattern_collection);
+        task_proxy, initial_pattern_collection, construction_settings);
 
     State initial_state = task_proxy.get_initial_state();
     if (!current_pdbs->is_dead_end(initial_state)) {
@@ -370,11 +485,12 @@ void add_hillclimbing_options(OptionParser &parser) {
         Bounds("1", "infinity"));
     parser.add_option<double>(
         "max_time",
-        "maximum time in seconds for improving the initial pattern "
-        "collection via hill climbing. If set to 0, no hill climbing "
-        "is performed at all.",
+        "maximum wall-clock time in seconds for improving the initial "
+        "pattern collection via hill climbing. If set to 0, no hill "
+        "climbing is performed at all.",
         "infinity",
         Bounds("0.0", "infinity"));
+    add_pdb_construction_options_to_parser(parser);
 }
 
 void check_hillclimbing_options(
@@ -523,6 +639,11 @@ static Heuristic *_parse_ipdb(OptionParser &parser) {
         "patterns", pgh);
     heuristic_opts.set<bool>(
         "dominance_pruning", opts.get<bool>("dominance_pruning"));
+    heuristic_opts.set<int>(
+        "num_threads", opts.get<int>("num_threads"));
+    if (opts.contains("pdb_cache"))
+        heuristic_opts.set<string>(
+            "pdb_cache", opts.get<string>("pdb_cache"));
 
     // Note: in the long run, this should return a shared pointer.
     return new CanonicalPDBsHeuristic(heuristic_opts);
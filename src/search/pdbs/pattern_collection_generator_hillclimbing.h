@@ -2,6 +2,7 @@
 #define PDBS_PATTERN_COLLECTION_GENERATOR_HILLCLIMBING_H
 
 #include "pattern_generator.h"
+#include "pdb_construction.h"
 #include "types.h"
 
 #include "../successor_generator.h"
@@ -35,11 +36,13 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     // minimal improvement required for hill climbing to continue search
     const int min_improvement;
     const double max_time;
+    const PDBConstructionSettings construction_settings;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
 
     // for stats only
     int num_rejected;
+    int num_pruned;
     utils::CountdownTimer *hill_climbing_timer;
 
     /*
@@ -54,7 +57,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
 
     /*
       Generates the PatternDatabase for patterns in new_candidates if they have
-      not been generated already.
+      not been generated already. Throws HillClimbingTimeout if the time
+      limit is reached before all PDBs are built.
     */
     std::size_t generate_pdbs_for_candidates(
         const TaskProxy &task_proxy,
@@ -82,22 +86,18 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      The values of the samples under the current collection are computed
+      once per call. Candidates are evaluated on up to num_threads threads,
+      and the evaluation of a candidate stops as soon as it cannot reach the
+      best improvement found so far. Ties are broken in favour of the
+      candidate with the lowest index, so the result does not depend on the
+      number of threads.
     */
     std::pair<int, int> find_best_improving_pdb(
-        std::vector<State> &samples,
+        const std::vector<State> &samples,
         PDBCollection &candidate_pdbs);
 
-    /*
-      Returns true iff the h-value of the new pattern (from pdb) plus the
-      h-value of all maximal additive subsets from the current pattern
-      collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
-    */
-    bool is_heuristic_improved(
-        const PatternDatabase &pdb,
-        const State &sample,
-        const MaxAdditivePDBSubsets &max_additive_subsets);
-
     /*
       This is the core algorithm of this class. As soon as after an iteration,
       the improvement (according to the "counting approximation") is smaller
@@ -105,12 +105,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       uses a vector to store PDBs to avoid re-computation of the same PDBs
       later. This is quite a large time gain, but may use too much memory. Also
       a set is used to store all patterns in their "normal form" for duplicate
-      detection.
-      TODO: This method computes all PDBs already for candidate iteration, but
-      for each call of add_pattern for the current CanonicalPDBsHeuristic, only
-      the pattern is passed as an argument and in CanonicalPDBsHeuristic, the
-      PDB is *again* built. One could possibly avoid this by passing the PDB and
-      adapt CanonicalPDBsHeuristic accordingly.
+      detection. The PDB of the best candidate is moved to the current
+      collection, so no PDB is built twice.
     */
     void hill_climbing(
         const TaskProxy &task_proxy,
@@ -2,6 +2,7 @@
 
 #include "pattern_database.h"
 #include "max_additive_pdb_sets.h"
+#include "pdb_construction.h"
 #include "validation.h"
 
 #include <algorithm>
@@ -70,12 +71,8 @@ bool PatternCollectionInformation::information_is_valid() const {
 void PatternCollectionInformation::create_pdbs_if_missing() {
     assert(patterns);
     if (!pdbs) {
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                make_shared<PatternDatabase>(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = make_shared<PDBCollection>(
+            build_pdbs(task_proxy, *patterns, construction_settings));
     }
 }
 
@@ -88,6 +85,11 @@ void PatternCollectionInformation::create_max_additive_subsets_if_missing() {
     }
 }
 
+void PatternCollectionInformation::set_construction_settings(
+    const PDBConstructionSettings &settings) {
+    construction_settings = settings;
+}
+
 void PatternCollectionInformation::set_pdbs(const shared_ptr<PDBCollection> &pdbs_) {
     pdbs = pdbs_;
     assert(information_is_valid());
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_COLLECTION_INFORMATION_H
 #define PDBS_PATTERN_COLLECTION_INFORMATION_H
 
+#include "pdb_construction.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -22,6 +23,8 @@ class PatternCollectionInformation {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
+    // Used for creating missing PDBs.
+    PDBConstructionSettings construction_settings;
 
     void create_pdbs_if_missing();
     void create_max_additive_subsets_if_missing();
@@ -33,6 +36,7 @@ public:
         const std::shared_ptr<PatternCollection> &patterns);
     ~PatternCollectionInformation() = default;
 
+    void set_construction_settings(const PDBConstructionSettings &settings);
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
     void set_max_additive_subsets(
         const std::shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets);
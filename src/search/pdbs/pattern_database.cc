@@ -71,7 +71,8 @@ PatternDatabase::PatternDatabase(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     bool dump,
-    const vector<int> &operator_costs)
+    const vector<int> &operator_costs,
+    PDBConstructionScratch *scratch)
     : pattern(pattern) {
     verify_no_axioms(task_proxy);
     verify_no_conditional_effects(task_proxy);
@@ -80,6 +81,31 @@ PatternDatabase::PatternDatabase(
     assert(utils::is_sorted_unique(pattern));
 
     utils::Timer timer;
+    compute_hash_multipliers(task_proxy);
+    PDBConstructionScratch local_scratch;
+    PDBConstructionScratch &construction_scratch =
+        scratch ? *scratch : local_scratch;
+    create_pdb(task_proxy, operator_costs, construction_scratch);
+    /* The abstract operators are not needed anymore. Freeing them before
+       packing the distances reduces the peak memory usage. */
+    construction_scratch.operators.clear();
+    distances = PackedDistances(construction_scratch.distances);
+    if (dump)
+        cout << "PDB construction time: " << timer << endl;
+}
+
+PatternDatabase::PatternDatabase(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const PackedDistances &distances)
+    : pattern(pattern),
+      distances(distances) {
+    assert(utils::is_sorted_unique(pattern));
+    compute_hash_multipliers(task_proxy);
+    assert(distances.size() == num_states);
+}
+
+void PatternDatabase::compute_hash_multipliers(const TaskProxy &task_proxy) {
     hash_multipliers.reserve(pattern.size());
     num_states = 1;
     for (int pattern_var_id : pattern) {
@@ -94,9 +120,6 @@ PatternDatabase::PatternDatabase(
             utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
         }
     }
-    create_pdb(task_proxy, operator_costs);
-    if (dump)
-        cout << "PDB construction time: " << timer << endl;
 }
 
 void PatternDatabase::multiply_out(
@@ -189,15 +212,18 @@ void PatternDatabase::build_abstract_operators(
 }
 
 void PatternDatabase::create_pdb(
-    const TaskProxy &task_proxy, const vector<int> &operator_costs) {
+    const TaskProxy &task_proxy, const vector<int> &operator_costs,
+    PDBConstructionScratch &scratch) {
     VariablesProxy variables = task_proxy.get_variables();
-    vector<int> variable_to_index(variables.size(), -1);
+    vector<int> &variable_to_index = scratch.variable_to_index;
+    variable_to_index.resize(variables.size(), -1);
     for (size_t i = 0; i < pattern.size(); ++i) {
         variable_to_index[pattern[i]] = i;
     }
 
     // compute all abstract operators
-    vector<AbstractOperator> operators;
+    vector<AbstractOperator> &operators = scratch.operators;
+    operators.clear();
     for (OperatorProxy op : task_proxy.get_operators()) {
         int op_cost;
         if (operator_costs.empty()) {
@@ -224,8 +250,13 @@ void PatternDatabase::create_pdb(
             abstract_goals.emplace_back(variable_to_index[var_id], val);
         }
     }
+    for (int var_id : pattern) {
+        variable_to_index[var_id] = -1;
+    }
 
-    distances.reserve(num_states);
+    vector<int> &unpacked_distances = scratch.distances;
+    unpacked_distances.clear();
+    unpacked_distances.reserve(num_states);
     // first implicit entry: priority, second entry: index for an abstract state
     AdaptiveQueue<size_t> pq;
 
@@ -233,29 +264,32 @@ void PatternDatabase::create_pdb(
     for (size_t state_index = 0; state_index < num_states; ++state_index) {
         if (is_goal_state(state_index, abstract_goals, variables)) {
             pq.push(0, state_index);
-            distances.push_back(0);
+            unpacked_distances.push_back(0);
         } else {
-            distances.push_back(numeric_limits<int>::max());
+            unpacked_distances.push_back(numeric_limits<int>::max());
         }
     }
 
     // Dijkstra loop
+    vector<const AbstractOperator *> &applicable_operators =
+        scratch.applicable_operators;
     while (!pq.empty()) {
         pair<int, size_t> node = pq.pop();
         int distance = node.first;
         size_t state_index = node.second;
-        if (distance > distances[state_index]) {
+        if (distance > unpacked_distances[state_index]) {
             continue;
         }
 
         // regress abstract_state
-        vector<const AbstractOperator *> applicable_operators;
+        applicable_operators.clear();
         match_tree.get_applicable_operators(state_index, applicable_operators);
         for (const AbstractOperator *op : applicable_operators) {
             size_t predecessor = state_index + op->get_hash_effect();
-            int alternative_cost = distances[state_index] + op->get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
+            int alternative_cost =
+                unpacked_distances[state_index] + op->get_cost();
+            if (alternative_cost < unpacked_distances[predecessor]) {
+                unpacked_distances[predecessor] = alternative_cost;
                 pq.push(alternative_cost, predecessor);
             }
         }
@@ -280,9 +314,10 @@ bool PatternDatabase::is_goal_state(
 }
 
 size_t PatternDatabase::hash_index(const State &state) const {
+    const vector<int> &values = state.get_values();
     size_t index = 0;
     for (size_t i = 0; i < pattern.size(); ++i) {
-        index += hash_multipliers[i] * state[pattern[i]].get_value();
+        index += hash_multipliers[i] * values[pattern[i]];
     }
     return index;
 }
@@ -295,8 +330,9 @@ double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
     for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+        int distance = distances[i];
+        if (distance != numeric_limits<int>::max()) {
+            sum += distance;
             ++size;
         }
     }
@@ -308,6 +344,10 @@ double PatternDatabase::compute_mean_finite_h() const {
 }
 
 bool PatternDatabase::is_operator_relevant(const OperatorProxy &op) const {
+    return pdbs::is_operator_relevant(pattern, op);
+}
+
+bool is_operator_relevant(const Pattern &pattern, const OperatorProxy &op) {
     for (EffectProxy effect : op.get_effects()) {
         int var_id = effect.get_fact().get_variable().get_id();
         if (binary_search(pattern.begin(), pattern.end(), var_id)) {
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "packed_distances.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -69,6 +70,21 @@ public:
               const VariablesProxy &variables) const;
 };
 
+/*
+  Memory that PDB construction reuses from one pattern database to the
+  next. Building many PDBs with the same scratch object avoids
+  reallocating these vectors for every PDB. A scratch object must not
+  be used by two constructions at the same time.
+*/
+struct PDBConstructionScratch {
+    // Maps variables to their index in the pattern or -1. Reset after use.
+    std::vector<int> variable_to_index;
+    std::vector<AbstractOperator> operators;
+    std::vector<const AbstractOperator *> applicable_operators;
+    // Distances computed by the regression search before packing them.
+    std::vector<int> distances;
+};
+
 // Implements a single pattern database
 class PatternDatabase {
     Pattern pattern;
@@ -80,11 +96,14 @@ class PatternDatabase {
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    PackedDistances distances;
 
     // multipliers for each variable for perfect hash function
     std::vector<std::size_t> hash_multipliers;
 
+    // Computes hash_multipliers and num_states.
+    void compute_hash_multipliers(const TaskProxy &task_proxy);
+
     /*
       Recursive method; called by build_abstract_operators. In the case
       of a precondition with value = -1 in the concrete operator, all
@@ -116,13 +135,14 @@ class PatternDatabase {
     /*
       Computes all abstract operators, builds the match tree (successor
       generator) and then does a Dijkstra regression search to compute
-      all final h-values (stored in distances). operator_costs can
+      all final h-values (stored in scratch.distances). operator_costs can
       specify individual operator costs for each operator for action
       cost partitioning. If left empty, default operator costs are used.
     */
     void create_pdb(
         const TaskProxy &task_proxy,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs,
+        PDBConstructionScratch &scratch);
 
     /*
       For a given abstract state (given as index), the according values
@@ -151,12 +171,24 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       scratch:        Memory to reuse during construction. If null,
+       temporary memory is allocated.
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
         const Pattern &pattern,
         bool dump = false,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs = std::vector<int>(),
+        PDBConstructionScratch *scratch = nullptr);
+    /*
+      Create a pattern database from precomputed distances, e.g., from
+      the PDB cache. The distances must have been computed for the
+      given pattern.
+    */
+    PatternDatabase(
+        const TaskProxy &task_proxy,
+        const Pattern &pattern,
+        const PackedDistances &distances);
     ~PatternDatabase() = default;
 
     int get_value(const State &state) const;
@@ -171,6 +203,16 @@ public:
         return num_states;
     }
 
+    const PackedDistances &get_distances() const {
+        return distances;
+    }
+
+    /* The index of a state is the sum of the products of its values on
+       the pattern variables and these multipliers. */
+    const std::vector<std::size_t> &get_hash_multipliers() const {
+        return hash_multipliers;
+    }
+
     /*
       Returns the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
@@ -184,6 +226,10 @@ public:
     // Returns true iff op has an effect on a variable in the pattern.
     bool is_operator_relevant(const OperatorProxy &op) const;
 };
+
+// Returns true iff op has an effect on a variable in the (sorted) pattern.
+extern bool is_operator_relevant(
+    const Pattern &pattern, const OperatorProxy &op);
 }
 
 #endif
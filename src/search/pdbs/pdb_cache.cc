@@ -0,0 +1,225 @@
+#include "pdb_cache.h"
+
+#include "pattern_database.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/mapped_file.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+using namespace std;
+
+namespace pdbs {
+// Change the version whenever the file format or the key changes.
+static const uint64_t FILE_MAGIC = 0x3230304244504446ULL; // "FDPDB002"
+
+/*
+  A file consists of the header, the key_size words of the key and the
+  words of the packed distances.
+*/
+struct FileHeader {
+    uint64_t magic;
+    uint64_t key_hash;
+    uint64_t key_size;
+    uint64_t num_entries;
+    uint64_t bits_per_entry;
+};
+
+// Separates lists of facts in the key. Fact values are never this large.
+static const uint64_t SEPARATOR = numeric_limits<uint64_t>::max();
+
+static atomic<long long> num_hits(0);
+static atomic<long long> num_misses(0);
+static atomic<long long> num_stores(0);
+static atomic<int> num_temporary_files(0);
+static atomic<bool> reported_write_error(false);
+
+static uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+class KeyBuilder {
+    PDBCacheKey key;
+public:
+    KeyBuilder() {
+        key.hash = FILE_MAGIC;
+    }
+
+    void add(uint64_t value) {
+        key.words.push_back(value);
+        key.hash = mix(key.hash ^ mix(value + 0x9e3779b97f4a7c15ULL));
+    }
+
+    PDBCacheKey get_key() {
+        return move(key);
+    }
+};
+
+PDBCacheKey compute_pdb_cache_key(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<int> variable_to_index(variables.size(), -1);
+    KeyBuilder builder;
+    builder.add(pattern.size());
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        variable_to_index[pattern[i]] = i;
+        builder.add(variables[pattern[i]].get_domain_size());
+    }
+
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        // Operators without effects on the pattern induce no abstract operators.
+        if (!is_operator_relevant(pattern, op))
+            continue;
+        int cost = operator_costs.empty() ?
+            op.get_cost() : operator_costs[op.get_id()];
+        builder.add(cost);
+        for (FactProxy pre : op.get_preconditions()) {
+            int index = variable_to_index[pre.get_variable().get_id()];
+            if (index != -1) {
+                builder.add(index);
+                builder.add(pre.get_value());
+            }
+        }
+        builder.add(SEPARATOR);
+        for (EffectProxy effect : op.get_effects()) {
+            FactProxy fact = effect.get_fact();
+            int index = variable_to_index[fact.get_variable().get_id()];
+            if (index != -1) {
+                builder.add(index);
+                builder.add(fact.get_value());
+            }
+        }
+        builder.add(SEPARATOR);
+    }
+    builder.add(SEPARATOR);
+
+    for (FactProxy goal : task_proxy.get_goals()) {
+        int index = variable_to_index[goal.get_variable().get_id()];
+        if (index != -1) {
+            builder.add(index);
+            builder.add(goal.get_value());
+        }
+    }
+    return builder.get_key();
+}
+
+PDBCache::PDBCache(const string &directory)
+    : directory(directory) {
+}
+
+string PDBCache::get_path(const PDBCacheKey &key) const {
+    ostringstream path;
+    path << directory << "/" << hex << setw(16) << setfill('0') << key.hash
+         << ".pdb";
+    return path.str();
+}
+
+shared_ptr<PatternDatabase> PDBCache::load(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const PDBCacheKey &key) const {
+    shared_ptr<utils::MappedFile> file = utils::MappedFile::open(get_path(key));
+    if (!file || file->get_size() < sizeof(FileHeader)) {
+        ++num_misses;
+        return nullptr;
+    }
+    const FileHeader *header =
+        reinterpret_cast<const FileHeader *>(file->get_data());
+    const uint64_t *key_words = reinterpret_cast<const uint64_t *>(
+        file->get_data() + sizeof(FileHeader));
+    size_t key_bytes = key.words.size() * sizeof(uint64_t);
+    /*
+      Different keys can have the same hash, so we compare the complete
+      key before using the distances.
+    */
+    if (header->magic != FILE_MAGIC ||
+        header->key_hash != key.hash ||
+        header->key_size != key.words.size() ||
+        file->get_size() < sizeof(FileHeader) + key_bytes ||
+        !equal(key.words.begin(), key.words.end(), key_words)) {
+        ++num_misses;
+        return nullptr;
+    }
+
+    VariablesProxy variables = task_proxy.get_variables();
+    uint64_t num_states = 1;
+    for (int var_id : pattern)
+        num_states *= variables[var_id].get_domain_size();
+
+    int bits_per_entry = header->bits_per_entry;
+    if (header->num_entries != num_states ||
+        header->bits_per_entry > 32 ||
+        !PackedDistances::is_valid_bits_per_entry(bits_per_entry) ||
+        file->get_size() != sizeof(FileHeader) + key_bytes + sizeof(uint64_t) *
+        PackedDistances::get_num_words(num_states, bits_per_entry)) {
+        ++num_misses;
+        return nullptr;
+    }
+    const uint64_t *words = key_words + key.words.size();
+    ++num_hits;
+    return make_shared<PatternDatabase>(
+        task_proxy, pattern,
+        PackedDistances(file, words, num_states, bits_per_entry));
+}
+
+void PDBCache::store(const PDBCacheKey &key, const PatternDatabase &pdb) const {
+    const PackedDistances &distances = pdb.get_distances();
+    FileHeader header;
+    header.magic = FILE_MAGIC;
+    header.key_hash = key.hash;
+    header.key_size = key.words.size();
+    header.num_entries = distances.size();
+    header.bits_per_entry = distances.get_bits_per_entry();
+
+    string path = get_path(key);
+    ostringstream temporary_path;
+    temporary_path << path << ".tmp." << utils::get_process_id() << "."
+                   << num_temporary_files++;
+    bool success;
+    {
+        ofstream file(temporary_path.str(), ios::binary);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(key.words.data()),
+                   key.words.size() * sizeof(uint64_t));
+        file.write(reinterpret_cast<const char *>(distances.get_words()),
+                   distances.get_num_words() * sizeof(uint64_t));
+        file.close();
+        success = static_cast<bool>(file);
+    }
+    if (success)
+        success = rename(temporary_path.str().c_str(), path.c_str()) == 0;
+    if (success) {
+        ++num_stores;
+    } else {
+        remove(temporary_path.str().c_str());
+        if (!reported_write_error.exchange(true)) {
+            cerr << "Warning: could not write PDB cache file " << path
+                 << endl;
+        }
+    }
+}
+
+void print_pdb_cache_statistics() {
+    if (num_hits + num_misses == 0)
+        return;
+    cout << "PDB cache hits: " << num_hits << endl;
+    cout << "PDB cache misses: " << num_misses << endl;
+    cout << "PDB cache stores: " << num_stores << endl;
+}
+}
@@ -0,0 +1,67 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "types.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TaskProxy;
+
+namespace pdbs {
+/*
+  On-disk cache of pattern databases, shared by planner runs.
+
+  Every PDB is stored in its own file "<hash>.pdb" in the cache
+  directory. The key of a PDB describes everything that its
+  construction depends on (see compute_pdb_cache_key), so different
+  tasks with the same projection onto a pattern share a file. The hash
+  of the key only selects the file name. Each file also stores the
+  full key, and a file whose key differs from the requested one is
+  treated like a missing file.
+
+  Files are written under a temporary name and then renamed. Concurrent
+  planner runs therefore never see partially written files. Files are
+  memory-mapped when loaded, so the distances are only read from disk
+  when the search accesses them, and processes using the same PDB
+  share its pages.
+
+  The cache never deletes files. Invalid or truncated files are
+  ignored and rebuilt.
+*/
+struct PDBCacheKey {
+    std::vector<std::uint64_t> words;
+    std::uint64_t hash;
+};
+
+class PDBCache {
+    std::string directory;
+
+    std::string get_path(const PDBCacheKey &key) const;
+public:
+    explicit PDBCache(const std::string &directory);
+
+    // Return nullptr if there is no valid file for key.
+    std::shared_ptr<PatternDatabase> load(
+        const TaskProxy &task_proxy, const Pattern &pattern,
+        const PDBCacheKey &key) const;
+    void store(const PDBCacheKey &key, const PatternDatabase &pdb) const;
+};
+
+/*
+  The key consists of the domain sizes of the pattern variables, the
+  goals on them and the costs, preconditions and effects of all
+  operators affecting them, projected to the pattern. operator_costs
+  may be empty to use the costs of the task.
+*/
+extern PDBCacheKey compute_pdb_cache_key(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const std::vector<int> &operator_costs);
+
+// Print hits, misses and stores of all PDB caches used so far, if any.
+extern void print_pdb_cache_statistics();
+}
+
+#endif
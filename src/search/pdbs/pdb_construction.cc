@@ -0,0 +1,78 @@
+#include "pdb_construction.h"
+
+#include "pattern_database.h"
+#include "pdb_cache.h"
+
+#include "../option_parser.h"
+#include "../task_proxy.h"
+
+#include "../utils/countdown_timer.h"
+#include "../utils/parallel.h"
+
+#include <cassert>
+#include <memory>
+
+using namespace std;
+
+namespace pdbs {
+PDBConstructionSettings::PDBConstructionSettings()
+    : num_threads(1) {
+}
+
+PDBCollection build_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    const PDBConstructionSettings &settings,
+    const vector<vector<int>> &operator_costs,
+    const utils::CountdownTimer *timer) {
+    assert(operator_costs.empty() || operator_costs.size() == patterns.size());
+    int num_patterns = patterns.size();
+    PDBCollection pdbs(num_patterns);
+    unique_ptr<PDBCache> cache;
+    if (!settings.cache_directory.empty())
+        cache.reset(new PDBCache(settings.cache_directory));
+    vector<PDBConstructionScratch> scratch(settings.num_threads);
+    const vector<int> default_costs;
+    utils::run_in_parallel(
+        num_patterns, settings.num_threads,
+        [&](int thread_id, int pattern_id) {
+            const Pattern &pattern = patterns[pattern_id];
+            const vector<int> &costs = operator_costs.empty() ?
+                default_costs : operator_costs[pattern_id];
+            PDBCacheKey key;
+            if (cache) {
+                key = compute_pdb_cache_key(task_proxy, pattern, costs);
+                pdbs[pattern_id] = cache->load(task_proxy, pattern, key);
+                if (pdbs[pattern_id])
+                    return;
+            }
+            pdbs[pattern_id] = make_shared<PatternDatabase>(
+                task_proxy, pattern, false, costs, &scratch[thread_id]);
+            if (cache)
+                cache->store(key, *pdbs[pattern_id]);
+        },
+        [timer]() {
+            return timer && timer->is_expired();
+        });
+    return pdbs;
+}
+
+void add_pdb_construction_options_to_parser(options::OptionParser &parser) {
+    utils::add_num_threads_option(parser);
+    parser.add_option<string>(
+        "pdb_cache",
+        "directory for caching pattern databases on disk. PDBs found in "
+        "the directory are loaded instead of built, and new PDBs are "
+        "written to it. The directory must exist. Several planner runs "
+        "can share one directory.",
+        options::OptionParser::NONE);
+}
+
+PDBConstructionSettings get_pdb_construction_settings_from_options(
+    const options::Options &opts) {
+    PDBConstructionSettings settings;
+    settings.num_threads = utils::parse_num_threads_from_options(opts);
+    settings.cache_directory = opts.get<string>("pdb_cache", "");
+    return settings;
+}
+}
@@ -0,0 +1,63 @@
+#ifndef PDBS_PDB_CONSTRUCTION_H
+#define PDBS_PDB_CONSTRUCTION_H
+
+#include "types.h"
+
+#include <string>
+#include <vector>
+
+class TaskProxy;
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace pdbs {
+/*
+  Settings for building pattern databases. They influence how long
+  construction takes, but not the resulting PDBs.
+*/
+struct PDBConstructionSettings {
+    int num_threads;
+    // Directory of the on-disk PDB cache (see pdb_cache.h), or empty.
+    std::string cache_directory;
+
+    PDBConstructionSettings();
+};
+
+/*
+  Build the pattern databases for the given patterns using up to
+  settings.num_threads threads. Each thread reuses its own construction
+  scratch memory. The i-th PDB in the result always belongs to the i-th
+  pattern, independently of the number of threads. PDBs found in the
+  cache are loaded instead of built, and newly built PDBs are added to
+  it.
+
+  operator_costs is either empty, in which case the operator costs of
+  the task are used, or holds one cost vector for each pattern.
+
+  If timer is given and expires, no further PDBs are started and the
+  entries of the PDBs that have not been built are null.
+*/
+extern PDBCollection build_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &patterns,
+    const PDBConstructionSettings &settings,
+    const std::vector<std::vector<int>> &operator_costs =
+        std::vector<std::vector<int>>(),
+    const utils::CountdownTimer *timer = nullptr);
+
+// Add num_threads and pdb_cache options to parser.
+extern void add_pdb_construction_options_to_parser(
+    options::OptionParser &parser);
+
+extern PDBConstructionSettings get_pdb_construction_settings_from_options(
+    const options::Options &opts);
+}
+
+#endif
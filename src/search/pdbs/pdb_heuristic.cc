@@ -1,24 +1,38 @@
 #include "pdb_heuristic.h"
 
 #include "pattern_generator.h"
+#include "pdb_cache.h"
+#include "pdb_construction.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 #include "../task_proxy.h"
 
+#include "../utils/timer.h"
+
+#include <iostream>
 #include <limits>
 #include <memory>
 
 using namespace std;
 
 namespace pdbs {
-PatternDatabase get_pdb_from_options(const shared_ptr<AbstractTask> &task,
-                                     const Options &opts) {
+shared_ptr<PatternDatabase> get_pdb_from_options(
+    const shared_ptr<AbstractTask> &task, const Options &opts) {
     shared_ptr<PatternGenerator> pattern_generator =
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     Pattern pattern = pattern_generator->generate(task);
     TaskProxy task_proxy(*task);
-    return PatternDatabase(task_proxy, pattern, true);
+    utils::Timer timer;
+    shared_ptr<PatternDatabase> pdb = build_pdbs(
+        task_proxy, {pattern},
+        get_pdb_construction_settings_from_options(opts)).front();
+    cout << "PDB construction time: " << timer << endl;
+    const PackedDistances &distances = pdb->get_distances();
+    cout << "PDB distances: " << distances.get_bits_per_entry()
+         << " bits per entry, " << distances.get_memory_usage()
+         << " bytes" << endl;
+    return pdb;
 }
 
 PDBHeuristic::PDBHeuristic(const Options &opts)
@@ -32,12 +46,16 @@ int PDBHeuristic::compute_heuristic(const GlobalState &global_state) {
 }
 
 int PDBHeuristic::compute_heuristic(const State &state) const {
-    int h = pdb.get_value(state);
+    int h = pdb->get_value(state);
     if (h == numeric_limits<int>::max())
         return DEAD_END;
     return h;
 }
 
+void PDBHeuristic::print_statistics() const {
+    print_pdb_cache_statistics();
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis("Pattern database heuristic", "TODO");
     parser.document_language_support("action costs", "supported");
@@ -52,6 +70,7 @@ static Heuristic *_parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    add_pdb_construction_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
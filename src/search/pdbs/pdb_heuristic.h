@@ -5,6 +5,8 @@
 
 #include "../heuristic.h"
 
+#include <memory>
+
 class GlobalState;
 class State;
 
@@ -15,7 +17,7 @@ class Options;
 namespace pdbs {
 // Implements a heuristic for a single PDB.
 class PDBHeuristic : public Heuristic {
-    PatternDatabase pdb;
+    std::shared_ptr<PatternDatabase> pdb;
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
     /* TODO: we want to get rid of compute_heuristic(const GlobalState &state)
@@ -35,6 +37,8 @@ public:
     */
     PDBHeuristic(const options::Options &opts);
     virtual ~PDBHeuristic() override = default;
+
+    virtual void print_statistics() const override;
 };
 }
 
@@ -15,29 +15,35 @@ using namespace std;
 
 namespace pdbs {
 ZeroOnePDBs::ZeroOnePDBs(
-    const TaskProxy &task_proxy, const PatternCollection &patterns) {
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    const PDBConstructionSettings &settings) {
+    /*
+      Whether an operator is relevant for a PDB only depends on the
+      pattern, so we can compute the cost partitioning before building
+      the PDBs and then build them independently of each other.
+    */
+    vector<vector<int>> operator_costs;
+    operator_costs.reserve(patterns.size());
     vector<int> remaining_operator_costs;
     OperatorsProxy operators = task_proxy.get_operators();
     remaining_operator_costs.reserve(operators.size());
     for (OperatorProxy op : operators)
         remaining_operator_costs.push_back(op.get_cost());
 
-    pattern_databases.reserve(patterns.size());
     for (const Pattern &pattern : patterns) {
-        shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
-            task_proxy, pattern, false, remaining_operator_costs);
+        operator_costs.push_back(remaining_operator_costs);
 
         /* Set cost of relevant operators to 0 for further iterations
            (action cost partitioning). */
         for (OperatorProxy op : operators) {
-            if (pdb->is_operator_relevant(op))
+            if (is_operator_relevant(pattern, op))
                 remaining_operator_costs[op.get_id()] = 0;
         }
-
-        pattern_databases.push_back(pdb);
     }
-}
 
+    pattern_databases = build_pdbs(
+        task_proxy, patterns, settings, operator_costs);
+}
 
 int ZeroOnePDBs::get_value(const State &state) const {
     /*
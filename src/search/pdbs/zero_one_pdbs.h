@@ -1,6 +1,7 @@
 #ifndef PDBS_ZERO_ONE_PDBS_H
 #define PDBS_ZERO_ONE_PDBS_H
 
+#include "pdb_construction.h"
 #include "types.h"
 
 class State;
@@ -10,7 +11,9 @@ namespace pdbs {
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
 public:
-    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
+    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns,
+                const PDBConstructionSettings &settings =
+                    PDBConstructionSettings());
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
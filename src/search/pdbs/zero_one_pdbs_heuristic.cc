@@ -1,6 +1,8 @@
 #include "zero_one_pdbs_heuristic.h"
 
 #include "pattern_generator.h"
+#include "pdb_cache.h"
+#include "pdb_construction.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
@@ -17,7 +19,9 @@ ZeroOnePDBs get_zero_one_pdbs_from_options(
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    return ZeroOnePDBs(
+        task_proxy, *patterns,
+        get_pdb_construction_settings_from_options(opts));
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
@@ -38,6 +42,10 @@ int ZeroOnePDBsHeuristic::compute_heuristic(const State &state) const {
     return h;
 }
 
+void ZeroOnePDBsHeuristic::print_statistics() const {
+    print_pdb_cache_statistics();
+}
+
 static Heuristic *_parse(OptionParser &parser) {
     parser.document_synopsis(
         "Zero-One PDB",
@@ -62,6 +70,7 @@ static Heuristic *_parse(OptionParser &parser) {
         "patterns",
         "pattern generation method",
         "systematic(1)");
+    add_pdb_construction_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
@@ -20,6 +20,8 @@ protected:
 public:
     ZeroOnePDBsHeuristic(const options::Options &opts);
     virtual ~ZeroOnePDBsHeuristic() = default;
+
+    virtual void print_statistics() const override;
 };
 }
 
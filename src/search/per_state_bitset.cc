@@ -0,0 +1,84 @@
+#include "per_state_bitset.h"
+
+#include <algorithm>
+
+using namespace std;
+
+void BitsetView::reset() {
+    fill(blocks, blocks + get_num_blocks(), Block(0));
+}
+
+int BitsetView::count() const {
+    int result = 0;
+    int num_blocks = get_num_blocks();
+    for (int i = 0; i < num_blocks; ++i) {
+        for (Block block = blocks[i]; block; block &= block - 1)
+            ++result;
+    }
+    return result;
+}
+
+void BitsetView::assign(const BitsetView &other) {
+    assert(num_bits == other.num_bits);
+    copy(other.blocks, other.blocks + get_num_blocks(), blocks);
+}
+
+
+PerStateBitset::PerStateBitset(int num_bits, bool default_value)
+    : num_bits(num_bits),
+      num_blocks(max(BitsetView::compute_num_blocks(num_bits), 1)),
+      default_blocks(num_blocks, 0),
+      cached_registry(nullptr),
+      cached_entries(nullptr) {
+    if (default_value) {
+        // Keep the unused bits of the last block cleared.
+        BitsetView view(default_blocks.data(), num_bits);
+        for (int pos = 0; pos < num_bits; ++pos)
+            view.set(pos);
+    }
+}
+
+PerStateBitset::~PerStateBitset() {
+    for (auto &entry : entries_by_registry) {
+        entry.first->unsubscribe(this);
+        delete entry.second;
+    }
+}
+
+PerStateBitset::BlockVector *PerStateBitset::get_entries(
+    const StateRegistry *registry) {
+    if (cached_registry != registry) {
+        cached_registry = registry;
+        auto it = entries_by_registry.find(registry);
+        if (it == entries_by_registry.end()) {
+            cached_entries = new BlockVector(num_blocks);
+            entries_by_registry[registry] = cached_entries;
+            registry->subscribe(this);
+        } else {
+            cached_entries = it->second;
+        }
+    }
+    assert(cached_entries == entries_by_registry[registry]);
+    return cached_entries;
+}
+
+BitsetView PerStateBitset::operator[](const GlobalState &state) {
+    const StateRegistry *registry = &state.get_registry();
+    BlockVector *entries = get_entries(registry);
+    int state_id = state.get_id().value;
+    assert(utils::in_bounds(state_id, *registry));
+    size_t virtual_size = registry->size();
+    if (entries->size() < virtual_size) {
+        entries->resize(virtual_size, default_blocks.data());
+    }
+    return BitsetView((*entries)[state_id], num_bits);
+}
+
+void PerStateBitset::remove_state_registry(StateRegistry *registry) {
+    delete entries_by_registry[registry];
+    entries_by_registry.erase(registry);
+    if (registry == cached_registry) {
+        cached_registry = nullptr;
+        cached_entries = nullptr;
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef PER_STATE_BITSET_H
+#define PER_STATE_BITSET_H
+
+#include "per_state_information.h"
+
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+/*
+  BitsetView gives access to a fixed-size bitset stored elsewhere. It is
+  a cheap handle that does not own its data, so it must not outlive the
+  storage it refers to.
+*/
+class BitsetView {
+public:
+    using Block = unsigned int;
+    static const int bits_per_block = std::numeric_limits<Block>::digits;
+
+private:
+    Block *blocks;
+    int num_bits;
+
+public:
+    BitsetView(Block *blocks, int num_bits)
+        : blocks(blocks),
+          num_bits(num_bits) {
+    }
+
+    static int compute_num_blocks(int num_bits) {
+        return (num_bits + bits_per_block - 1) / bits_per_block;
+    }
+
+    static Block bit_mask(int pos) {
+        return Block(1) << (pos % bits_per_block);
+    }
+
+    int size() const {
+        return num_bits;
+    }
+
+    int get_num_blocks() const {
+        return compute_num_blocks(num_bits);
+    }
+
+    Block *get_blocks() {
+        return blocks;
+    }
+
+    const Block *get_blocks() const {
+        return blocks;
+    }
+
+    void set(int pos) {
+        assert(pos >= 0 && pos < num_bits);
+        blocks[pos / bits_per_block] |= bit_mask(pos);
+    }
+
+    void reset(int pos) {
+        assert(pos >= 0 && pos < num_bits);
+        blocks[pos / bits_per_block] &= ~bit_mask(pos);
+    }
+
+    void reset();
+
+    bool test(int pos) const {
+        assert(pos >= 0 && pos < num_bits);
+        return (blocks[pos / bits_per_block] & bit_mask(pos)) != 0;
+    }
+
+    int count() const;
+
+    // Copy the bits of a bitset of the same size.
+    void assign(const BitsetView &other);
+};
+
+
+/*
+  PerStateBitset associates a bitset of fixed size with every state,
+  like PerStateInformation<std::vector<bool>>, but without allocating
+  memory for each state. The bitsets of all states of a registry are
+  packed into one SegmentedArrayVector, so each state only needs
+  ceil(num_bits / 32) words. Bitsets of states without entries are
+  initialized with all bits set to default_value.
+*/
+class PerStateBitset : public PerStateInformationBase {
+    using Block = BitsetView::Block;
+    using BlockVector = SegmentedArrayVector<Block>;
+
+    const int num_bits;
+    const int num_blocks;
+    std::vector<Block> default_blocks;
+    std::unordered_map<const StateRegistry *, BlockVector *> entries_by_registry;
+
+    const StateRegistry *cached_registry;
+    BlockVector *cached_entries;
+
+    BlockVector *get_entries(const StateRegistry *registry);
+
+    virtual void remove_state_registry(StateRegistry *registry) override;
+
+    // No implementation to forbid copies and assignment
+    PerStateBitset(const PerStateBitset &);
+    PerStateBitset &operator=(const PerStateBitset &);
+public:
+    PerStateBitset(int num_bits, bool default_value);
+    virtual ~PerStateBitset() override;
+
+    BitsetView operator[](const GlobalState &state);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "preferred_operator_cache.h"
+
+#include "global_state.h"
+
+#include <cassert>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+PreferredOperatorCache::PreferredOperatorCache(int capacity)
+    : capacity(capacity),
+      next_ticket(0),
+      ticket_by_state(NO_TICKET),
+      num_hits(0),
+      num_misses(0) {
+    assert(capacity > 0);
+}
+
+void PreferredOperatorCache::store(
+    const GlobalState &state,
+    const vector<const GlobalOperator *> &preferred_operators) {
+    int ticket = next_ticket;
+    int slot_id = ticket % capacity;
+    if (slot_id == static_cast<int>(slots.size()))
+        slots.emplace_back();
+    Slot &slot = slots[slot_id];
+    slot.ticket = ticket;
+    slot.preferred_operators = preferred_operators;
+    ticket_by_state[state] = ticket;
+    if (next_ticket == numeric_limits<int>::max())
+        next_ticket = 0;
+    else
+        ++next_ticket;
+}
+
+bool PreferredOperatorCache::extract(
+    const GlobalState &state,
+    vector<const GlobalOperator *> &preferred_operators) {
+    int &ticket = ticket_by_state[state];
+    if (ticket == NO_TICKET) {
+        ++num_misses;
+        return false;
+    }
+    Slot &slot = slots[ticket % capacity];
+    bool slot_was_reused = (slot.ticket != ticket);
+    ticket = NO_TICKET;
+    if (slot_was_reused) {
+        ++num_misses;
+        return false;
+    }
+    ++num_hits;
+    preferred_operators.swap(slot.preferred_operators);
+    slot.preferred_operators.clear();
+    slot.ticket = NO_TICKET;
+    return true;
+}
+
+void PreferredOperatorCache::print_statistics() const {
+    cout << "Preferred operator cache hits: " << num_hits << endl;
+    cout << "Preferred operator cache misses: " << num_misses << endl;
+}
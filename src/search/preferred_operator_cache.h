@@ -0,0 +1,62 @@
+#ifndef PREFERRED_OPERATOR_CACHE_H
+#define PREFERRED_OPERATOR_CACHE_H
+
+#include "per_state_information.h"
+
+#include <vector>
+
+class GlobalOperator;
+class GlobalState;
+
+/*
+  Store the preferred operators that a heuristic computed for recently
+  evaluated states, so that eager search engines can retrieve them
+  when they expand a state instead of evaluating it a second time.
+
+  The cache has a fixed number of slots that are reused in round-robin
+  order, i.e., it only remembers the preferred operators of the last
+  "capacity" states that were stored. Every store operation gets a new
+  ticket number, which determines the slot and is remembered both by
+  the slot and by the state. A lookup fails if the slot has been reused
+  since, i.e., if the tickets differ. Since each state is usually
+  expanded at most once, a successful lookup frees the slot again.
+*/
+class PreferredOperatorCache {
+    static const int NO_TICKET = -1;
+
+    struct Slot {
+        int ticket;
+        std::vector<const GlobalOperator *> preferred_operators;
+
+        Slot()
+            : ticket(NO_TICKET) {
+        }
+    };
+
+    // Grows on demand until it reaches the capacity.
+    std::vector<Slot> slots;
+    int capacity;
+    int next_ticket;
+    PerStateInformation<int> ticket_by_state;
+
+    int num_hits;
+    int num_misses;
+
+public:
+    explicit PreferredOperatorCache(int capacity);
+
+    void store(const GlobalState &state,
+               const std::vector<const GlobalOperator *> &preferred_operators);
+
+    /*
+      If the cache contains the preferred operators of the given state,
+      move them into "preferred_operators", remove them from the cache
+      and return true. Otherwise, return false.
+    */
+    bool extract(const GlobalState &state,
+                 std::vector<const GlobalOperator *> &preferred_operators);
+
+    void print_statistics() const;
+};
+
+#endif
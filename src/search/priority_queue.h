@@ -3,6 +3,7 @@
 
 #include "utils/collections.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <queue>
@@ -14,6 +15,15 @@
   BucketQueue (bucket-based), and AdaptiveQueue (starts out bucket-based,
   transforms into heap-based if that seems to make sense).
 
+  In addition, we define two monotone priority queues, DialQueue and
+  RadixQueue, for Dijkstra-style explorations where no key smaller
+  than the most recently popped one is ever pushed. DialQueue
+  additionally requires that all keys in the queue lie within a fixed
+  window above the most recently popped key (e.g., h^max with a small
+  maximal operator cost). RadixQueue has no such restriction (e.g.,
+  h^add). Both have the same interface as AdaptiveQueue, so they can be
+  used as template arguments in place of it.
+
   More precisely, an AdaptiveQueue is converted from a BucketQueue to
   a HeapQueue when the number of required buckets exceeds both
   BucketQueue::MIN_BUCKETS_BEFORE_SWITCH and the total number of
@@ -266,4 +276,165 @@ public:
     }
 };
 
+
+
+template<typename Value>
+class DialQueue {
+    /*
+      Circular bucket queue (Dial's algorithm). All keys in the queue
+      must lie in the interval [k, k + max_key_increase], where k is
+      the key that was popped last (or 0 after construction or
+      clear()). The number of buckets is rounded up to a power of two,
+      so the bucket of a key can be found with a bit mask. Within a
+      bucket, elements are popped in LIFO order like in BucketQueue.
+    */
+    typedef std::vector<Value> Bucket;
+    std::vector<Bucket> buckets;
+    int mask;
+    int current_key;
+    int num_entries;
+
+    // Forbid assigning or copying -- would need to implement them properly.
+    DialQueue &operator=(const DialQueue<Value> &);
+    DialQueue(const DialQueue<Value> &);
+public:
+    typedef std::pair<int, Value> Entry;
+
+    explicit DialQueue(int max_key_increase)
+        : current_key(0), num_entries(0) {
+        assert(max_key_increase >= 0);
+        int num_buckets = 1;
+        while (num_buckets <= max_key_increase)
+            num_buckets *= 2;
+        buckets.resize(num_buckets);
+        mask = num_buckets - 1;
+    }
+
+    void push(int key, const Value &value) {
+        assert(key >= current_key && key - current_key <= mask);
+        ++num_entries;
+        buckets[key & mask].push_back(value);
+    }
+
+    Entry pop() {
+        assert(num_entries > 0);
+        --num_entries;
+        while (buckets[current_key & mask].empty())
+            ++current_key;
+        Bucket &current_bucket = buckets[current_key & mask];
+        Value top_element = current_bucket.back();
+        current_bucket.pop_back();
+        return std::make_pair(current_key, top_element);
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    void clear() {
+        if (num_entries != 0) {
+            for (Bucket &bucket : buckets)
+                bucket.clear();
+            num_entries = 0;
+        }
+        current_key = 0;
+    }
+
+    void add_virtual_pushes(int /*num_extra_pushes*/) {
+    }
+};
+
+
+template<typename Value>
+class RadixQueue {
+    /*
+      Radix heap for non-negative int keys. Pushed keys must not be
+      smaller than the key that was popped last (or 0 after
+      construction or clear()). Bucket 0 holds the entries whose key
+      equals the last popped key, bucket i > 0 those whose key first
+      differs from it in bit i - 1 (counting from the least significant
+      bit). Every entry moves to a lower bucket at most 32 times.
+    */
+public:
+    typedef std::pair<int, Value> Entry;
+private:
+    typedef std::vector<Entry> Bucket;
+    static const int NUM_BUCKETS = 33;
+
+    Bucket buckets[NUM_BUCKETS];
+    int last_key;
+    int num_entries;
+
+    static int get_bucket_id(int key, int last) {
+        unsigned int diff = static_cast<unsigned int>(key ^ last);
+#if defined(__GNUC__)
+        return diff ? 32 - __builtin_clz(diff) : 0;
+#else
+        int bucket_id = 0;
+        while (diff) {
+            diff >>= 1;
+            ++bucket_id;
+        }
+        return bucket_id;
+#endif
+    }
+
+    void refill_first_bucket() {
+        int bucket_id = 1;
+        while (buckets[bucket_id].empty())
+            ++bucket_id;
+        Bucket &bucket = buckets[bucket_id];
+        int min_key = bucket[0].first;
+        for (size_t i = 1; i < bucket.size(); ++i)
+            min_key = std::min(min_key, bucket[i].first);
+        last_key = min_key;
+        for (const Entry &entry : bucket) {
+            int new_bucket_id = get_bucket_id(entry.first, last_key);
+            assert(new_bucket_id < bucket_id);
+            buckets[new_bucket_id].push_back(entry);
+        }
+        bucket.clear();
+    }
+
+    // Forbid assigning or copying -- would need to implement them properly.
+    RadixQueue &operator=(const RadixQueue<Value> &);
+    RadixQueue(const RadixQueue<Value> &);
+public:
+    RadixQueue() : last_key(0), num_entries(0) {
+    }
+
+    void push(int key, const Value &value) {
+        assert(key >= last_key);
+        ++num_entries;
+        buckets[get_bucket_id(key, last_key)].push_back(
+            std::make_pair(key, value));
+    }
+
+    Entry pop() {
+        assert(num_entries > 0);
+        --num_entries;
+        if (buckets[0].empty())
+            refill_first_bucket();
+        Entry result = buckets[0].back();
+        buckets[0].pop_back();
+        return result;
+    }
+
+    bool empty() const {
+        return num_entries == 0;
+    }
+
+    void clear() {
+        if (num_entries != 0) {
+            for (Bucket &bucket : buckets)
+                bucket.clear();
+            num_entries = 0;
+        }
+        last_key = 0;
+    }
+
+    void add_virtual_pushes(int /*num_extra_pushes*/) {
+    }
+};
+
 #endif
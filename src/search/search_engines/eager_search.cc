@@ -50,6 +50,11 @@ void EagerSearch::initialize() {
     hset.insert(preferred_operator_heuristics.begin(),
                 preferred_operator_heuristics.end());
 
+    // Expanded states look up the preferred operators computed when
+    // they were generated instead of being evaluated again.
+    for (Heuristic *heuristic : preferred_operator_heuristics)
+        heuristic->enable_preferred_operator_cache();
+
     // add heuristics that are used in the f_evaluator. They are usually also
     // used in the open list and hence already be included, but we want to be
     // sure.
@@ -95,6 +100,8 @@ void EagerSearch::print_checkpoint_line(int g) const {
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    for (Heuristic *heuristic : heuristics)
+        heuristic->print_statistics();
     pruning_method->print_statistics();
 }
 
@@ -118,7 +125,11 @@ SearchStatus EagerSearch::step() {
     */
     pruning_method->prune_operators(s, applicable_ops);
 
-    // This evaluates the expanded state (again) to get preferred ops
+    /*
+      Get the preferred operators of the expanded state. Heuristics
+      usually return the ones they computed when the state was
+      evaluated (see Heuristic::enable_preferred_operator_cache).
+    */
     EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
     algorithms::OrderedSet<const GlobalOperator *> preferred_operators =
         collect_preferred_operators(eval_context, preferred_operator_heuristics);
@@ -219,6 +219,8 @@ void LazySearch::print_checkpoint_line(int g) const {
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    for (Heuristic *heuristic : heuristics)
+        heuristic->print_statistics();
 }
 
 
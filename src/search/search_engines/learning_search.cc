@@ -62,6 +62,11 @@ void LearningSearch::initialize() {
     hset.insert(preferred_operator_heuristics.begin(),
         preferred_operator_heuristics.end());
 
+    // Expanded states look up the preferred operators computed when
+    // they were generated instead of being evaluated again.
+    for (Heuristic *heuristic : preferred_operator_heuristics)
+        heuristic->enable_preferred_operator_cache();
+
     heuristics.assign(hset.begin(), hset.end());
     assert(!heuristics.empty());
 
@@ -105,6 +110,8 @@ void LearningSearch::initialize() {
 void LearningSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+    for (Heuristic *heuristic : heuristics)
+        heuristic->print_statistics();
 }
 
 SearchStatus LearningSearch::step() {
@@ -151,7 +158,7 @@ SearchStatus LearningSearch::expand(bool randomized, StateID &state_id, vector<c
     state_id = state.get_id();
     g_successor_generator->generate_applicable_ops(state, applicable_ops);
 
-    // Like in EagerSearch, this evaluates the expanded state (again) to get preferred ops.
+    // Like in EagerSearch, this looks up the preferred ops of the expanded state.
     EvaluationContext eval_context(state, node.get_g(), false, &statistics, true);
     preferred_ops = collect_preferred_operators(eval_context, preferred_operator_heuristics);
 
@@ -311,7 +318,7 @@ SearchStatus LearningSearch::depth_first_step() {
     vector<const GlobalOperator*> applicable_ops;
     g_successor_generator->generate_applicable_ops(state, applicable_ops);
 
-    // Like in EagerSearch, this evaluates the expanded state (again) to get preferred ops.
+    // Like in EagerSearch, this looks up the preferred ops of the expanded state.
     EvaluationContext eval_context(state, node.get_g(), false, &statistics, true);
     algorithms::OrderedSet<const GlobalOperator *> preferred_ops =
         collect_preferred_operators(eval_context, preferred_operator_heuristics);
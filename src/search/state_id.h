@@ -11,6 +11,7 @@ class StateID {
     friend std::ostream &operator<<(std::ostream &os, StateID id);
     template<typename>
     friend class PerStateInformation;
+    friend class PerStateBitset;
 
     int value;
     explicit StateID(int value_)
@@ -5,8 +5,9 @@
 using namespace std;
 
 namespace utils {
-CountdownTimer::CountdownTimer(double max_time)
-    : max_time(max_time) {
+CountdownTimer::CountdownTimer(double max_time, TimerType type)
+    : timer(type),
+      max_time(max_time) {
 }
 
 CountdownTimer::~CountdownTimer() {
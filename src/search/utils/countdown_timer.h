@@ -10,7 +10,8 @@ class CountdownTimer {
     Timer timer;
     double max_time;
 public:
-    explicit CountdownTimer(double max_time);
+    explicit CountdownTimer(
+        double max_time, TimerType type = TimerType::CPU_TIME);
     ~CountdownTimer();
     bool is_expired() const;
     double get_elapsed_time() const;
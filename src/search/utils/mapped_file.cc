@@ -0,0 +1,69 @@
+#include "mapped_file.h"
+
+#include "system.h"
+
+#include <fstream>
+#include <iterator>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+MappedFile::MappedFile()
+    : data(nullptr),
+      size(0) {
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+MappedFile::~MappedFile() {
+    if (data && buffer.empty())
+        munmap(const_cast<char *>(data), size);
+}
+
+unique_ptr<MappedFile> MappedFile::open(const string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+    struct stat file_status;
+    if (fstat(fd, &file_status) == -1 || file_status.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = file_status.st_size;
+    void *address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after closing the file descriptor.
+    close(fd);
+    if (address == MAP_FAILED)
+        return nullptr;
+    unique_ptr<MappedFile> file(new MappedFile());
+    file->data = static_cast<const char *>(address);
+    file->size = size;
+    return file;
+}
+#else
+MappedFile::~MappedFile() {
+}
+
+unique_ptr<MappedFile> MappedFile::open(const string &path) {
+    ifstream stream(path, ios::binary);
+    if (!stream)
+        return nullptr;
+    unique_ptr<MappedFile> file(new MappedFile());
+    file->buffer.assign(istreambuf_iterator<char>(stream),
+                        istreambuf_iterator<char>());
+    if (!stream.good() && !stream.eof())
+        return nullptr;
+    if (file->buffer.empty())
+        return nullptr;
+    file->data = file->buffer.data();
+    file->size = file->buffer.size();
+    return file;
+}
+#endif
+}
@@ -0,0 +1,41 @@
+#ifndef UTILS_MAPPED_FILE_H
+#define UTILS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace utils {
+/*
+  Read-only view of the contents of a file. On Unix systems, the file
+  is mapped into memory, so its pages are only read when they are
+  accessed and are shared between all processes mapping the same file.
+  On other systems, the file is read into memory.
+*/
+class MappedFile {
+    const char *data;
+    std::size_t size;
+    // Used if the file cannot be mapped.
+    std::vector<char> buffer;
+
+    MappedFile();
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    // Return nullptr if the file cannot be opened.
+    static std::unique_ptr<MappedFile> open(const std::string &path);
+
+    const char *get_data() const {
+        return data;
+    }
+
+    std::size_t get_size() const {
+        return size;
+    }
+};
+}
+
+#endif
@@ -1,19 +1,29 @@
 #include "memory.h"
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
+#include <mutex>
 
 using namespace std;
 
 namespace utils {
-static char *extra_memory_padding = nullptr;
+/*
+  Several threads may run out of memory at the same time, so the padding
+  is released under a lock and only by the first of them.
+*/
+static atomic<char *> extra_memory_padding(nullptr);
+static mutex extra_memory_padding_mutex;
 
 // Save standard out-of-memory handler.
 static void (*standard_out_of_memory_handler)() = nullptr;
 
 void continuing_out_of_memory_handler() {
-    release_extra_memory_padding();
-    cout << "Failed to allocate memory. Released extra memory padding." << endl;
+    lock_guard<mutex> lock(extra_memory_padding_mutex);
+    if (extra_memory_padding) {
+        release_extra_memory_padding();
+        cout << "Failed to allocate memory. Released extra memory padding." << endl;
+    }
 }
 
 void reserve_extra_memory_padding(int memory_in_mb) {
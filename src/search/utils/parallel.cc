@@ -0,0 +1,83 @@
+#include "parallel.h"
+
+#include "../options/option_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void run_in_parallel(
+    int num_jobs, int num_threads,
+    const function<void(int thread_id, int job_id)> &job,
+    const function<bool()> &should_stop) {
+    assert(num_threads >= 1);
+    num_threads = max(1, min(num_threads, num_jobs));
+
+    if (num_threads == 1) {
+        for (int job_id = 0; job_id < num_jobs; ++job_id) {
+            if (should_stop && should_stop())
+                break;
+            job(0, job_id);
+        }
+        return;
+    }
+
+    atomic<int> next_job(0);
+    atomic<bool> stopped(false);
+    mutex exception_mutex;
+    exception_ptr first_exception;
+
+    auto work = [&](int thread_id) {
+        while (!stopped) {
+            if (should_stop && should_stop()) {
+                stopped = true;
+                break;
+            }
+            int job_id = next_job++;
+            if (job_id >= num_jobs)
+                break;
+            try {
+                job(thread_id, job_id);
+            } catch (...) {
+                lock_guard<mutex> lock(exception_mutex);
+                if (!first_exception)
+                    first_exception = current_exception();
+                stopped = true;
+            }
+        }
+    };
+
+    vector<thread> threads;
+    threads.reserve(num_threads - 1);
+    for (int thread_id = 1; thread_id < num_threads; ++thread_id)
+        threads.emplace_back(work, thread_id);
+    work(0);
+    for (thread &thread : threads)
+        thread.join();
+
+    if (first_exception)
+        rethrow_exception(first_exception);
+}
+
+void add_num_threads_option(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads used for precomputations. Unless a time limit "
+        "is reached, the results do not depend on the number of threads. "
+        "Time limits of multi-threaded precomputations refer to wall-clock "
+        "time.",
+        "1",
+        options::Bounds("1", "infinity"));
+}
+
+int parse_num_threads_from_options(const options::Options &options) {
+    return options.get<int>("num_threads");
+}
+}
@@ -0,0 +1,38 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+/*
+  Call job(thread_id, job_id) for all job ids in [0, num_jobs) using at
+  most num_threads threads. Thread ids are in [0, num_threads), and no
+  two concurrent calls share a thread id, so callers can keep scratch
+  memory per thread id. Jobs are started in increasing order of their
+  ids.
+
+  If should_stop is given, it is queried before starting each job, and
+  once it returns true, no further jobs are started. Jobs that are
+  already running are completed.
+
+  With num_threads == 1, all jobs run in the calling thread. Exceptions
+  thrown by a job are passed on to the caller after all threads have
+  finished.
+*/
+extern void run_in_parallel(
+    int num_jobs, int num_threads,
+    const std::function<void(int thread_id, int job_id)> &job,
+    const std::function<bool()> &should_stop = nullptr);
+
+// Add num_threads option to parser.
+extern void add_num_threads_option(options::OptionParser &parser);
+
+extern int parse_num_threads_from_options(const options::Options &options);
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "timer.h"
 
+#include <chrono>
 #include <ctime>
 #include <ostream>
 
@@ -32,7 +33,8 @@ void mach_absolute_difference(uint64_t end, uint64_t start, struct timespec *tp)
 #endif
 
 
-Timer::Timer() {
+Timer::Timer(TimerType type)
+    : type(type) {
 #if OPERATING_SYSTEM == WINDOWS
     QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&start_ticks);
@@ -43,6 +45,10 @@ Timer::Timer() {
 }
 
 double Timer::current_clock() const {
+    if (type == TimerType::WALL_CLOCK_TIME) {
+        return chrono::duration<double>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+    }
 #if OPERATING_SYSTEM == WINDOWS
     LARGE_INTEGER now_ticks;
     QueryPerformanceCounter(&now_ticks);
@@ -6,7 +6,18 @@
 #include <ostream>
 
 namespace utils {
+enum class TimerType {
+    // Processor time of the process, summed over all of its threads.
+    CPU_TIME,
+    /*
+      Elapsed real time. Use this for time limits of code that runs
+      on several threads, since the CPU time grows faster there.
+    */
+    WALL_CLOCK_TIME
+};
+
 class Timer {
+    TimerType type;
     double last_start_clock;
     double collected_time;
     bool stopped;
@@ -18,7 +29,7 @@ class Timer {
     double current_clock() const;
 
 public:
-    Timer();
+    explicit Timer(TimerType type = TimerType::CPU_TIME);
     ~Timer() = default;
     double operator()() const;
     double stop();